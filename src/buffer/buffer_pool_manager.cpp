@@ -14,6 +14,7 @@
 
 #include <list>
 #include <unordered_map>
+#include <vector>
 
 namespace bustub {
 
@@ -42,39 +43,24 @@ Page *BufferPoolManager::FetchPageImpl(page_id_t page_id) {
   // 2.     If R is dirty, write it back to the disk.
   // 3.     Delete R from the page table and insert P.
   // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
-  frame_id_t frame_id;
-  std::unordered_map<page_id_t, frame_id_t>::iterator frame_iter;
-  if ((frame_iter = page_table_.find(page_id)) != page_table_.end()) {
-    std::lock_guard<std::mutex> lg(latch_);
+  std::lock_guard<std::mutex> lg(latch_);
+  auto frame_iter = page_table_.find(page_id);
+  if (frame_iter != page_table_.end()) {
     replacer_->Pin(frame_iter->second);
     pages_[frame_iter->second].pin_count_++;
+    SetRecLSN(&pages_[frame_iter->second]);
     return &pages_[frame_iter->second];
   }
 
-  {
-    std::lock_guard<std::mutex> lg(latch_);
-    if (!free_list_.empty()) {
-      frame_id = free_list_.back();
-      free_list_.pop_back();
-    } else {
-      if (!replacer_->Victim(&frame_id)) {
-        return nullptr;
-      }
-    }
-  }
-
-  if (pages_[frame_id].IsDirty()) {
-    FlushPage(pages_[frame_id].GetPageId());
-  }
-
-  {
-    std::lock_guard<std::mutex> lg(latch_);
-    page_table_.erase(pages_[frame_id].GetPageId());
-
-    pages_[frame_id].ResetMemory();
-    pages_[frame_id].page_id_ = page_id;
-    page_table_[page_id] = frame_id;
+  frame_id_t frame_id;
+  if (!FindVictimFrame(&frame_id)) {
+    return nullptr;
   }
+  page_table_[page_id] = frame_id;
+  pages_[frame_id].page_id_ = page_id;
+  pages_[frame_id].pin_count_ = 1;
+  replacer_->Pin(frame_id);
+  SetRecLSN(&pages_[frame_id]);
 
   disk_manager_->ReadPage(page_id, pages_[frame_id].GetData());
   return &pages_[frame_id];
@@ -82,40 +68,35 @@ Page *BufferPoolManager::FetchPageImpl(page_id_t page_id) {
 
 bool BufferPoolManager::UnpinPageImpl(page_id_t page_id, bool is_dirty) {
   std::lock_guard<std::mutex> lg(latch_);
-  for (size_t i = 0; i < pool_size_; ++i) {
-    if (pages_[i].GetPageId() == page_id) {
-      pages_[i].is_dirty_ = is_dirty;
-      pages_[i].pin_count_--;
-      if (pages_[i].GetPinCount() <= 0) {
-        replacer_->Unpin(i);
-      }
-      return true;
+  auto frame_iter = page_table_.find(page_id);
+  if (frame_iter == page_table_.end()) {
+    return false;
+  }
+  Page *page = &pages_[frame_iter->second];
+  if (page->GetPinCount() <= 0) {
+    return false;
+  }
+  // a clean unpin must not hide the changes made by another pin of the same page
+  page->is_dirty_ = page->is_dirty_ || is_dirty;
+  page->pin_count_--;
+  if (page->GetPinCount() == 0) {
+    replacer_->Unpin(frame_iter->second);
+    if (!page->is_dirty_) {
+      page->rec_lsn_ = INVALID_LSN;
     }
   }
-  return false;
+  return true;
 }
 
 bool BufferPoolManager::FlushPageImpl(page_id_t page_id) {
   // Make sure you call DiskManager::WritePage!
   std::lock_guard<std::mutex> lg(latch_);
-  frame_id_t frame_id;
-  std::unordered_map<page_id_t, frame_id_t>::iterator frame_iter;
-  if ((frame_iter = page_table_.find(page_id)) != page_table_.end()) {
-    frame_id = frame_iter->second;
-    std::future<void> future;
-    if (enable_logging) {
-      future = log_manager_->SyncFlush(false, &pages_[frame_id]);
-      disk_manager_->SetFlushLogFuture(&future);
-    }
-    disk_manager_->WritePage(page_id, pages_[frame_id].GetData());
-    if (disk_manager_->HasFlushLogFuture()) {
-      disk_manager_->SetFlushLogFuture(nullptr);
-    }
-    // page is not dirty yet
-    pages_[frame_id].is_dirty_ = false;
-    return true;
+  auto frame_iter = page_table_.find(page_id);
+  if (frame_iter == page_table_.end()) {
+    return false;
   }
-  return false;
+  FlushFrame(frame_iter->second);
+  return true;
 }
 
 Page *BufferPoolManager::NewPageImpl(page_id_t *page_id) {
@@ -124,44 +105,17 @@ Page *BufferPoolManager::NewPageImpl(page_id_t *page_id) {
   // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
   // 3.   Update P's metadata, zero out memory and add P to the page table.
   // 4.   Set the page ID output parameter. Return a pointer to P.
-  bool all_pined = true;
-  for (size_t i = 0; i < pool_size_; ++i) {
-    if (pages_[i].GetPinCount() == 0) {
-      all_pined = false;
-      break;
-    }
-  }
-  if (all_pined) {
-    return nullptr;
-  }
-
+  std::lock_guard<std::mutex> lg(latch_);
   frame_id_t frame_id;
-  {
-    std::lock_guard<std::mutex> lg(latch_);
-    if (!free_list_.empty()) {
-      frame_id = free_list_.back();
-      free_list_.pop_back();
-    } else {
-      if (!replacer_->Victim(&frame_id)) {
-        return nullptr;
-      }
-    }
-  }
-
-  if (pages_[frame_id].IsDirty()) {
-    FlushPage(pages_[frame_id].GetPageId());
-  }
-
-  {
-    std::lock_guard<std::mutex> lg(latch_);
-    *page_id = disk_manager_->AllocatePage();
-
-    page_table_.erase(pages_[frame_id].GetPageId());
-    page_table_[*page_id] = frame_id;
-    pages_[frame_id].ResetMemory();
-    pages_[frame_id].page_id_ = *page_id;
+  if (!FindVictimFrame(&frame_id)) {
+    return nullptr;
   }
-
+  *page_id = disk_manager_->AllocatePage();
+  page_table_[*page_id] = frame_id;
+  pages_[frame_id].page_id_ = *page_id;
+  pages_[frame_id].pin_count_ = 1;
+  replacer_->Pin(frame_id);
+  SetRecLSN(&pages_[frame_id]);
   return &pages_[frame_id];
 }
 
@@ -171,27 +125,99 @@ bool BufferPoolManager::DeletePageImpl(page_id_t page_id) {
   // 1.   If P does not exist, return true.
   // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
   // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
-  std::unordered_map<page_id_t, frame_id_t>::iterator frame_iter;
-  if ((frame_iter = page_table_.find(page_id)) == page_table_.end()) {
+  std::lock_guard<std::mutex> lg(latch_);
+  auto frame_iter = page_table_.find(page_id);
+  if (frame_iter == page_table_.end()) {
     return true;
   }
-
-  std::lock_guard<std::mutex> lg(latch_);
-  if (pages_[frame_iter->first].GetPinCount() > 0) {
+  frame_id_t frame_id = frame_iter->second;
+  if (pages_[frame_id].GetPinCount() > 0) {
     return false;
   }
 
   disk_manager_->DeallocatePage(page_id);
-  free_list_.push_back(frame_iter->second);
-  page_table_.erase(page_id);
+  // the frame is free now, it must not be handed out by the replacer as well
+  replacer_->Pin(frame_id);
+  page_table_.erase(frame_iter);
+  pages_[frame_id].ResetMemory();
+  pages_[frame_id].page_id_ = INVALID_PAGE_ID;
+  pages_[frame_id].is_dirty_ = false;
+  pages_[frame_id].rec_lsn_ = INVALID_LSN;
+  free_list_.push_back(frame_id);
   return true;
 }
 
 void BufferPoolManager::FlushAllPagesImpl() {
-  // You can do it!
+  std::lock_guard<std::mutex> lg(latch_);
+  for (auto &item : page_table_) {
+    FlushFrame(item.second);
+  }
+}
+
+bool BufferPoolManager::FindVictimFrame(frame_id_t *frame_id) {
+  if (!free_list_.empty()) {
+    *frame_id = free_list_.back();
+    free_list_.pop_back();
+    return true;
+  }
+  if (!replacer_->Victim(frame_id)) {
+    return false;
+  }
+
+  // write back the victim page before its frame is reused
+  Page *victim = &pages_[*frame_id];
+  if (victim->IsDirty()) {
+    FlushFrame(*frame_id);
+  }
+  page_table_.erase(victim->GetPageId());
+  victim->ResetMemory();
+  victim->page_id_ = INVALID_PAGE_ID;
+  victim->rec_lsn_ = INVALID_LSN;
+  return true;
+}
+
+void BufferPoolManager::FlushFrame(frame_id_t frame_id) {
+  Page *page = &pages_[frame_id];
+  std::future<void> future;
+  if (log_manager_ != nullptr) {
+    // write ahead: the log records up to the page LSN must be on disk before the page is, this includes the
+    // compensation records recovery writes before logging is enabled
+    future = log_manager_->SyncFlush(false, page);
+    disk_manager_->SetFlushLogFuture(&future);
+  }
+  disk_manager_->WritePage(page->GetPageId(), page->GetData());
+  if (disk_manager_->HasFlushLogFuture()) {
+    disk_manager_->SetFlushLogFuture(nullptr);
+  }
+  // page is not dirty yet
+  page->is_dirty_ = false;
+  // a pinned page may be changed again by its current user
+  page->rec_lsn_ = INVALID_LSN;
+  if (page->GetPinCount() > 0) {
+    SetRecLSN(page);
+  }
+}
+
+void BufferPoolManager::SetRecLSN(Page *page) {
+  if (!enable_logging || page->rec_lsn_ != INVALID_LSN) {
+    return;
+  }
+  page->rec_lsn_ = log_manager_->GetNextLSNAndOffset(&page->rec_offset_);
+}
+
+std::vector<DirtyPageEntry> BufferPoolManager::GetDirtyPageTable() {
+  std::lock_guard<std::mutex> lg(latch_);
+  std::vector<DirtyPageEntry> dirty_pages;
   for (auto &item : page_table_) {
-    FlushPage(item.first);
+    Page *page = &pages_[item.second];
+    if (page->rec_lsn_ != INVALID_LSN) {
+      dirty_pages.push_back({item.first, page->rec_lsn_, page->rec_offset_});
+    } else if (page->is_dirty_) {
+      // changed while logging was off, nothing tells when, redo has to read the whole log for it
+      dirty_pages.push_back({item.first, 0, 0});
+    }
   }
+  return dirty_pages;
 }
 
 }  // namespace bustub
@@ -54,14 +54,12 @@ void ClockReplacer::Pin(frame_id_t frame_id) {
                            [=](const std::shared_ptr<Unit> &u) { return u->frame_id == frame_id; });
 
   if (item != units.cend()) {
-    if (current == item) {
-      current++;
-      if (current == units.cend()) {
-        current = units.begin();
-      }
+    // move the clock hand on if it points at the frame, the frame may be the only one left
+    bool at_hand = current == item;
+    auto next = units.erase(item);
+    if (at_hand) {
+      current = next == units.end() ? units.begin() : next;
     }
-
-    units.erase(item);
   }
 }
 
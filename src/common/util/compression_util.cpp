@@ -0,0 +1,167 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compression_util.cpp
+//
+// Identification: src/common/util/compression_util.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/util/compression_util.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace bustub {
+
+namespace {
+
+constexpr int HASH_BITS = 12;
+
+inline uint32_t Read32(const char *data) {
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+inline uint32_t Hash(uint32_t value) { return (value * 2654435761U) >> (32 - HASH_BITS); }
+
+/** Writes the continuation bytes of a length of 15 or more, returns false if dst is full. */
+inline bool WriteLength(int length, char *dst, int capacity, int *op) {
+  for (length -= 15; length >= 0; length -= 255) {
+    if (*op >= capacity) {
+      return false;
+    }
+    dst[(*op)++] = static_cast<char>(length >= 255 ? 255 : length);
+    if (length < 255) {
+      break;
+    }
+  }
+  return true;
+}
+
+/** Reads the continuation bytes of a length of 15, returns false if src ends first. */
+inline bool ReadLength(const char *src, int size, int *ip, int *length) {
+  uint8_t byte;
+  do {
+    if (*ip >= size) {
+      return false;
+    }
+    byte = static_cast<uint8_t>(src[(*ip)++]);
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+/** Appends a sequence of literals followed by a match, match_length 0 ends the block. */
+bool WriteSequence(const char *literals, int literal_length, int offset, int match_length, char *dst, int capacity,
+                   int *op) {
+  if (*op >= capacity) {
+    return false;
+  }
+  int token_op = (*op)++;
+  int literal_token = literal_length < 15 ? literal_length : 15;
+  int match_token = 0;
+  if (literal_length >= 15 && !WriteLength(literal_length, dst, capacity, op)) {
+    return false;
+  }
+  if (*op + literal_length > capacity) {
+    return false;
+  }
+  memcpy(dst + *op, literals, literal_length);
+  *op += literal_length;
+
+  if (match_length > 0) {
+    if (*op + 2 > capacity) {
+      return false;
+    }
+    dst[(*op)++] = static_cast<char>(offset & 0xff);
+    dst[(*op)++] = static_cast<char>(offset >> 8);
+    int length = match_length - CompressionUtil::MIN_MATCH;
+    match_token = length < 15 ? length : 15;
+    if (length >= 15 && !WriteLength(length, dst, capacity, op)) {
+      return false;
+    }
+  }
+  dst[token_op] = static_cast<char>((literal_token << 4) | match_token);
+  return true;
+}
+
+}  // namespace
+
+int CompressionUtil::Compress(const char *src, int size, char *dst, int capacity) {
+  std::vector<int> table(1 << HASH_BITS, -1);
+  int ip = 0;
+  int anchor = 0;
+  int op = 0;
+  while (ip + MIN_MATCH <= size) {
+    uint32_t value = Read32(src + ip);
+    uint32_t hash = Hash(value);
+    int candidate = table[hash];
+    table[hash] = ip;
+    if (candidate < 0 || ip - candidate > MAX_OFFSET || Read32(src + candidate) != value) {
+      // skip ahead faster the longer nothing matches, incompressible data is not worth the time
+      ip += 1 + ((ip - anchor) >> 6);
+      continue;
+    }
+    int match_length = MIN_MATCH;
+    while (ip + match_length < size && src[candidate + match_length] == src[ip + match_length]) {
+      match_length++;
+    }
+    if (!WriteSequence(src + anchor, ip - anchor, ip - candidate, match_length, dst, capacity, &op)) {
+      return 0;
+    }
+    ip += match_length;
+    anchor = ip;
+  }
+  if (!WriteSequence(src + anchor, size - anchor, 0, 0, dst, capacity, &op)) {
+    return 0;
+  }
+  return op;
+}
+
+bool CompressionUtil::Decompress(const char *src, int size, char *dst, int raw_size) {
+  int ip = 0;
+  int op = 0;
+  while (ip < size) {
+    auto token = static_cast<uint8_t>(src[ip++]);
+    int literal_length = token >> 4;
+    if (literal_length == 15 && !ReadLength(src, size, &ip, &literal_length)) {
+      return false;
+    }
+    if (ip + literal_length > size || op + literal_length > raw_size) {
+      return false;
+    }
+    memcpy(dst + op, src + ip, literal_length);
+    ip += literal_length;
+    op += literal_length;
+    if (ip == size) {
+      break;
+    }
+
+    if (ip + 2 > size) {
+      return false;
+    }
+    int offset = static_cast<uint8_t>(src[ip]) | (static_cast<uint8_t>(src[ip + 1]) << 8);
+    ip += 2;
+    int match_length = token & 15;
+    if (match_length == 15 && !ReadLength(src, size, &ip, &match_length)) {
+      return false;
+    }
+    match_length += MIN_MATCH;
+    if (offset == 0 || offset > op || op + match_length > raw_size) {
+      return false;
+    }
+    // the match may overlap the bytes it produces, so it is copied byte by byte
+    for (int i = 0; i < match_length; i++, op++) {
+      dst[op] = dst[op - offset];
+    }
+  }
+  return op == raw_size;
+}
+
+}  // namespace bustub
@@ -12,9 +12,12 @@
 
 #include "concurrency/transaction_manager.h"
 
+#include <mutex>  // NOLINT
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
+#include "storage/index/index.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
@@ -30,8 +33,13 @@ Transaction *TransactionManager::Begin(Transaction *txn) {
   }
 
   if (enable_logging) {
+    int64_t begin_offset;
+    log_manager_->GetNextLSNAndOffset(&begin_offset);
+    txn->SetBeginLogOffset(begin_offset);
     LogRecord log_record = LogRecord(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::BEGIN);
     log_manager_->AppendLogRecord(&log_record);
+    std::lock_guard<std::mutex> lg(active_txns_latch_);
+    active_txns_.insert(txn);
   }
 
   txn_map[txn->GetTransactionId()] = txn;
@@ -53,11 +61,16 @@ void TransactionManager::Commit(Transaction *txn) {
     write_set->pop_back();
   }
   write_set->clear();
+  txn->GetIndexWriteSet()->clear();
 
   if (enable_logging) {
     // TODO(student): add logging here
     LogRecord log_record = LogRecord(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::COMMIT);
     log_manager_->AppendLogRecord(&log_record);
+    {
+      std::lock_guard<std::mutex> lg(active_txns_latch_);
+      active_txns_.erase(txn);
+    }
     log_manager_->SyncFlush(true);
   }
 
@@ -70,7 +83,18 @@ void TransactionManager::Commit(Transaction *txn) {
 void TransactionManager::Abort(Transaction *txn) {
   txn->SetState(TransactionState::ABORTED);
 
-  // Rollback before releasing the lock.
+  // Rollback before releasing the lock. The index entries go first, while the tuples they point at still exist.
+  auto index_write_set = txn->GetIndexWriteSet();
+  while (!index_write_set->empty()) {
+    auto &item = index_write_set->back();
+    if (item.wtype_ == WType::INSERT) {
+      item.index_->DeleteEntry(item.key_, item.rid_, txn);
+    } else if (item.wtype_ == WType::DELETE) {
+      item.index_->InsertEntry(item.key_, item.rid_, txn);
+    }
+    index_write_set->pop_back();
+  }
+
   auto write_set = txn->GetWriteSet();
   while (!write_set->empty()) {
     auto &item = write_set->back();
@@ -91,6 +115,8 @@ void TransactionManager::Abort(Transaction *txn) {
     // TODO(student): add logging here
     LogRecord log_record = LogRecord(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::ABORT);
     log_manager_->AppendLogRecord(&log_record);
+    std::lock_guard<std::mutex> lg(active_txns_latch_);
+    active_txns_.erase(txn);
   }
 
   // Release all the locks.
@@ -103,4 +129,14 @@ void TransactionManager::BlockAllTransactions() { global_txn_latch_.WLock(); }
 
 void TransactionManager::ResumeTransactions() { global_txn_latch_.WUnlock(); }
 
+std::vector<ActiveTxnEntry> TransactionManager::GetActiveTransactionTable() {
+  std::lock_guard<std::mutex> lg(active_txns_latch_);
+  std::vector<ActiveTxnEntry> active_txns;
+  active_txns.reserve(active_txns_.size());
+  for (auto *txn : active_txns_) {
+    active_txns.push_back({txn->GetTransactionId(), txn->GetPrevLSN(), txn->GetBeginLogOffset()});
+  }
+  return active_txns;
+}
+
 }  // namespace bustub
@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter.cpp
+//
+// Identification: src/container/hash/bloom_filter.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <vector>
+
+#include "container/hash/bloom_filter.h"
+#include "storage/page/bloom_filter_page.h"
+
+namespace bustub {
+
+BloomFilter::BloomFilter(size_t num_keys, size_t bits_per_key)
+    : BloomFilter(std::max<size_t>(num_keys * bits_per_key / (WORDS_PER_BLOCK * 32), 1)) {}
+
+void BloomFilter::Add(uint64_t hash) {
+  std::atomic<uint32_t> *block = &words_[blockOf(hash)];
+  for (uint32_t i = 0; i < WORDS_PER_BLOCK; i++) {
+    block[i].fetch_or(bitOf(hash, i), std::memory_order_relaxed);
+  }
+}
+
+bool BloomFilter::MayContain(uint64_t hash) const {
+  const std::atomic<uint32_t> *block = &words_[blockOf(hash)];
+  // all 8 words are tested without an early exit, which compiles to a branch free sequence
+  uint32_t missing = 0;
+  for (uint32_t i = 0; i < WORDS_PER_BLOCK; i++) {
+    uint32_t bit = bitOf(hash, i);
+    missing |= bit & ~block[i].load(std::memory_order_relaxed);
+  }
+  return missing == 0;
+}
+
+page_id_t BloomFilter::Persist(BufferPoolManager *buffer_pool_manager, page_id_t owner_page_id,
+                               uint64_t num_keys) const {
+  // the pages are written from the last one on, so that each knows its successor
+  const size_t num_pages = (NumWords() + BloomFilterPage::WORDS_PER_PAGE - 1) / BloomFilterPage::WORDS_PER_PAGE;
+  page_id_t next_page_id = INVALID_PAGE_ID;
+  for (size_t page_idx = num_pages; page_idx-- > 0;) {
+    page_id_t page_id;
+    Page *page = buffer_pool_manager->NewPage(&page_id);
+    auto filter_page = reinterpret_cast<BloomFilterPage *>(page->GetData());
+    filter_page->Init(page_id);
+    filter_page->SetNextPageId(next_page_id);
+    const size_t first_word = page_idx * BloomFilterPage::WORDS_PER_PAGE;
+    const auto num_words =
+        static_cast<uint32_t>(std::min<size_t>(BloomFilterPage::WORDS_PER_PAGE, NumWords() - first_word));
+    filter_page->SetNumWords(num_words);
+    if (page_idx == 0) {
+      filter_page->SetNumKeys(num_keys);
+      filter_page->SetOwnerPageId(owner_page_id);
+    }
+    for (uint32_t i = 0; i < num_words; i++) {
+      filter_page->GetWords()[i] = words_[first_word + i].load(std::memory_order_relaxed);
+    }
+    buffer_pool_manager->UnpinPage(page_id, true);
+    next_page_id = page_id;
+  }
+  return next_page_id;
+}
+
+std::unique_ptr<BloomFilter> BloomFilter::Load(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id,
+                                               page_id_t owner_page_id, uint64_t num_keys) {
+  std::vector<uint32_t> words;
+  for (page_id_t page_id = first_page_id; page_id != INVALID_PAGE_ID;) {
+    Page *page = buffer_pool_manager->FetchPage(page_id);
+    auto filter_page = reinterpret_cast<BloomFilterPage *>(page->GetData());
+    if (page_id == first_page_id &&
+        (filter_page->GetOwnerPageId() != owner_page_id || filter_page->GetNumKeys() != num_keys)) {
+      buffer_pool_manager->UnpinPage(page_id, false);
+      return nullptr;
+    }
+    words.insert(words.end(), filter_page->GetWords(), filter_page->GetWords() + filter_page->GetNumWords());
+    page_id_t next_page_id = filter_page->GetNextPageId();
+    buffer_pool_manager->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  if (words.empty() || words.size() % WORDS_PER_BLOCK != 0) {
+    return nullptr;
+  }
+  std::unique_ptr<BloomFilter> filter(new BloomFilter(words.size() / WORDS_PER_BLOCK));
+  for (size_t i = 0; i < words.size(); i++) {
+    filter->words_[i].store(words[i], std::memory_order_relaxed);
+  }
+  return filter;
+}
+
+void BloomFilter::Drop(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id) {
+  for (page_id_t page_id = first_page_id; page_id != INVALID_PAGE_ID;) {
+    Page *page = buffer_pool_manager->FetchPage(page_id);
+    page_id_t next_page_id = reinterpret_cast<BloomFilterPage *>(page->GetData())->GetNextPageId();
+    buffer_pool_manager->UnpinPage(page_id, false);
+    buffer_pool_manager->DeletePage(page_id);
+    page_id = next_page_id;
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,352 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table.cpp
+//
+// Identification: src/container/hash/extendible_hash_table.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/rid.h"
+#include "container/hash/extendible_hash_table.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+EXTENDIBLE_HASH_TABLE_TYPE::ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                                                const KeyComparator &comparator, HashFunction<KeyType> hash_fn)
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)), size_(0) {
+  Page *dir = buffer_pool_manager_->NewPage(&directory_page_id_);
+  auto dir_page = reinterpret_cast<HashTableDirectoryPage *>(dir->GetData());
+  dir_page->SetPageId(directory_page_id_);
+
+  // a fresh page is zeroed, the directory starts with global depth 0 and a single bucket of local depth 0
+  page_id_t bucket_page_id;
+  buffer_pool_manager_->NewPage(&bucket_page_id);
+  dir_page->SetBucketPageId(0, bucket_page_id);
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+}
+
+/*****************************************************************************
+ * HELPERS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t EXTENDIBLE_HASH_TABLE_TYPE::hash(const KeyType &key) {
+  return static_cast<uint32_t>(hash_fn_.GetHash(key));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint8_t EXTENDIBLE_HASH_TABLE_TYPE::tag(const KeyType &key) {
+  return BucketPage::TagOf(hash_fn_.GetHash(key));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t EXTENDIBLE_HASH_TABLE_TYPE::keyToDirectoryIndex(const KeyType &key, HashTableDirectoryPage *dir_page) {
+  return hash(key) & dir_page->GetGlobalDepthMask();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::bucketInsert(BucketPage *bucket, const KeyType &key, const ValueType &value,
+                                              bool *full) {
+  // the occupied slots form a prefix, the first free slot is a tombstone in it or the slot right after it
+  const uint8_t key_tag = tag(key);
+  slot_offset_t free_slot = BLOCK_ARRAY_SIZE;
+  for (slot_offset_t i = 0; i < BLOCK_ARRAY_SIZE; i += BucketPage::TAG_GROUP_SIZE) {
+    uint32_t matches;
+    uint32_t free_slots;
+    uint32_t num_slots = std::min<uint32_t>(BucketPage::TAG_GROUP_SIZE, BLOCK_ARRAY_SIZE - i);
+    uint32_t num_occupied = bucket->ProbeGroup(i, num_slots, key_tag, &matches, &free_slots);
+    for (; matches != 0; matches &= matches - 1) {
+      slot_offset_t slot = i + __builtin_ctz(matches);
+      if (comparator_(bucket->KeyAt(slot), key) == 0 && bucket->ValueAt(slot) == value) {
+        // not allowed to insert the same key-value pair
+        *full = false;
+        return false;
+      }
+    }
+    if (free_slot == BLOCK_ARRAY_SIZE && free_slots != 0) {
+      free_slot = i + __builtin_ctz(free_slots);
+    }
+    if (num_occupied < num_slots) {
+      break;
+    }
+  }
+  *full = free_slot == BLOCK_ARRAY_SIZE;
+  return !*full && bucket->Insert(free_slot, key, value, key_tag);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::bucketIsEmpty(BucketPage *bucket) {
+  for (slot_offset_t i = 0; i < BLOCK_ARRAY_SIZE && bucket->IsOccupied(i); i++) {
+    if (bucket->IsReadable(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key,
+                                          std::vector<ValueType> *result) {
+  table_latch_.RLock();
+  Page *dir = buffer_pool_manager_->FetchPage(directory_page_id_);
+  auto dir_page = reinterpret_cast<HashTableDirectoryPage *>(dir->GetData());
+  page_id_t bucket_page_id = dir_page->GetBucketPageId(keyToDirectoryIndex(key, dir_page));
+  Page *bucket = buffer_pool_manager_->FetchPage(bucket_page_id);
+  bucket->RLatch();
+  auto bucket_page = reinterpret_cast<BucketPage *>(bucket->GetData());
+
+  const uint8_t key_tag = tag(key);
+  for (slot_offset_t i = 0; i < BLOCK_ARRAY_SIZE; i += BucketPage::TAG_GROUP_SIZE) {
+    uint32_t matches;
+    uint32_t free_slots;
+    uint32_t num_slots = std::min<uint32_t>(BucketPage::TAG_GROUP_SIZE, BLOCK_ARRAY_SIZE - i);
+    uint32_t num_occupied = bucket_page->ProbeGroup(i, num_slots, key_tag, &matches, &free_slots);
+    for (; matches != 0; matches &= matches - 1) {
+      slot_offset_t slot = i + __builtin_ctz(matches);
+      if (comparator_(bucket_page->KeyAt(slot), key) == 0) {
+        result->push_back(bucket_page->ValueAt(slot));
+      }
+    }
+    if (num_occupied < num_slots) {
+      break;
+    }
+  }
+
+  bucket->RUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  return !result->empty();
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  while (true) {
+    table_latch_.RLock();
+    Page *dir = buffer_pool_manager_->FetchPage(directory_page_id_);
+    auto dir_page = reinterpret_cast<HashTableDirectoryPage *>(dir->GetData());
+    page_id_t bucket_page_id = dir_page->GetBucketPageId(keyToDirectoryIndex(key, dir_page));
+    Page *bucket = buffer_pool_manager_->FetchPage(bucket_page_id);
+    bucket->WLatch();
+
+    bool full;
+    bool inserted = bucketInsert(reinterpret_cast<BucketPage *>(bucket->GetData()), key, value, &full);
+    if (inserted) {
+      size_++;
+    }
+
+    bucket->WUnlatch();
+    buffer_pool_manager_->UnpinPage(bucket_page_id, inserted);
+    buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+    table_latch_.RUnlock();
+    if (!full) {
+      return inserted;
+    }
+    // only the full bucket is split, then the insert is tried again
+    if (!splitBucket(key)) {
+      return false;
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::splitBucket(const KeyType &key) {
+  table_latch_.WLock();
+  Page *dir = buffer_pool_manager_->FetchPage(directory_page_id_);
+  auto dir_page = reinterpret_cast<HashTableDirectoryPage *>(dir->GetData());
+  uint32_t bucket_idx = keyToDirectoryIndex(key, dir_page);
+  page_id_t bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+  Page *bucket = buffer_pool_manager_->FetchPage(bucket_page_id);
+  auto bucket_page = reinterpret_cast<BucketPage *>(bucket->GetData());
+  uint32_t local_depth = dir_page->GetLocalDepth(bucket_idx);
+
+  // another insert may have split the bucket already
+  bool split = true;
+  for (slot_offset_t i = 0; split && i < BLOCK_ARRAY_SIZE; i++) {
+    split = bucket_page->IsReadable(i);
+  }
+  if (!split || (local_depth == dir_page->GetGlobalDepth() && local_depth == MAX_GLOBAL_DEPTH)) {
+    buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+    buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+    table_latch_.WUnlock();
+    return !split;
+  }
+
+  if (local_depth == dir_page->GetGlobalDepth()) {
+    dir_page->IncrGlobalDepth();
+  }
+  page_id_t image_page_id;
+  Page *image = buffer_pool_manager_->NewPage(&image_page_id);
+  auto image_page = reinterpret_cast<BucketPage *>(image->GetData());
+
+  // the entries of the bucket whose next hash bit is set move to the image
+  const uint32_t high_bit = 1U << local_depth;
+  for (uint32_t i = bucket_idx & (high_bit - 1); i < dir_page->Size(); i += high_bit) {
+    dir_page->SetLocalDepth(i, local_depth + 1);
+    if ((i & high_bit) != 0) {
+      dir_page->SetBucketPageId(i, image_page_id);
+    }
+  }
+
+  // a full bucket has no tombstones, both buckets are rebuilt so that their occupied slots form a prefix again
+  std::vector<MappingType> pairs;
+  pairs.reserve(BLOCK_ARRAY_SIZE);
+  for (slot_offset_t i = 0; i < BLOCK_ARRAY_SIZE; i++) {
+    pairs.emplace_back(bucket_page->KeyAt(i), bucket_page->ValueAt(i));
+  }
+  memset(bucket->GetData() + HASH_TABLE_BLOCK_HEADER_SIZE, 0, PAGE_SIZE - HASH_TABLE_BLOCK_HEADER_SIZE);
+  slot_offset_t bucket_slot = 0;
+  slot_offset_t image_slot = 0;
+  for (const auto &pair : pairs) {
+    if ((hash(pair.first) & high_bit) != 0) {
+      image_page->Insert(image_slot++, pair.first, pair.second, tag(pair.first));
+    } else {
+      bucket_page->Insert(bucket_slot++, pair.first, pair.second, tag(pair.first));
+    }
+  }
+
+  buffer_pool_manager_->UnpinPage(image_page_id, true);
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+  table_latch_.WUnlock();
+  return true;
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.RLock();
+  Page *dir = buffer_pool_manager_->FetchPage(directory_page_id_);
+  auto dir_page = reinterpret_cast<HashTableDirectoryPage *>(dir->GetData());
+  page_id_t bucket_page_id = dir_page->GetBucketPageId(keyToDirectoryIndex(key, dir_page));
+  Page *bucket = buffer_pool_manager_->FetchPage(bucket_page_id);
+  bucket->WLatch();
+  auto bucket_page = reinterpret_cast<BucketPage *>(bucket->GetData());
+
+  const uint8_t key_tag = tag(key);
+  bool removed = false;
+  for (slot_offset_t i = 0; !removed && i < BLOCK_ARRAY_SIZE; i += BucketPage::TAG_GROUP_SIZE) {
+    uint32_t matches;
+    uint32_t free_slots;
+    uint32_t num_slots = std::min<uint32_t>(BucketPage::TAG_GROUP_SIZE, BLOCK_ARRAY_SIZE - i);
+    uint32_t num_occupied = bucket_page->ProbeGroup(i, num_slots, key_tag, &matches, &free_slots);
+    for (; matches != 0 && !removed; matches &= matches - 1) {
+      slot_offset_t slot = i + __builtin_ctz(matches);
+      if (comparator_(bucket_page->KeyAt(slot), key) == 0 && bucket_page->ValueAt(slot) == value) {
+        bucket_page->Remove(slot);
+        removed = true;
+        size_--;
+      }
+    }
+    if (num_occupied < num_slots) {
+      break;
+    }
+  }
+  bool empty = removed && bucketIsEmpty(bucket_page);
+
+  bucket->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, removed);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  if (empty) {
+    mergeBucket(key);
+  }
+  return removed;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::mergeBucket(const KeyType &key) {
+  table_latch_.WLock();
+  Page *dir = buffer_pool_manager_->FetchPage(directory_page_id_);
+  auto dir_page = reinterpret_cast<HashTableDirectoryPage *>(dir->GetData());
+  uint32_t bucket_idx = keyToDirectoryIndex(key, dir_page);
+  uint32_t local_depth = dir_page->GetLocalDepth(bucket_idx);
+  page_id_t bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+
+  // the bucket merges only with an image of the same local depth, and only while it is still empty
+  bool merge = local_depth > 0;
+  uint32_t image_idx = merge ? dir_page->GetSplitImageIndex(bucket_idx) : bucket_idx;
+  merge = merge && dir_page->GetLocalDepth(image_idx) == local_depth;
+  if (merge) {
+    Page *bucket = buffer_pool_manager_->FetchPage(bucket_page_id);
+    merge = bucketIsEmpty(reinterpret_cast<BucketPage *>(bucket->GetData()));
+    buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  }
+  if (!merge) {
+    buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+    table_latch_.WUnlock();
+    return;
+  }
+
+  page_id_t image_page_id = dir_page->GetBucketPageId(image_idx);
+  const uint32_t low_bits = (1U << (local_depth - 1)) - 1;
+  for (uint32_t i = bucket_idx & low_bits; i < dir_page->Size(); i += low_bits + 1) {
+    dir_page->SetLocalDepth(i, local_depth - 1);
+    dir_page->SetBucketPageId(i, image_page_id);
+  }
+  buffer_pool_manager_->DeletePage(bucket_page_id);
+  while (dir_page->CanShrink()) {
+    dir_page->DecrGlobalDepth();
+  }
+
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+  table_latch_.WUnlock();
+}
+
+/*****************************************************************************
+ * GETSIZE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t EXTENDIBLE_HASH_TABLE_TYPE::GetGlobalDepth() {
+  table_latch_.RLock();
+  Page *dir = buffer_pool_manager_->FetchPage(directory_page_id_);
+  uint32_t global_depth = reinterpret_cast<HashTableDirectoryPage *>(dir->GetData())->GetGlobalDepth();
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  return global_depth;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+size_t EXTENDIBLE_HASH_TABLE_TYPE::GetSize() {
+  return size_.load();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::VerifyIntegrity() {
+  table_latch_.RLock();
+  Page *dir = buffer_pool_manager_->FetchPage(directory_page_id_);
+  reinterpret_cast<HashTableDirectoryPage *>(dir->GetData())->VerifyIntegrity();
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+}
+
+template class ExtendibleHashTable<int, int, IntComparator>;
+
+template class ExtendibleHashTable<GenericKey<4>, RID, GenericComparator<4>>;
+template class ExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>>;
+template class ExtendibleHashTable<GenericKey<16>, RID, GenericComparator<16>>;
+template class ExtendibleHashTable<GenericKey<32>, RID, GenericComparator<32>>;
+template class ExtendibleHashTable<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
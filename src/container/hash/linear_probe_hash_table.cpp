@@ -10,6 +10,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <deque>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -17,30 +19,127 @@
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "common/macros.h"
 #include "common/rid.h"
 #include "container/hash/linear_probe_hash_table.h"
+#include "recovery/page_delta.h"
+#include "storage/page/bloom_filter_page.h"
 
 namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                       const KeyComparator &comparator, size_t num_buckets,
-                                      HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)), size_(0) {
+                                      HashFunction<KeyType> hash_fn, LogManager *log_manager)
+    : buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      hash_fn_(std::move(hash_fn)),
+      size_(0),
+      log_manager_(log_manager) {
   // todo: find table by name
   // todo: how to utilize transaction?
-  Page *header = buffer_pool_manager_->NewPage(&header_page_id_);
+  header_page_id_ = createTable(num_buckets, &block_page_ids_);
+  buffer_pool_manager_->NewPage(&anchor_page_id_);
+  buffer_pool_manager_->UnpinPage(anchor_page_id_, true);
+  updateAnchor();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                                      const KeyComparator &comparator, HashFunction<KeyType> hash_fn,
+                                      page_id_t anchor_page_id, LogManager *log_manager)
+    : anchor_page_id_(anchor_page_id),
+      buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      hash_fn_(std::move(hash_fn)),
+      size_(0),
+      log_manager_(log_manager) {
+  Page *anchor = buffer_pool_manager_->FetchPage(anchor_page_id_);
+  auto anchor_page = reinterpret_cast<HashTableAnchorPage *>(anchor->GetData());
+  header_page_id_ = anchor_page->GetHeaderPageId();
+  old_header_page_id_ = anchor_page->GetOldHeaderPageId();
+  buffer_pool_manager_->UnpinPage(anchor_page_id_, false);
 
+  loadTable(header_page_id_, &block_page_ids_);
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    // the resize goes on from the first slot, the old table has no filter until the resize is done
+    loadTable(old_header_page_id_, &old_block_page_ids_);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::loadTable(page_id_t header_page_id, std::vector<page_id_t> *block_page_ids) {
+  Page *header = buffer_pool_manager_->FetchPage(header_page_id);
   auto header_page = reinterpret_cast<HashTableHeaderPage *>(header->GetData());
-  header_page->SetPageId(header_page_id_);
+  for (size_t page_idx = 0; page_idx < header_page->NumBlocks(); page_idx++) {
+    block_page_ids->push_back(header_page->GetBlockPageId(page_idx));
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id, false);
+
+  for (page_id_t block_page_id : *block_page_ids) {
+    Page *block = fetchBlockPage(block_page_id, false);
+    auto block_page = reinterpret_cast<BlockPage *>(block->GetData());
+    for (slot_offset_t offset = 0; offset < BLOCK_ARRAY_SIZE; offset++) {
+      if (block_page->IsReadable(offset)) {
+        size_++;
+      }
+    }
+    freeBlockPage(block, false, false);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+page_id_t HASH_TABLE_TYPE::createTable(size_t num_buckets, std::vector<page_id_t> *block_page_ids) {
+  page_id_t header_page_id;
+  Page *header = buffer_pool_manager_->NewPage(&header_page_id);
+
+  auto header_page = reinterpret_cast<HashTableHeaderPage *>(header->GetData());
+  header_page->SetPageId(header_page_id);
   header_page->SetSize(BLOCK_ARRAY_SIZE);
+  block_page_ids->clear();
   for (size_t i = 0; i < num_buckets; i++) {
     page_id_t block_page_id;
     buffer_pool_manager_->NewPage(&block_page_id);
     header_page->AddBlockPageId(block_page_id);
-    buffer_pool_manager->UnpinPage(block_page_id, true);
+    block_page_ids->push_back(block_page_id);
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+  }
+  // the block pages start out zeroed, only the header page is logged
+  std::string delta;
+  std::string zeros(header_page->GetUsedSize(), '\0');
+  PageDelta::Append(&delta, 0, zeros.data(), header->GetData(), zeros.size());
+  lsn_t lsn = logPageChange(LogRecordType::HASH_HEADER, header_page_id, std::move(delta));
+  if (lsn != INVALID_LSN) {
+    header->SetLSN(lsn);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id, true);
+  return header_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::updateAnchor() {
+  Page *anchor = buffer_pool_manager_->FetchPage(anchor_page_id_);
+  auto anchor_page = reinterpret_cast<HashTableAnchorPage *>(anchor->GetData());
+  std::string old_bytes(anchor->GetData(), sizeof(HashTableAnchorPage));
+  anchor_page->SetPageId(anchor_page_id_);
+  anchor_page->SetHeaderPageId(header_page_id_);
+  anchor_page->SetOldHeaderPageId(old_header_page_id_);
+  // logged like a header page, redo takes the table it points at from the log
+  std::string delta;
+  PageDelta::Append(&delta, 0, old_bytes.data(), anchor->GetData(), old_bytes.size());
+  lsn_t lsn = logPageChange(LogRecordType::HASH_HEADER, anchor_page_id_, std::move(delta));
+  if (lsn != INVALID_LSN) {
+    anchor_page->SetLSN(lsn);
   }
-  buffer_pool_manager_->UnpinPage(header_page_id_, true);
+  buffer_pool_manager_->UnpinPage(anchor_page_id_, true);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::dropTable(page_id_t header_page_id, const std::vector<page_id_t> &block_page_ids) {
+  for (page_id_t block_page_id : block_page_ids) {
+    buffer_pool_manager_->DeletePage(block_page_id);
+  }
+  buffer_pool_manager_->DeletePage(header_page_id);
 }
 
 /*****************************************************************************
@@ -48,29 +147,122 @@ HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) {
-  HashTableHeaderPage *header_page = loadHeaderPage(false, true);
+  table_latch_.RLock();
+  getValue(block_page_ids_, bloom_filter_.get(), key, result);
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    getValue(old_block_page_ids_, old_bloom_filter_.get(), key, result);
+  }
+  table_latch_.RUnlock();
+  return !result->empty();
+}
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::GetValues(Transaction *transaction, const std::vector<KeyType> &keys,
+                                std::vector<std::vector<ValueType>> *results) {
+  results->resize(keys.size());
+  table_latch_.RLock();
+  getValues(block_page_ids_, bloom_filter_.get(), keys, results);
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    getValues(old_block_page_ids_, old_bloom_filter_.get(), keys, results);
+  }
+  table_latch_.RUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::getValue(const std::vector<page_id_t> &block_page_ids, const BloomFilter *filter,
+                               const KeyType &key, std::vector<ValueType> *result) {
   auto hash_v = hash_fn_.GetHash(key);
-  page_id_t page_idx = hash_v % header_page->NumBlocks();
-  page_id_t ori_page_idx = page_idx;
-  slot_offset_t offset = hash_v % header_page->GetSize();
-  slot_offset_t ori_offset = offset;
+  if (filter != nullptr && !filter->MayContain(hash_v)) {
+    return !result->empty();
+  }
+  Page *block = buffer_pool_manager_->FetchPage(block_page_ids[hash_v % block_page_ids.size()]);
+  probeValues(block_page_ids, key, hash_v, block, result);
+  return !result->empty();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::getValues(const std::vector<page_id_t> &block_page_ids, const BloomFilter *filter,
+                                const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results) {
+  uint64_t hashes[PREFETCH_GROUP];
+  Page *blocks[PREFETCH_GROUP];
+  for (size_t first = 0; first < keys.size(); first += PREFETCH_GROUP) {
+    const size_t num_keys = std::min(PREFETCH_GROUP, keys.size() - first);
+    // the blocks are pinned only, a thread that holds read latches on several pages deadlocks with waiting writers
+    size_t num_pinned = num_keys;
+    for (size_t i = 0; i < num_keys; i++) {
+      hashes[i] = hash_fn_.GetHash(keys[first + i]);
+      if (filter != nullptr && !filter->MayContain(hashes[i])) {
+        blocks[i] = nullptr;
+        continue;
+      }
+      blocks[i] = buffer_pool_manager_->FetchPage(block_page_ids[hashes[i] % block_page_ids.size()]);
+      if (blocks[i] == nullptr) {
+        num_pinned = i;
+        break;
+      }
+      reinterpret_cast<BlockPage *>(blocks[i]->GetData())->PrefetchGroup(hashes[i] % BLOCK_ARRAY_SIZE);
+    }
+    if (num_pinned < num_keys) {
+      // the buffer pool has no room for the whole group, release it and probe the keys one at a time
+      for (size_t i = 0; i < num_pinned; i++) {
+        if (blocks[i] != nullptr) {
+          buffer_pool_manager_->UnpinPage(blocks[i]->GetPageId(), false);
+        }
+      }
+      for (size_t i = 0; i < num_keys; i++) {
+        getValue(block_page_ids, filter, keys[first + i], &(*results)[first + i]);
+      }
+      continue;
+    }
+    for (size_t i = 0; i < num_keys; i++) {
+      if (blocks[i] != nullptr) {
+        probeValues(block_page_ids, keys[first + i], hashes[i], blocks[i], &(*results)[first + i]);
+      }
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::probeValues(const std::vector<page_id_t> &block_page_ids, const KeyType &key, uint64_t hash_v,
+                                  Page *block, std::vector<ValueType> *result) {
+  const size_t ori_page_idx = hash_v % block_page_ids.size();
+  const slot_offset_t ori_offset = hash_v % BLOCK_ARRAY_SIZE;
+  size_t page_idx = ori_page_idx;
+  slot_offset_t offset = ori_offset;
 
-  auto block_page = loadBlockPage(header_page, page_idx, false, true);
+  const uint8_t tag = BlockPage::TagOf(hash_v);
 
-  while (block_page->IsOccupied(offset)) {
-    if (block_page->IsReadable(offset) && comparator_(block_page->KeyAt(offset), key) == 0) {
-      result->push_back(block_page->ValueAt(offset));
+  block->RLatch();
+  auto block_page = reinterpret_cast<BlockPage *>(block->GetData());
+  while (true) {
+    uint32_t matches;
+    uint32_t free_slots;
+    uint32_t num_slots = groupSize(page_idx, offset, ori_page_idx, ori_offset);
+    uint32_t num_occupied = block_page->ProbeGroup(offset, num_slots, tag, &matches, &free_slots);
+    for (; matches != 0; matches &= matches - 1) {
+      slot_offset_t slot = offset + __builtin_ctz(matches);
+      if (comparator_(block_page->KeyAt(slot), key) == 0) {
+        result->push_back(block_page->ValueAt(slot));
+      }
+    }
+    if (num_occupied < num_slots) {
+      break;
+    }
+    offset += num_slots;
+    if (offset == BLOCK_ARRAY_SIZE) {
+      // finish this block, and turn into the next one
+      freeBlockPage(block, false, false);
+      page_idx = (page_idx + 1) % block_page_ids.size();
+      offset = 0;
+      block = fetchBlockPage(block_page_ids[page_idx], false);
+      block_page = reinterpret_cast<BlockPage *>(block->GetData());
     }
-    gotoNextPosition(header_page, &block_page, &page_idx, &offset, false, true);
     if (page_idx == ori_page_idx && offset == ori_offset) {
       // search all data
       break;
     }
   }
-  freePage(reinterpret_cast<Page *>(block_page), header_page->GetBlockPageId(page_idx), false, true, false);
-  freePage(reinterpret_cast<Page *>(header_page), header_page_id_, false, true, false);
-  return !result->empty();
+  freeBlockPage(block, false, false);
 }
 /*****************************************************************************
  * INSERTION
@@ -78,46 +270,276 @@ bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
   table_latch_.RLock();
-  std::vector<ValueType> result;
-  GetValue(transaction, key, &result);
-  for (auto res : result) {
-    if (res == value) {
-      // not allowed to insert the same key-value pair
-      table_latch_.RUnlock();
-      return false;
+  bool exclusive = false;
+  InsertResult result;
+  while (true) {
+    // inserts go to the new table, a pair that is not migrated yet is found in the old one
+    std::vector<ValueType> old_values;
+    if (old_header_page_id_ != INVALID_PAGE_ID) {
+      getValue(old_block_page_ids_, old_bloom_filter_.get(), key, &old_values);
+    }
+    if (std::find(old_values.begin(), old_values.end(), value) != old_values.end()) {
+      result = InsertResult::DUPLICATE;
+    } else {
+      result = insertPair(block_page_ids_, key, value, exclusive);
+    }
+    if (result != InsertResult::WRAPPED) {
+      break;
     }
+    // a probe that wraps around latches the first block after a later one, only safe while it is alone
+    table_latch_.RUnlock();
+    table_latch_.WLock();
+    exclusive = true;
+  }
+  if (result == InsertResult::INSERTED) {
+    size_++;
+  }
+  bool grow = result == InsertResult::INSERTED && growing();
+  size_t num_blocks = block_page_ids_.size();
+  if (exclusive) {
+    table_latch_.WUnlock();
+  } else {
+    table_latch_.RUnlock();
   }
 
-  HashTableHeaderPage *header_page = loadHeaderPage(false, true);
+  if (result == InsertResult::FULL) {
+    if (num_blocks >= MAX_BLOCKS) {
+      return false;
+    }
+    // all entries are full, so resize the table
+    Resize(num_blocks);
+    return Insert(transaction, key, value);
+  }
+  if (grow) {
+    growStep();
+  }
+  return result == InsertResult::INSERTED;
+}
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+typename HASH_TABLE_TYPE::InsertResult HASH_TABLE_TYPE::insertPair(const std::vector<page_id_t> &block_page_ids,
+                                                                   const KeyType &key, const ValueType &value,
+                                                                   bool exclusive) {
   auto hash_v = hash_fn_.GetHash(key);
-  page_id_t page_idx = hash_v % header_page->NumBlocks();
-  page_id_t ori_page_idx = page_idx;
-  slot_offset_t offset = hash_v % header_page->GetSize();
-  slot_offset_t ori_offset = offset;
+  const size_t ori_page_idx = hash_v % block_page_ids.size();
+  const slot_offset_t ori_offset = hash_v % BLOCK_ARRAY_SIZE;
+  size_t page_idx = ori_page_idx;
+  slot_offset_t offset = ori_offset;
 
-  auto block_page = loadBlockPage(header_page, page_idx, true, false);
+  // every insert of the key starts at the first block of the probe, keeping it latched makes the duplicate check
+  // and the insert atomic, the blocks in between are released once they are checked
+  const uint8_t tag = BlockPage::TagOf(hash_v);
+  Page *ori_block = fetchBlockPage(block_page_ids[page_idx], true);
+  Page *block = ori_block;
+  Page *free_block = nullptr;
+  size_t free_page_idx = 0;
+  slot_offset_t free_offset = 0;
+  InsertResult result = InsertResult::FULL;
+  while (true) {
+    auto block_page = reinterpret_cast<BlockPage *>(block->GetData());
+    uint32_t matches;
+    uint32_t free_slots;
+    uint32_t num_slots = groupSize(page_idx, offset, ori_page_idx, ori_offset);
+    uint32_t num_occupied = block_page->ProbeGroup(offset, num_slots, tag, &matches, &free_slots);
+    for (; matches != 0; matches &= matches - 1) {
+      slot_offset_t slot = offset + __builtin_ctz(matches);
+      if (comparator_(block_page->KeyAt(slot), key) == 0 && block_page->ValueAt(slot) == value) {
+        // not allowed to insert the same key-value pair
+        result = InsertResult::DUPLICATE;
+        break;
+      }
+    }
+    if (result == InsertResult::DUPLICATE) {
+      break;
+    }
+    if (free_block == nullptr && free_slots != 0) {
+      free_block = block;
+      free_page_idx = page_idx;
+      free_offset = offset + __builtin_ctz(free_slots);
+    }
+    if (num_occupied < num_slots) {
+      break;
+    }
 
-  while (block_page->IsReadable(offset)) {
-    gotoNextPosition(header_page, &block_page, &page_idx, &offset, true, false);
+    offset += num_slots;
+    if (offset == BLOCK_ARRAY_SIZE) {
+      size_t next_page_idx = (page_idx + 1) % block_page_ids.size();
+      if (next_page_idx == 0 && ori_page_idx != 0 && !exclusive) {
+        result = InsertResult::WRAPPED;
+        break;
+      }
+      if (block != ori_block && block != free_block) {
+        freeBlockPage(block, true, false);
+      }
+      page_idx = next_page_idx;
+      offset = 0;
+      block = page_idx == ori_page_idx ? ori_block : fetchBlockPage(block_page_ids[page_idx], true);
+    }
     if (page_idx == ori_page_idx && offset == ori_offset) {
-      freePage(reinterpret_cast<Page *>(block_page), header_page->GetBlockPageId(page_idx), true, false, false);
-      freePage(reinterpret_cast<Page *>(header_page), header_page_id_, false, true, false);
-      table_latch_.RUnlock();
+      // search all data
+      break;
+    }
+  }
 
-      // all entries are full, so resize the table
-      Resize(header_page->NumBlocks());
-      return Insert(transaction, key, value);
+  if (result == InsertResult::FULL && free_block != nullptr) {
+    // pairs are inserted into the current table only, whose filter takes the key before the pair can be found
+    if (bloom_filter_ != nullptr) {
+      bloom_filter_->Add(hash_v);
     }
+    insertSlot(reinterpret_cast<BlockPage *>(free_block->GetData()), block_page_ids[free_page_idx], free_offset, key,
+               value, tag);
+    result = InsertResult::INSERTED;
+  }
+  if (block != ori_block && block != free_block) {
+    freeBlockPage(block, true, false);
+  }
+  if (free_block != nullptr && free_block != ori_block) {
+    freeBlockPage(free_block, true, result == InsertResult::INSERTED);
   }
+  freeBlockPage(ori_block, true, result == InsertResult::INSERTED && free_block == ori_block);
+  return result;
+}
 
-  block_page->Insert(offset, key, value);
-  size_++;
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::insertSlot(BlockPage *block_page, page_id_t block_page_id, slot_offset_t offset,
+                                 const KeyType &key, const ValueType &value, uint8_t tag) {
+  std::string delta = block_page->InsertDelta(offset, key, value, tag);
+  block_page->Insert(offset, key, value, tag);
+  lsn_t lsn = logPageChange(LogRecordType::HASH_INSERT, block_page_id, std::move(delta));
+  if (lsn != INVALID_LSN) {
+    block_page->SetLSN(lsn);
+  }
+  if (bloom_filter_page_current_.load() && bloom_filter_page_current_.exchange(false)) {
+    staleBloomFilterPage();
+  }
+}
 
-  freePage(reinterpret_cast<Page *>(block_page), header_page->GetBlockPageId(page_idx), true, false, true);
-  freePage(reinterpret_cast<Page *>(header_page), header_page_id_, false, true, false);
-  table_latch_.RUnlock();
-  return true;
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+size_t HASH_TABLE_TYPE::BulkLoad(Transaction *transaction, const std::vector<MappingType> &pairs,
+                                 std::vector<MappingType> *dropped) {
+  table_latch_.WLock();
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    migrate(SIZE_MAX);
+  }
+  if (size_ != 0) {
+    table_latch_.WUnlock();
+    size_t num_inserted = 0;
+    for (const auto &pair : pairs) {
+      if (Insert(transaction, pair.first, pair.second)) {
+        num_inserted++;
+        continue;
+      }
+      // the insert fails for a repeated pair as well, which is in the table
+      std::vector<ValueType> values;
+      if (dropped != nullptr && (!GetValue(transaction, pair.first, &values) ||
+                                 std::find(values.begin(), values.end(), pair.second) == values.end())) {
+        dropped->push_back(pair);
+      }
+    }
+    return num_inserted;
+  }
+
+  // a fresh table has no removed slots, and below three quarters full the pairs do not start a resize
+  const size_t num_blocks =
+      std::min(std::max(block_page_ids_.size(), 4 * pairs.size() / (3 * BLOCK_ARRAY_SIZE) + 1), MAX_BLOCKS);
+  // the empty table is dropped once the anchor points at the new one
+  page_id_t empty_header_page_id = header_page_id_;
+  std::vector<page_id_t> empty_block_page_ids;
+  empty_block_page_ids.swap(block_page_ids_);
+  header_page_id_ = createTable(num_blocks, &block_page_ids_);
+  updateAnchor();
+  dropTable(empty_header_page_id, empty_block_page_ids);
+  bloom_filter_ = newBloomFilter(num_blocks);
+
+  // partition the pairs by the block their probe starts in, in input order within a block
+  std::vector<uint64_t> hashes(pairs.size());
+  std::vector<size_t> block_starts(num_blocks + 1, 0);
+  for (size_t i = 0; i < pairs.size(); i++) {
+    hashes[i] = hash_fn_.GetHash(pairs[i].first);
+    block_starts[hashes[i] % num_blocks + 1]++;
+  }
+  for (size_t page_idx = 0; page_idx < num_blocks; page_idx++) {
+    block_starts[page_idx + 1] += block_starts[page_idx];
+  }
+  std::vector<size_t> order(pairs.size());
+  std::vector<size_t> next_positions(block_starts.begin(), block_starts.end() - 1);
+  for (size_t i = 0; i < pairs.size(); i++) {
+    order[next_positions[hashes[i] % num_blocks]++] = i;
+  }
+
+  // fill the blocks in order, the pairs whose probe runs past the end of a block go on at the start of the next one,
+  // the last block wraps around to the first, up to a second round once the table is full
+  size_t num_inserted = 0;
+  std::vector<size_t> carried;
+  std::vector<size_t> overflow;
+  for (size_t step = 0; step < num_blocks || (!carried.empty() && step < 2 * num_blocks); step++) {
+    const size_t page_idx = step % num_blocks;
+    Page *block = fetchBlockPage(block_page_ids_[page_idx], true);
+    auto block_page = reinterpret_cast<BlockPage *>(block->GetData());
+    bool dirty = false;
+    auto place = [&](size_t i, slot_offset_t offset) {
+      InsertResult result = insertIntoBlock(block_page, block_page_ids_[page_idx], offset, pairs[i].first,
+                                            pairs[i].second, BlockPage::TagOf(hashes[i]));
+      if (result == InsertResult::INSERTED) {
+        if (bloom_filter_ != nullptr) {
+          bloom_filter_->Add(hashes[i]);
+        }
+        num_inserted++;
+        dirty = true;
+      } else if (result == InsertResult::FULL) {
+        overflow.push_back(i);
+      }
+    };
+    for (size_t i : carried) {
+      place(i, 0);
+    }
+    if (step < num_blocks) {
+      for (size_t pos = block_starts[page_idx]; pos < block_starts[page_idx + 1]; pos++) {
+        place(order[pos], hashes[order[pos]] % BLOCK_ARRAY_SIZE);
+      }
+    }
+    freeBlockPage(block, true, dirty);
+    carried.swap(overflow);
+    overflow.clear();
+  }
+  // the pairs still carried after the second round found no free slot in the whole table
+  if (dropped != nullptr) {
+    for (size_t i : carried) {
+      dropped->push_back(pairs[i]);
+    }
+  }
+  size_ += num_inserted;
+  table_latch_.WUnlock();
+  return num_inserted;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+typename HASH_TABLE_TYPE::InsertResult HASH_TABLE_TYPE::insertIntoBlock(BlockPage *block_page,
+                                                                        page_id_t block_page_id,
+                                                                        slot_offset_t offset, const KeyType &key,
+                                                                        const ValueType &value, uint8_t tag) {
+  while (offset < BLOCK_ARRAY_SIZE) {
+    uint32_t matches;
+    uint32_t free_slots;
+    auto num_slots = std::min<uint32_t>(BlockPage::TAG_GROUP_SIZE, BLOCK_ARRAY_SIZE - offset);
+    uint32_t num_occupied = block_page->ProbeGroup(offset, num_slots, tag, &matches, &free_slots);
+    for (; matches != 0; matches &= matches - 1) {
+      slot_offset_t slot = offset + __builtin_ctz(matches);
+      if (comparator_(block_page->KeyAt(slot), key) == 0 && block_page->ValueAt(slot) == value) {
+        return InsertResult::DUPLICATE;
+      }
+    }
+    if (num_occupied < num_slots) {
+      // the table is fresh, so the first free slot ends the probe
+      insertSlot(block_page, block_page_id, offset + __builtin_ctz(free_slots), key, value, tag);
+      return InsertResult::INSERTED;
+    }
+    offset += num_slots;
+  }
+  return InsertResult::FULL;
 }
 
 /*****************************************************************************
@@ -126,38 +548,234 @@ bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
   table_latch_.RLock();
-  HashTableHeaderPage *header_page = loadHeaderPage(false, true);
+  size_t tombstone = SIZE_MAX;
+  bool removed = removePair(block_page_ids_, key, value, &tombstone);
+  if (!removed && old_header_page_id_ != INVALID_PAGE_ID) {
+    // the old table is dropped once it is drained, its tombstones are left alone
+    size_t old_tombstone;
+    removed = removePair(old_block_page_ids_, key, value, &old_tombstone);
+  }
+  if (removed) {
+    size_--;
+  }
+  bool migrating = old_header_page_id_ != INVALID_PAGE_ID;
+  page_id_t header_page_id = header_page_id_;
+  table_latch_.RUnlock();
 
+  if (tombstone != SIZE_MAX) {
+    table_latch_.WLock();
+    // unless a resize started in between, which drains the table anyway
+    if (header_page_id_ == header_page_id) {
+      compactRun(tombstone);
+    }
+    table_latch_.WUnlock();
+  }
+  if (removed && migrating) {
+    growStep();
+  }
+  return removed;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::removePair(const std::vector<page_id_t> &block_page_ids, const KeyType &key,
+                                 const ValueType &value, size_t *tombstone) {
   auto hash_v = hash_fn_.GetHash(key);
-  page_id_t page_idx = hash_v % header_page->NumBlocks();
-  page_id_t ori_page_idx = page_idx;
-  slot_offset_t offset = hash_v % header_page->GetSize();
-  slot_offset_t ori_offset = offset;
+  const size_t ori_page_idx = hash_v % block_page_ids.size();
+  const slot_offset_t ori_offset = hash_v % BLOCK_ARRAY_SIZE;
+  size_t page_idx = ori_page_idx;
+  slot_offset_t offset = ori_offset;
 
-  auto block_page = loadBlockPage(header_page, page_idx, true, false);
+  const uint8_t tag = BlockPage::TagOf(hash_v);
 
+  Page *block = fetchBlockPage(block_page_ids[page_idx], true);
+  auto block_page = reinterpret_cast<BlockPage *>(block->GetData());
   bool removed = false;
-  while (block_page->IsOccupied(offset)) {
-    if (block_page->IsReadable(offset) && comparator_(block_page->KeyAt(offset), key) == 0 &&
-        block_page->ValueAt(offset) == value) {
-      block_page->Remove(offset);
-      removed = true;
-      size_--;
+  while (!removed) {
+    uint32_t matches;
+    uint32_t free_slots;
+    uint32_t num_slots = groupSize(page_idx, offset, ori_page_idx, ori_offset);
+    uint32_t num_occupied = block_page->ProbeGroup(offset, num_slots, tag, &matches, &free_slots);
+    for (; matches != 0 && !removed; matches &= matches - 1) {
+      slot_offset_t slot = offset + __builtin_ctz(matches);
+      if (comparator_(block_page->KeyAt(slot), key) == 0 && block_page->ValueAt(slot) == value) {
+        slot_offset_t hole =
+            removeAndShift(block_page, block_page_ids[page_idx], page_idx, block_page_ids.size(), slot);
+        if (hole != BLOCK_ARRAY_SIZE) {
+          *tombstone = page_idx * BLOCK_ARRAY_SIZE + hole;
+        }
+        removed = true;
+      }
+    }
+    if (removed || num_occupied < num_slots) {
       break;
     }
-
-    gotoNextPosition(header_page, &block_page, &page_idx, &offset, true, false);
+    offset += num_slots;
+    if (offset == BLOCK_ARRAY_SIZE) {
+      freeBlockPage(block, true, false);
+      page_idx = (page_idx + 1) % block_page_ids.size();
+      offset = 0;
+      block = fetchBlockPage(block_page_ids[page_idx], true);
+      block_page = reinterpret_cast<BlockPage *>(block->GetData());
+    }
     if (page_idx == ori_page_idx && offset == ori_offset) {
       // search all data
       break;
     }
   }
+  freeBlockPage(block, true, removed);
+  return removed;
+}
 
-  freePage(reinterpret_cast<Page *>(block_page), header_page->GetBlockPageId(page_idx), true, false, true);
-  freePage(reinterpret_cast<Page *>(header_page), header_page_id_, false, true, false);
+template <typename KeyType, typename ValueType, typename KeyComparator>
+size_t HASH_TABLE_TYPE::RemoveValues(Transaction *transaction,
+                                     const std::function<bool(const ValueType &)> &is_removed) {
+  table_latch_.WLock();
+  // no pair moves while the blocks are walked, as the removes leave tombstones rather than shift the pairs back
+  size_t num_removed = 0;
+  for (const auto *block_page_ids : {&block_page_ids_, &old_block_page_ids_}) {
+    for (page_id_t block_page_id : *block_page_ids) {
+      Page *block = fetchBlockPage(block_page_id, true);
+      auto block_page = reinterpret_cast<BlockPage *>(block->GetData());
+      bool dirty = false;
+      for (slot_offset_t offset = 0; offset < BLOCK_ARRAY_SIZE; offset++) {
+        if (block_page->IsReadable(offset) && is_removed(block_page->ValueAt(offset))) {
+          removeSlot(block_page, block_page_id, offset);
+          dirty = true;
+          num_removed++;
+        }
+      }
+      freeBlockPage(block, true, dirty);
+    }
+  }
+  size_ -= num_removed;
+  table_latch_.WUnlock();
+  return num_removed;
+}
 
-  table_latch_.RUnlock();
-  return removed;
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::removeSlot(BlockPage *block_page, page_id_t block_page_id, slot_offset_t offset) {
+  std::string delta = block_page->RemoveDelta(offset);
+  block_page->Remove(offset);
+  lsn_t lsn = logPageChange(LogRecordType::HASH_REMOVE, block_page_id, std::move(delta));
+  if (lsn != INVALID_LSN) {
+    block_page->SetLSN(lsn);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+slot_offset_t HASH_TABLE_TYPE::removeAndShift(BlockPage *block_page, page_id_t block_page_id, size_t page_idx,
+                                              size_t num_blocks, slot_offset_t offset) {
+  // the moves of a removal are logged as one change, the deltas of consecutive changes of a page add up
+  std::string delta = block_page->RemoveDelta(offset);
+  block_page->Remove(offset);
+
+  const size_t capacity = num_blocks * BLOCK_ARRAY_SIZE;
+  slot_offset_t hole = offset;
+  slot_offset_t slot = offset + 1;
+  for (; slot < BLOCK_ARRAY_SIZE && block_page->IsOccupied(slot); slot++) {
+    if (!block_page->IsReadable(slot)) {
+      continue;
+    }
+    // a pair whose probe starts at or before the hole passes it, so it may move there
+    const KeyType key = block_page->KeyAt(slot);
+    const uint64_t hash_v = hash_fn_.GetHash(key);
+    const size_t start = hash_v % num_blocks * BLOCK_ARRAY_SIZE + hash_v % BLOCK_ARRAY_SIZE;
+    const size_t position = page_idx * BLOCK_ARRAY_SIZE + slot;
+    if ((position + capacity - start) % capacity >= static_cast<size_t>(slot - hole)) {
+      const ValueType value = block_page->ValueAt(slot);
+      const uint8_t tag = block_page->TagAt(slot);
+      delta += block_page->InsertDelta(hole, key, value, tag);
+      block_page->Insert(hole, key, value, tag);
+      delta += block_page->RemoveDelta(slot);
+      block_page->Remove(slot);
+      hole = slot;
+    }
+  }
+  // all pairs that passed the hole moved, unless the run of occupied slots goes on in the next block, whose pairs
+  // are left where they are rather than latching the next block as well, the hole stays a tombstone then
+  if (slot < BLOCK_ARRAY_SIZE) {
+    // so are the tombstones right before the hole, every probe that reaches them ends at the hole
+    for (slot = hole + 1; slot-- > 0 && block_page->IsOccupied(slot) && !block_page->IsReadable(slot);) {
+      delta += block_page->FreeDelta(slot);
+      block_page->Free(slot);
+    }
+    hole = BLOCK_ARRAY_SIZE;
+  }
+
+  lsn_t lsn = logPageChange(LogRecordType::HASH_REMOVE, block_page_id, std::move(delta));
+  if (lsn != INVALID_LSN) {
+    block_page->SetLSN(lsn);
+  }
+  return hole;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::compactRun(size_t start) {
+  const size_t num_blocks = block_page_ids_.size();
+  const size_t capacity = num_blocks * BLOCK_ARRAY_SIZE;
+  // the blocks of the run stay latched until it is compacted, with the changes of each to log
+  std::vector<std::pair<Page *, std::string>> blocks;
+  auto block_at = [&](size_t position) {
+    const size_t page_idx = position / BLOCK_ARRAY_SIZE;
+    const size_t first_page_idx = start / BLOCK_ARRAY_SIZE;
+    auto &block = blocks[(page_idx + num_blocks - first_page_idx) % num_blocks];
+    return std::make_pair(reinterpret_cast<BlockPage *>(block.first->GetData()), &block.second);
+  };
+
+  // walk the run from start to its first unoccupied slot, moving each pair to the first hole its probe passes
+  std::deque<size_t> holes;
+  bool ended = false;
+  for (size_t step = 0; step < capacity && !ended; step++) {
+    const size_t position = (start + step) % capacity;
+    const auto offset = static_cast<slot_offset_t>(position % BLOCK_ARRAY_SIZE);
+    if ((step == 0 || offset == 0) && blocks.size() < num_blocks) {
+      blocks.emplace_back(fetchBlockPage(block_page_ids_[position / BLOCK_ARRAY_SIZE], true), std::string());
+    }
+    auto [block_page, delta] = block_at(position);
+    if (!block_page->IsOccupied(offset)) {
+      ended = true;
+    } else if (!block_page->IsReadable(offset)) {
+      holes.push_back(position);
+    } else {
+      const KeyType key = block_page->KeyAt(offset);
+      const uint64_t hash_v = hash_fn_.GetHash(key);
+      const size_t probe_start = hash_v % num_blocks * BLOCK_ARRAY_SIZE + hash_v % BLOCK_ARRAY_SIZE;
+      const size_t distance = (position + capacity - probe_start) % capacity;
+      auto hole = std::find_if(holes.begin(), holes.end(), [&](size_t hole_position) {
+        return (position + capacity - hole_position) % capacity <= distance;
+      });
+      if (hole != holes.end()) {
+        const ValueType value = block_page->ValueAt(offset);
+        const uint8_t tag = block_page->TagAt(offset);
+        auto [hole_block_page, hole_delta] = block_at(*hole);
+        const auto hole_offset = static_cast<slot_offset_t>(*hole % BLOCK_ARRAY_SIZE);
+        *hole_delta += hole_block_page->InsertDelta(hole_offset, key, value, tag);
+        hole_block_page->Insert(hole_offset, key, value, tag);
+        *delta += block_page->RemoveDelta(offset);
+        block_page->Remove(offset);
+        holes.erase(hole);
+        holes.push_back(position);
+      }
+    }
+  }
+  // no pair passes the holes that are left, unless the run took the whole table, where probes end where they start
+  if (ended) {
+    for (size_t hole : holes) {
+      auto [block_page, delta] = block_at(hole);
+      *delta += block_page->FreeDelta(hole % BLOCK_ARRAY_SIZE);
+      block_page->Free(hole % BLOCK_ARRAY_SIZE);
+    }
+  }
+
+  for (auto &[block, delta] : blocks) {
+    if (!delta.empty()) {
+      lsn_t lsn = logPageChange(LogRecordType::HASH_REMOVE, block->GetPageId(), std::move(delta));
+      if (lsn != INVALID_LSN) {
+        reinterpret_cast<BlockPage *>(block->GetData())->SetLSN(lsn);
+      }
+    }
+    freeBlockPage(block, true, !delta.empty());
+  }
 }
 
 /*****************************************************************************
@@ -166,95 +784,134 @@ bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_TYPE::Resize(size_t initial_size) {
   table_latch_.WLock();
-  HashTableHeaderPage *header_page = loadHeaderPage(false, true);
-  if (header_page->NumBlocks() == 2 * initial_size) {
-    freePage(reinterpret_cast<Page *>(header_page), header_page_id_, false, true, false);
-    table_latch_.WUnlock();
-    return;
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    migrate(SIZE_MAX);
   }
+  if (block_page_ids_.size() < std::min(2 * initial_size, MAX_BLOCKS)) {
+    startResize(std::min(2 * initial_size, MAX_BLOCKS));
+  }
+  table_latch_.WUnlock();
+}
 
-  page_id_t page_idx = 0;
-  slot_offset_t offset = 0;
-
-  auto block_page = loadBlockPage(header_page, page_idx, false, true);
-  auto new_table = new LinearProbeHashTable("tmp", buffer_pool_manager_, comparator_, 2 * initial_size, hash_fn_);
-  do {
-    if (block_page->IsReadable(offset)) {
-      new_table->Insert(nullptr, block_page->KeyAt(offset), block_page->ValueAt(offset));
-    }
-    gotoNextPosition(header_page, &block_page, &page_idx, &offset, false, true);
-  } while (!(page_idx == 0 && offset == 0));
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::growing() {
+  return old_header_page_id_ != INVALID_PAGE_ID ||
+         (4 * size_ >= 3 * block_page_ids_.size() * BLOCK_ARRAY_SIZE && block_page_ids_.size() < MAX_BLOCKS);
+}
 
-  freePage(reinterpret_cast<Page *>(header_page), header_page_id_, false, true, false);
-  header_page_id_ = new_table->header_page_id_;
-  delete new_table;
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::growStep() {
+  table_latch_.WLock();
+  if (old_header_page_id_ == INVALID_PAGE_ID && growing()) {
+    startResize(std::min(2 * block_page_ids_.size(), MAX_BLOCKS));
+  }
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    migrate(MIGRATE_SLOTS);
+  }
   table_latch_.WUnlock();
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-HashTableHeaderPage *HASH_TABLE_TYPE::loadHeaderPage(bool wlock, bool rlock) {
-  Page *header = buffer_pool_manager_->FetchPage(header_page_id_);
-  if (header == nullptr) {
-    return nullptr;
+uint32_t HASH_TABLE_TYPE::groupSize(size_t page_idx, slot_offset_t offset, size_t ori_page_idx,
+                                   slot_offset_t ori_offset) {
+  uint32_t num_slots = std::min<uint32_t>(BlockPage::TAG_GROUP_SIZE, BLOCK_ARRAY_SIZE - offset);
+  if (page_idx == ori_page_idx && offset < ori_offset) {
+    // a probe that went around the whole table stops where it started
+    num_slots = std::min<uint32_t>(num_slots, ori_offset - offset);
   }
+  return num_slots;
+}
 
-  if (rlock) {
-    header->RLatch();
-  } else if (wlock) {
-    header->WLatch();
-  }
-  auto header_page = reinterpret_cast<HashTableHeaderPage *>(header->GetData());
-  return header_page;
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::startResize(size_t num_buckets) {
+  old_header_page_id_ = header_page_id_;
+  old_block_page_ids_.swap(block_page_ids_);
+  migrate_index_ = 0;
+  header_page_id_ = createTable(num_buckets, &block_page_ids_);
+  updateAnchor();
+  // the filter of the new table is built up by the migrated pairs and the new ones, the old one covers the rest
+  old_bloom_filter_ = std::move(bloom_filter_);
+  bloom_filter_ = newBloomFilter(num_buckets);
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-HashTableBlockPage<KeyType, ValueType, KeyComparator> *HASH_TABLE_TYPE::loadBlockPage(HashTableHeaderPage *header_page,
-                                                                                      size_t page_idx, bool wlock,
-                                                                                      bool rlock) {
-  page_id_t block_page_id = header_page->GetBlockPageId(page_idx);
-  Page *block = buffer_pool_manager_->FetchPage(block_page_id);
-  if (block == nullptr) {
-    return nullptr;
-  }
-  if (rlock) {
-    block->RLatch();
-  } else if (wlock) {
-    block->WLatch();
+void HASH_TABLE_TYPE::migrate(size_t num_slots) {
+  const size_t old_capacity = old_block_page_ids_.size() * BLOCK_ARRAY_SIZE;
+  const size_t end = num_slots < old_capacity - migrate_index_ ? migrate_index_ + num_slots : old_capacity;
+
+  while (migrate_index_ < end) {
+    page_id_t block_page_id = old_block_page_ids_[migrate_index_ / BLOCK_ARRAY_SIZE];
+    Page *block = fetchBlockPage(block_page_id, true);
+    auto block_page = reinterpret_cast<BlockPage *>(block->GetData());
+    bool dirty = false;
+    do {
+      auto offset = static_cast<slot_offset_t>(migrate_index_ % BLOCK_ARRAY_SIZE);
+      if (block_page->IsReadable(offset)) {
+        InsertResult result = insertPair(block_page_ids_, block_page->KeyAt(offset), block_page->ValueAt(offset), true);
+        BUSTUB_ASSERT(result == InsertResult::INSERTED, "The new table of a resize cannot fill up before the old one.");
+        removeSlot(block_page, block_page_id, offset);
+        dirty = true;
+      }
+      migrate_index_++;
+    } while (migrate_index_ < end && migrate_index_ % BLOCK_ARRAY_SIZE != 0);
+    freeBlockPage(block, true, dirty);
   }
 
-  auto block_page = reinterpret_cast<HashTableBlockPage<KeyType, ValueType, KeyComparator> *>(block->GetData());
-  return block_page;
+  if (migrate_index_ == old_capacity) {
+    page_id_t old_header_page_id = old_header_page_id_;
+    old_header_page_id_ = INVALID_PAGE_ID;
+    updateAnchor();
+    dropTable(old_header_page_id, old_block_page_ids_);
+    old_block_page_ids_.clear();
+    old_bloom_filter_.reset();
+  }
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::freePage(Page *page, page_id_t page_id, bool wlock, bool rlock, bool dirty) {
-  buffer_pool_manager_->UnpinPage(page_id, dirty);
-  if (rlock) {
-    page->RUnlatch();
-  } else if (wlock) {
-    page->WUnlatch();
+void HASH_TABLE_TYPE::staleBloomFilterPage() {
+  Page *page = buffer_pool_manager_->FetchPage(bloom_filter_page_id_);
+  auto filter_page = reinterpret_cast<BloomFilterPage *>(page->GetData());
+  std::string old_bytes(page->GetData(), sizeof(BloomFilterPage));
+  filter_page->SetOwnerPageId(INVALID_PAGE_ID);
+  // the filter pages themselves are not logged, only that they went stale
+  std::string delta;
+  PageDelta::Append(&delta, 0, old_bytes.data(), page->GetData(), old_bytes.size());
+  lsn_t lsn = logPageChange(LogRecordType::HASH_HEADER, bloom_filter_page_id_, std::move(delta));
+  if (lsn != INVALID_LSN) {
+    page->SetLSN(lsn);
   }
+  buffer_pool_manager_->UnpinPage(bloom_filter_page_id_, true);
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::gotoNextPosition(HashTableHeaderPage *header_page,
-                                       HashTableBlockPage<KeyType, ValueType, KeyComparator> **block_page_p,
-                                       page_id_t *page_id_p, slot_offset_t *offset_p, bool wlock, bool rlock) {
-  ++(*offset_p);
+lsn_t HASH_TABLE_TYPE::logPageChange(LogRecordType type, page_id_t page_id, std::string page_delta) {
+  if (!enable_logging || log_manager_ == nullptr) {
+    return INVALID_LSN;
+  }
+  // the change is not part of a transaction, recovery redoes it but never undoes it
+  LogRecord log_record(type, page_id, std::move(page_delta));
+  return log_manager_->AppendLogRecord(&log_record);
+}
 
-  if (*offset_p >= header_page->GetSize()) {
-    // finish this page, and turn into another page
-    freePage(reinterpret_cast<Page *>(*block_page_p), header_page->GetBlockPageId(*page_id_p), wlock, rlock, false);
-    ++(*page_id_p);
-    *offset_p = 0;
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *HASH_TABLE_TYPE::fetchBlockPage(page_id_t block_page_id, bool wlock) {
+  Page *block = buffer_pool_manager_->FetchPage(block_page_id);
+  if (wlock) {
+    block->WLatch();
+  } else {
+    block->RLatch();
+  }
+  return block;
+}
 
-    // search to end, rewind to start page
-    if (header_page->NumBlocks() == static_cast<size_t>(*page_id_p)) {
-      *page_id_p = 0;
-    }
-    // find next block to search the result
-    *block_page_p = loadBlockPage(header_page, *page_id_p, wlock, rlock);
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::freeBlockPage(Page *page, bool wlock, bool dirty) {
+  if (wlock) {
+    page->WUnlatch();
+  } else {
+    page->RUnlatch();
   }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), dirty);
 }
 
 /*****************************************************************************
@@ -265,6 +922,123 @@ size_t HASH_TABLE_TYPE::GetSize() {
   return size_.load();
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::EnableBloomFilter(size_t bits_per_key, page_id_t filter_page_id) {
+  table_latch_.WLock();
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    migrate(SIZE_MAX);
+  }
+  bloom_bits_per_key_ = bits_per_key;
+  bloom_filter_ = nullptr;
+  if (bits_per_key != 0 && filter_page_id != INVALID_PAGE_ID) {
+    // the pair count catches inserts whose marking of the filter pages did not reach the disk before a crash
+    bloom_filter_ = BloomFilter::Load(buffer_pool_manager_, filter_page_id, anchor_page_id_, size_.load());
+    bloom_filter_page_id_ = bloom_filter_ != nullptr ? filter_page_id : INVALID_PAGE_ID;
+    bloom_filter_page_current_ = bloom_filter_ != nullptr;
+  }
+  if (bits_per_key != 0 && bloom_filter_ == nullptr) {
+    bloom_filter_ = newBloomFilter(block_page_ids_.size());
+    for (page_id_t block_page_id : block_page_ids_) {
+      Page *block = fetchBlockPage(block_page_id, false);
+      auto block_page = reinterpret_cast<BlockPage *>(block->GetData());
+      for (slot_offset_t offset = 0; offset < BLOCK_ARRAY_SIZE; offset++) {
+        if (block_page->IsReadable(offset)) {
+          bloom_filter_->Add(hash_fn_.GetHash(block_page->KeyAt(offset)));
+        }
+      }
+      freeBlockPage(block, false, false);
+    }
+  }
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+page_id_t HASH_TABLE_TYPE::PersistBloomFilter() {
+  table_latch_.WLock();
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    migrate(SIZE_MAX);
+  }
+  if (bloom_filter_page_id_ != INVALID_PAGE_ID) {
+    BloomFilter::Drop(buffer_pool_manager_, bloom_filter_page_id_);
+  }
+  bloom_filter_page_id_ = bloom_filter_ != nullptr
+                             ? bloom_filter_->Persist(buffer_pool_manager_, anchor_page_id_, size_.load())
+                             : INVALID_PAGE_ID;
+  bloom_filter_page_current_ = bloom_filter_ != nullptr;
+  page_id_t filter_page_id = bloom_filter_page_id_;
+  table_latch_.WUnlock();
+  return filter_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::Drop() {
+  table_latch_.WLock();
+  dropTable(header_page_id_, block_page_ids_);
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    dropTable(old_header_page_id_, old_block_page_ids_);
+  }
+  if (bloom_filter_page_id_ != INVALID_PAGE_ID) {
+    BloomFilter::Drop(buffer_pool_manager_, bloom_filter_page_id_);
+  }
+  buffer_pool_manager_->DeletePage(anchor_page_id_);
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+std::unique_ptr<BloomFilter> HASH_TABLE_TYPE::newBloomFilter(size_t num_blocks) {
+  if (bloom_bits_per_key_ == 0) {
+    return nullptr;
+  }
+  // sized for the pairs at which the table grows
+  return std::make_unique<BloomFilter>(3 * num_blocks * BLOCK_ARRAY_SIZE / 4, bloom_bits_per_key_);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::ProbeLengths(double *hit_length, double *miss_length) {
+  table_latch_.WLock();
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    migrate(SIZE_MAX);
+  }
+  const size_t capacity = block_page_ids_.size() * BLOCK_ARRAY_SIZE;
+  std::vector<bool> occupied(capacity);
+  size_t hit_slots = 0;
+  size_t num_pairs = 0;
+  for (size_t page_idx = 0; page_idx < block_page_ids_.size(); page_idx++) {
+    Page *block = fetchBlockPage(block_page_ids_[page_idx], false);
+    auto block_page = reinterpret_cast<BlockPage *>(block->GetData());
+    for (slot_offset_t offset = 0; offset < BLOCK_ARRAY_SIZE; offset++) {
+      const size_t position = page_idx * BLOCK_ARRAY_SIZE + offset;
+      occupied[position] = block_page->IsOccupied(offset);
+      if (block_page->IsReadable(offset)) {
+        const uint64_t hash_v = hash_fn_.GetHash(block_page->KeyAt(offset));
+        const size_t start = hash_v % block_page_ids_.size() * BLOCK_ARRAY_SIZE + hash_v % BLOCK_ARRAY_SIZE;
+        hit_slots += (position + capacity - start) % capacity + 1;
+        num_pairs++;
+      }
+    }
+    freeBlockPage(block, false, false);
+  }
+  table_latch_.WUnlock();
+
+  // a miss probes the run of occupied slots from its start on and the unoccupied slot after it, walking the slots
+  // backwards twice counts the runs that wrap around
+  size_t miss_slots = 0;
+  size_t run = 0;
+  for (size_t i = 2 * capacity; i-- > 0;) {
+    run = occupied[i % capacity] ? std::min(run + 1, capacity) : 0;
+    if (i < capacity) {
+      miss_slots += std::min(run + 1, capacity);
+    }
+  }
+  *hit_length = num_pairs == 0 ? 0 : static_cast<double>(hit_slots) / num_pairs;
+  *miss_length = static_cast<double>(miss_slots) / capacity;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+page_id_t HASH_TABLE_TYPE::GetAnchorPageId() {
+  return anchor_page_id_;
+}
+
 template class LinearProbeHashTable<int, int, IntComparator>;
 
 template class LinearProbeHashTable<GenericKey<4>, RID, GenericComparator<4>>;
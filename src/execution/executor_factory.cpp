@@ -18,7 +18,9 @@
 #include "execution/executors/abstract_executor.h"
 #include "execution/executors/aggregation_executor.h"
 #include "execution/executors/hash_join_executor.h"
+#include "execution/executors/index_scan_executor.h"
 #include "execution/executors/insert_executor.h"
+#include "execution/executors/nested_index_join_executor.h"
 #include "execution/executors/seq_scan_executor.h"
 
 namespace bustub {
@@ -30,6 +32,11 @@ std::unique_ptr<AbstractExecutor> ExecutorFactory::CreateExecutor(ExecutorContex
       return std::make_unique<SeqScanExecutor>(exec_ctx, dynamic_cast<const SeqScanPlanNode *>(plan));
     }
 
+    // Create a new index scan executor.
+    case PlanType::IndexScan: {
+      return std::make_unique<IndexScanExecutor>(exec_ctx, dynamic_cast<const IndexScanPlanNode *>(plan));
+    }
+
     // Create a new insert executor.
     case PlanType::Insert: {
       auto insert_plan = dynamic_cast<const InsertPlanNode *>(plan);
@@ -47,6 +54,13 @@ std::unique_ptr<AbstractExecutor> ExecutorFactory::CreateExecutor(ExecutorContex
                                                 std::move(right_executor));
     }
 
+    // Create a new index nested loop join executor.
+    case PlanType::NestedIndexJoin: {
+      auto join_plan = dynamic_cast<const NestedIndexJoinPlanNode *>(plan);
+      auto outer_executor = ExecutorFactory::CreateExecutor(exec_ctx, join_plan->GetOuterPlan());
+      return std::make_unique<NestedIndexJoinExecutor>(exec_ctx, join_plan, std::move(outer_executor));
+    }
+
     // Create a new aggregation executor.
     case PlanType::Aggregation: {
       auto agg_plan = dynamic_cast<const AggregationPlanNode *>(plan);
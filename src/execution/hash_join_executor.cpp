@@ -40,15 +40,15 @@ void HashJoinExecutor::Init() {
     // insert tuple to get tmp_tuple
     if (first) {
       first = false;
-      bfm->NewPage(&cur_page_id);
-      cur_page = reinterpret_cast<TmpTuplePage *>(bfm->FetchPage(cur_page_id));
+      cur_page = reinterpret_cast<TmpTuplePage *>(bfm->NewPage(&cur_page_id));
       cur_page->Init(cur_page_id, PAGE_SIZE);
     }
 
     if (!cur_page->Insert(tuple, &tmp_tuple)) {
-      // current page is enough, turn to next page
-      bfm->NewPage(&cur_page_id);
-      cur_page = reinterpret_cast<TmpTuplePage *>(bfm->FetchPage(cur_page_id));
+      // current page is enough, turn to next page. Only the page being filled stays pinned, so that the build side
+      // may be larger than the buffer pool
+      bfm->UnpinPage(cur_page_id, true);
+      cur_page = reinterpret_cast<TmpTuplePage *>(bfm->NewPage(&cur_page_id));
       cur_page->Init(cur_page_id, PAGE_SIZE);
       cur_page->Insert(tuple, &tmp_tuple);
     }
@@ -56,6 +56,9 @@ void HashJoinExecutor::Init() {
     auto hash_key = HashValues(&tuple, left_->GetOutputSchema(), plan_->GetLeftKeys());
     jht_.Insert(trans, hash_key, tmp_tuple);
   }
+  if (!first) {
+    bfm->UnpinPage(cur_page_id, true);
+  }
 
   right_->Init();
 }
@@ -103,6 +106,7 @@ bool HashJoinExecutor::Next(Tuple *tuple) {
     auto tmp_tuple = tuples[htk_idx_];
     auto cur_page = reinterpret_cast<TmpTuplePage *>(bfm->FetchPage(tmp_tuple.GetPageId()));
     cur_page->Get(&tmp_tuple, &left_tuple);
+    bfm->UnpinPage(tmp_tuple.GetPageId(), false);
 
     // generate output
     const Schema *schema = plan_->OutputSchema();
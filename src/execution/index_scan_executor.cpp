@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_scan_executor.cpp
+//
+// Identification: src/execution/index_scan_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include "execution/executors/index_scan_executor.h"
+
+#include <algorithm>
+#include <memory>
+
+namespace bustub {
+
+IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan) {
+  auto catalog = exec_ctx_->GetCatalog();
+  index_info_ = catalog->GetIndex(plan_->GetIndexOid());
+  table_meta_ = catalog->GetTable(index_info_->table_name_);
+}
+
+void IndexScanExecutor::Init() {
+  rids_.clear();
+  next_rid_ = 0;
+  if (plan_->IsPointLookup()) {
+    key_ = Tuple(plan_->GetKey(), &index_info_->key_schema_);
+    index_info_->index_->ScanKey(key_, &rids_, exec_ctx_->GetTransaction());
+    // the entries of a key have no order of their own, sorted by page the tuples of a page are fetched in a row
+    std::sort(rids_.begin(), rids_.end());
+    return;
+  }
+
+  // the rids are collected up front, an open leaf latch would block writers of the same transaction
+  std::unique_ptr<Tuple> low_key;
+  std::unique_ptr<Tuple> high_key;
+  if (!plan_->GetLowKey().empty()) {
+    low_key = std::make_unique<Tuple>(plan_->GetLowKey(), &index_info_->key_schema_);
+  }
+  if (!plan_->GetHighKey().empty()) {
+    high_key = std::make_unique<Tuple>(plan_->GetHighKey(), &index_info_->key_schema_);
+  }
+  index_info_->index_->ScanRange(low_key.get(), high_key.get(), &rids_, exec_ctx_->GetTransaction());
+}
+
+bool IndexScanExecutor::Next(Tuple *tuple) {
+  auto predicate = plan_->GetPredicate();
+  const Schema *schema = plan_->OutputSchema();
+  while (next_rid_ < rids_.size()) {
+    Tuple table_tuple;
+    if (!table_meta_->table_->GetTuple(rids_[next_rid_++], &table_tuple, exec_ctx_->GetTransaction())) {
+      continue;
+    }
+    if (plan_->IsPointLookup() && !index_info_->index_->HasKey(key_, table_tuple, table_meta_->schema_)) {
+      continue;
+    }
+    if (predicate != nullptr && !predicate->Evaluate(&table_tuple, &table_meta_->schema_).GetAs<bool>()) {
+      continue;
+    }
+
+    if (schema != nullptr) {
+      std::vector<Value> res;
+      for (auto &col : schema->GetColumns()) {
+        res.push_back(col.GetExpr()->Evaluate(&table_tuple, &table_meta_->schema_));
+      }
+      *tuple = Tuple(res, schema);
+    } else {
+      *tuple = table_tuple;
+    }
+    return true;
+  }
+  return false;
+}
+
+}  // namespace bustub
@@ -24,15 +24,17 @@ InsertExecutor::InsertExecutor(ExecutorContext *exec_ctx, const InsertPlanNode *
 
 const Schema *InsertExecutor::GetOutputSchema() { return plan_->OutputSchema(); }
 
-void InsertExecutor::Init() {}
+void InsertExecutor::Init() {
+  // the indexes of the table take the new tuples as well
+  indexes_ = exec_ctx_->GetCatalog()->GetTableIndexes(table_meta_->name_);
+}
 
 bool InsertExecutor::Next([[maybe_unused]] Tuple *tuple) {
-  RID rid;
   bool res;
   if (plan_->IsRawInsert()) {
     for (auto &item : plan_->RawValues()) {
       auto insert_tuple = Tuple(item, &table_meta_->schema_);
-      res = table_meta_->table_->InsertTuple(insert_tuple, &rid, exec_ctx_->GetTransaction());
+      res = insertTuple(insert_tuple);
       if (!res) {
         return false;
       }
@@ -40,7 +42,7 @@ bool InsertExecutor::Next([[maybe_unused]] Tuple *tuple) {
   } else if (child_executor_) {
     Tuple insert_tuple;
     while (child_executor_->Next(&insert_tuple)) {
-      res = table_meta_->table_->InsertTuple(insert_tuple, &rid, exec_ctx_->GetTransaction());
+      res = insertTuple(insert_tuple);
       if (!res) {
         return false;
       }
@@ -49,4 +51,27 @@ bool InsertExecutor::Next([[maybe_unused]] Tuple *tuple) {
   return true;
 }
 
+bool InsertExecutor::insertTuple(const Tuple &tuple) {
+  RID rid;
+  if (!table_meta_->table_->InsertTuple(tuple, &rid, exec_ctx_->GetTransaction())) {
+    return false;
+  }
+  // the entries are recorded in the transaction, an abort takes them out before it deletes the tuple
+  auto index_write_set = exec_ctx_->GetTransaction()->GetIndexWriteSet();
+  for (size_t i = 0; i < indexes_.size(); i++) {
+    Index *index = indexes_[i]->index_.get();
+    Tuple key = tuple.KeyFromTuple(table_meta_->schema_, indexes_[i]->key_schema_, index->GetKeyAttrs());
+    if (!index->InsertEntry(key, rid, exec_ctx_->GetTransaction())) {
+      // the entries of the earlier indexes would point at a tuple the caller rolls back
+      for (size_t j = 0; j < i; j++) {
+        index_write_set->back().index_->DeleteEntry(index_write_set->back().key_, rid, exec_ctx_->GetTransaction());
+        index_write_set->pop_back();
+      }
+      return false;
+    }
+    index_write_set->emplace_back(rid, WType::INSERT, key, index);
+  }
+  return true;
+}
+
 }  // namespace bustub
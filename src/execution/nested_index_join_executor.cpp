@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// nested_index_join_executor.cpp
+//
+// Identification: src/execution/nested_index_join_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include "execution/executors/nested_index_join_executor.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+NestedIndexJoinExecutor::NestedIndexJoinExecutor(ExecutorContext *exec_ctx, const NestedIndexJoinPlanNode *plan,
+                                                 std::unique_ptr<AbstractExecutor> &&outer)
+    : AbstractExecutor(exec_ctx), plan_(plan), outer_(std::move(outer)) {
+  auto catalog = exec_ctx_->GetCatalog();
+  index_info_ = catalog->GetIndex(plan_->GetIndexOid());
+  inner_table_ = catalog->GetTable(index_info_->table_name_);
+}
+
+void NestedIndexJoinExecutor::Init() {
+  outer_->Init();
+  outer_tuples_.clear();
+  outer_keys_.clear();
+  inner_rids_.clear();
+  outer_idx_ = 0;
+  rid_idx_ = 0;
+}
+
+bool NestedIndexJoinExecutor::nextBatch() {
+  outer_tuples_.clear();
+  outer_keys_.clear();
+  outer_idx_ = 0;
+  rid_idx_ = 0;
+  const Schema *outer_schema = outer_->GetOutputSchema();
+  const Schema &key_schema = index_info_->key_schema_;
+  Tuple tuple;
+  while (outer_tuples_.size() < BATCH_SIZE && outer_->Next(&tuple)) {
+    std::vector<Value> values;
+    bool has_null = false;
+    for (uint32_t i = 0; i < plan_->GetOuterKeys().size(); i++) {
+      Value value = plan_->GetOuterKeys()[i]->Evaluate(&tuple, outer_schema);
+      if (value.IsNull()) {
+        has_null = true;
+        break;
+      }
+      // the key is serialized with the types of the index, which those of the outer columns need not match
+      values.push_back(value.CastAs(key_schema.GetColumn(i).GetType()));
+    }
+    if (has_null) {
+      continue;
+    }
+    outer_keys_.emplace_back(values, &key_schema);
+    outer_tuples_.push_back(tuple);
+  }
+  if (outer_tuples_.empty()) {
+    return false;
+  }
+
+  inner_rids_.clear();
+  index_info_->index_->ScanKeys(outer_keys_, &inner_rids_, exec_ctx_->GetTransaction());
+  // the tuples of a page are fetched in a row
+  for (auto &rids : inner_rids_) {
+    std::sort(rids.begin(), rids.end());
+  }
+  return true;
+}
+
+bool NestedIndexJoinExecutor::Next(Tuple *tuple) {
+  auto predicate = plan_->Predicate();
+  const Schema *outer_schema = outer_->GetOutputSchema();
+  const Schema *inner_schema = &inner_table_->schema_;
+  Tuple inner_tuple;
+  do {
+    for (; outer_idx_ < outer_tuples_.size(); outer_idx_++, rid_idx_ = 0) {
+      const Tuple &outer_tuple = outer_tuples_[outer_idx_];
+      const std::vector<RID> &rids = inner_rids_[outer_idx_];
+      while (rid_idx_ < rids.size()) {
+        if (!inner_table_->table_->GetTuple(rids[rid_idx_++], &inner_tuple, exec_ctx_->GetTransaction())) {
+          continue;
+        }
+        // an entry may point at a tuple that does not have its key, e.g. one that took the slot of the tuple
+        if (!index_info_->index_->HasKey(outer_keys_[outer_idx_], inner_tuple, *inner_schema)) {
+          continue;
+        }
+        if (predicate != nullptr &&
+            !predicate->EvaluateJoin(&outer_tuple, outer_schema, &inner_tuple, inner_schema).GetAs<bool>()) {
+          continue;
+        }
+
+        std::vector<Value> res;
+        for (auto &col : plan_->OutputSchema()->GetColumns()) {
+          res.push_back(col.GetExpr()->EvaluateJoin(&outer_tuple, outer_schema, &inner_tuple, inner_schema));
+        }
+        *tuple = Tuple(res, plan_->OutputSchema());
+        return true;
+      }
+    }
+  } while (nextBatch());
+  return false;
+}
+
+}  // namespace bustub
@@ -15,6 +15,7 @@
 #include <list>
 #include <mutex>  // NOLINT
 #include <unordered_map>
+#include <vector>
 
 #include "buffer/clock_replacer.h"
 #include "recovery/log_manager.h"
@@ -97,6 +98,13 @@ class BufferPoolManager {
   /** @return size of the buffer pool */
   size_t GetPoolSize() { return pool_size_; }
 
+  /**
+   * Collects the pages that may have changes not written to disk yet, for a checkpoint. A page is in the table from
+   * the moment it is pinned while clean until it is written out, so changes in progress are not missed.
+   * @return the dirty page table with the recLSN of every page
+   */
+  std::vector<DirtyPageEntry> GetDirtyPageTable();
+
  protected:
   /**
    * Grading function. Do not modify!
@@ -152,6 +160,28 @@ class BufferPoolManager {
    */
   void FlushAllPagesImpl();
 
+  /**
+   * Picks a frame for a new page from the free list, or evicts a victim page and writes it back if it is dirty.
+   * The caller must hold latch_.
+   * @param[out] frame_id the frame that can be reused, it is not in the page table anymore
+   * @return false if all frames are pinned
+   */
+  bool FindVictimFrame(frame_id_t *frame_id);
+
+  /**
+   * Writes the page in the frame back to disk after the log records up to its LSN are persistent.
+   * The caller must hold latch_.
+   * @param frame_id the frame of the page to be written
+   */
+  void FlushFrame(frame_id_t frame_id);
+
+  /**
+   * Remembers the position of the next log record as the recLSN of the page, unless the page has one already.
+   * The caller must hold latch_.
+   * @param page the page that has just been pinned
+   */
+  void SetRecLSN(Page *page);
+
   /** Number of pages in the buffer pool. */
   size_t pool_size_;
   /** Array of buffer pool pages. */
@@ -166,7 +196,7 @@ class BufferPoolManager {
   Replacer *replacer_;
   /** List of free pages. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /** This latch protects the page table, the free list, the replacer and the book-keeping of every frame. */
   std::mutex latch_;
 };
 }  // namespace bustub
@@ -1,13 +1,18 @@
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
+#include "container/hash/hash_function.h"
+#include "storage/index/b_plus_tree_index.h"
 #include "storage/index/index.h"
+#include "storage/index/linear_probe_hash_table_index.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
@@ -17,6 +22,7 @@ namespace bustub {
  */
 using table_oid_t = uint32_t;
 using column_oid_t = uint32_t;
+using index_oid_t = uint32_t;
 
 /**
  * Metadata about a table.
@@ -30,9 +36,29 @@ struct TableMetadata {
   table_oid_t oid_;
 };
 
+/**
+ * Metadata about an index.
+ */
+struct IndexInfo {
+  IndexInfo(Schema key_schema, std::string name, std::unique_ptr<Index> &&index, index_oid_t index_oid,
+            std::string table_name, size_t key_size)
+      : key_schema_(std::move(key_schema)),
+        name_(std::move(name)),
+        index_(std::move(index)),
+        index_oid_(index_oid),
+        table_name_(std::move(table_name)),
+        key_size_(key_size) {}
+  Schema key_schema_;
+  std::string name_;
+  std::unique_ptr<Index> index_;
+  index_oid_t index_oid_;
+  std::string table_name_;
+  const size_t key_size_;
+};
+
 /**
  * SimpleCatalog is a non-persistent catalog that is designed for the executor to use.
- * It handles table creation and table lookup.
+ * It handles table and index creation and lookup.
  */
 class SimpleCatalog {
  public:
@@ -86,7 +112,122 @@ class SimpleCatalog {
     return table_iter == tables_.end() ? nullptr : (table_iter->second).get();
   }
 
+  /**
+   * Create a new B+ tree index on a table, filled with the tuples the table has, and return its metadata.
+   * @param txn the transaction in which the index is being created
+   * @param index_name the name of the new index
+   * @param table_name the name of the table
+   * @param schema the schema of the table
+   * @param key_schema the schema of the key
+   * @param key_attrs the columns of the key in the table
+   * @param key_size the size of KeyType
+   * @return a pointer to the metadata of the new index, nullptr if the key of a tuple does not fit into KeyType
+   */
+  template <class KeyType, class ValueType, class KeyComparator>
+  IndexInfo *CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
+                         const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs,
+                         size_t key_size) {
+    auto metadata = new IndexMetadata(index_name, table_name, &schema, key_attrs);
+    auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(metadata, bpm_);
+    return addIndex(txn, std::move(index), table_name, schema, key_schema, key_attrs, key_size);
+  }
+
+  /**
+   * Create a new linear probe hash index on a table, filled with the tuples the table has, and return its metadata.
+   * The index answers equality lookups only.
+   * @param txn the transaction in which the index is being created
+   * @param index_name the name of the new index
+   * @param table_name the name of the table
+   * @param schema the schema of the table
+   * @param key_schema the schema of the key
+   * @param key_attrs the columns of the key in the table
+   * @param key_size the size of KeyType
+   * @param num_buckets the initial number of blocks of the hash table, it grows as it fills up
+   * @return a pointer to the metadata of the new index, nullptr if the index has no room for all tuples of the table
+   *         or the key of a tuple does not fit into KeyType
+   */
+  template <class KeyType, class ValueType, class KeyComparator>
+  IndexInfo *CreateHashIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
+                             const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs,
+                             size_t key_size, size_t num_buckets) {
+    auto metadata = new IndexMetadata(index_name, table_name, &schema, key_attrs);
+    auto index = std::make_unique<LinearProbeHashTableIndex<KeyType, ValueType, KeyComparator>>(
+        metadata, bpm_, num_buckets, HashFunction<KeyType>(), log_manager_);
+    return addIndex(txn, std::move(index), table_name, schema, key_schema, key_attrs, key_size);
+  }
+
+  /** @return index metadata by oid, nullptr if there is no such index */
+  IndexInfo *GetIndex(index_oid_t index_oid) {
+    catalog_latch_.RLock();
+    auto index_iter = indexes_.find(index_oid);
+    IndexInfo *index_info = index_iter == indexes_.end() ? nullptr : (index_iter->second).get();
+    catalog_latch_.RUnlock();
+    return index_info;
+  }
+
+  /** @return index metadata by index and table name, nullptr if there is no such index */
+  IndexInfo *GetIndex(const std::string &index_name, const std::string &table_name) {
+    catalog_latch_.RLock();
+    IndexInfo *index_info = nullptr;
+    auto table_iter = index_names_.find(table_name);
+    if (table_iter != index_names_.end()) {
+      auto name_iter = table_iter->second.find(index_name);
+      if (name_iter != table_iter->second.end()) {
+        index_info = indexes_[name_iter->second].get();
+      }
+    }
+    catalog_latch_.RUnlock();
+    return index_info;
+  }
+
+  /** @return the metadata of all indexes on a table, in the order they were created */
+  std::vector<IndexInfo *> GetTableIndexes(const std::string &table_name) {
+    std::vector<IndexInfo *> index_infos;
+    catalog_latch_.RLock();
+    auto table_iter = index_names_.find(table_name);
+    if (table_iter != index_names_.end()) {
+      for (const auto &[name, index_oid] : table_iter->second) {
+        index_infos.push_back(indexes_[index_oid].get());
+      }
+    }
+    catalog_latch_.RUnlock();
+    std::sort(index_infos.begin(), index_infos.end(),
+              [](const IndexInfo *lhs, const IndexInfo *rhs) { return lhs->index_oid_ < rhs->index_oid_; });
+    return index_infos;
+  }
+
  private:
+  /**
+   * Fills a new index with the tuples of its table and registers it under the name in its metadata. An index that
+   * misses some of the tuples, for lack of room or as their keys do not fit, is not registered, lookups through it
+   * would not find them.
+   */
+  IndexInfo *addIndex(Transaction *txn, std::unique_ptr<Index> &&index, const std::string &table_name,
+                      const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs,
+                      size_t key_size) {
+    TableMetadata *table = GetTable(table_name);
+    // the index is built from all entries at once rather than by inserting them one by one
+    std::vector<std::pair<Tuple, RID>> entries;
+    for (auto iter = table->table_->Begin(txn); iter != table->table_->End(); ++iter) {
+      entries.emplace_back(iter->KeyFromTuple(schema, key_schema, key_attrs), iter->GetRid());
+    }
+    if (!index->BulkLoad(entries, txn)) {
+      index->Drop(txn);
+      return nullptr;
+    }
+
+    std::string index_name = index->GetName();
+    catalog_latch_.WLock();
+    BUSTUB_ASSERT(index_names_[table_name].count(index_name) == 0, "Index names should be unique per table!");
+    index_oid_t index_oid = next_index_oid_++;
+    index_names_[table_name][index_name] = index_oid;
+    indexes_[index_oid] =
+        std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name, key_size);
+    IndexInfo *index_info = indexes_[index_oid].get();
+    catalog_latch_.WUnlock();
+    return index_info;
+  }
+
   [[maybe_unused]] BufferPoolManager *bpm_;
   [[maybe_unused]] LockManager *lock_manager_;
   [[maybe_unused]] LogManager *log_manager_;
@@ -97,6 +238,12 @@ class SimpleCatalog {
   std::unordered_map<std::string, table_oid_t> names_;
   /** The next table identifier to be used. */
   std::atomic<table_oid_t> next_table_oid_{0};
+  /** indexes_: index identifiers -> index metadata. Note that indexes_ owns all index metadata. */
+  std::unordered_map<index_oid_t, std::unique_ptr<IndexInfo>> indexes_;
+  /** index_names_: table name -> index names -> index identifiers */
+  std::unordered_map<std::string, std::unordered_map<std::string, index_oid_t>> index_names_;
+  /** The next index identifier to be used. */
+  std::atomic<index_oid_t> next_index_oid_{0};
 
   ReaderWriterLatch catalog_latch_;
 };
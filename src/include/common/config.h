@@ -34,6 +34,9 @@ static constexpr int HEADER_PAGE_ID = 0;                                      //
 static constexpr int PAGE_SIZE = 4096;                                        // size of a data page in byte
 static constexpr int BUFFER_POOL_SIZE = 10;                                   // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * PAGE_SIZE);  // size of a log buffer in byte
+static constexpr int LOG_BUFFER_COUNT = 4;                                    // number of log buffers in the ring
+static constexpr int LOG_SEGMENT_SIZE = 64 * LOG_BUFFER_SIZE;                 // size of a log segment file in byte
+static constexpr int LOG_READ_SIZE = 64 * LOG_BUFFER_SIZE;                    // size of a log read in recovery in byte
 static constexpr int BUCKET_SIZE = 50;                                        // size of extendible hash bucket
 
 using frame_id_t = int32_t;    // frame id type
@@ -60,6 +60,11 @@ class RID {
 
   bool operator==(const RID &other) const { return page_id_ == other.page_id_ && slot_num_ == other.slot_num_; }
 
+  /** Orders rids by page and then by slot, e.g. to keep the entries of equal keys in an index in order. */
+  bool operator<(const RID &other) const {
+    return page_id_ < other.page_id_ || (page_id_ == other.page_id_ && slot_num_ < other.slot_num_);
+  }
+
  private:
   page_id_t page_id_{INVALID_PAGE_ID};
   uint32_t slot_num_{0};  // logical offset from 0, 1...
@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compression_util.h
+//
+// Identification: src/include/common/util/compression_util.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+namespace bustub {
+
+/**
+ * CompressionUtil is a small LZ77 block compressor in the style of LZ4, fast enough to run on every log flush.
+ *
+ * A compressed block is a sequence of:
+ * -------------------------------------------------------------------------------
+ * | token | literal length* | literals | match offset (2) | match length* |
+ * -------------------------------------------------------------------------------
+ * The high 4 bits of the token are the number of literals, the low 4 bits the match length minus MIN_MATCH. A length
+ * of 15 continues in the following bytes (*), each adding up to 255. The last sequence only has literals.
+ */
+class CompressionUtil {
+ public:
+  /** Shortest repetition that is encoded as a match. */
+  static constexpr int MIN_MATCH = 4;
+  /** Farthest back a match may start. */
+  static constexpr int MAX_OFFSET = 65535;
+
+  /**
+   * Compresses a block.
+   * @param src the bytes to compress
+   * @param size number of bytes at src
+   * @param[out] dst the compressed block
+   * @param capacity number of bytes available at dst
+   * @return size of the compressed block, 0 if it does not fit into capacity
+   */
+  static int Compress(const char *src, int size, char *dst, int capacity);
+
+  /**
+   * Decompresses a block returned by Compress.
+   * @param src the compressed block
+   * @param size size of the compressed block
+   * @param[out] dst the decompressed bytes
+   * @param raw_size number of bytes the block decompresses to
+   * @return false if the block is corrupt
+   */
+  static bool Decompress(const char *src, int size, char *dst, int raw_size);
+};
+
+}  // namespace bustub
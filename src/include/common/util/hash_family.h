@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_family.h
+//
+// Identification: src/include/common/util/hash_family.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#ifdef __SSE4_2__
+#include <nmmintrin.h>
+#endif
+
+#include "murmur3/MurmurHash3.h"
+
+namespace bustub {
+
+/**
+ * Hash families hash a byte range to 64 bits with a static Hash(data, length). The hash tables take the slot from the
+ * hash modulo their size and a tag from its top byte, so every family spreads its entropy over all 64 bits.
+ *
+ * The functions are inline, so that a call with a constant length, e.g. sizeof of a key type, compiles to the few
+ * instructions that length needs.
+ */
+
+/** 128 bit MurmurHash3, of which the lower half is used. */
+struct MurmurHashFamily {
+  static inline uint64_t Hash(const void *data, size_t length) {
+    uint64_t hash[2];
+    murmur3::MurmurHash3_x64_128(data, static_cast<int>(length), 0, reinterpret_cast<void *>(&hash));
+    return hash[0];
+  }
+};
+
+/** wyhash style: the input is folded with 64 x 64 -> 128 bit multiplications, 16 bytes per round. */
+struct WyHashFamily {
+  static constexpr uint64_t P0 = 0xa0761d6478bd642fULL;
+  static constexpr uint64_t P1 = 0xe7037ed1a0b428dbULL;
+
+  /** @return the upper and the lower half of the product, xored */
+  static inline uint64_t Mum(uint64_t a, uint64_t b) {
+    __uint128_t product = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+  }
+
+  static inline uint64_t Read(const uint8_t *p, size_t width) {
+    uint64_t word = 0;
+    memcpy(&word, p, width);
+    return word;
+  }
+
+  static inline uint64_t Hash(const void *data, size_t length) {
+    auto p = static_cast<const uint8_t *>(data);
+    uint64_t seed = P0;
+    uint64_t a;
+    uint64_t b;
+    if (length <= 16) {
+      if (length >= 4) {
+        // two overlapping reads from each end cover 4 to 16 bytes
+        const size_t shift = (length >> 3) << 2;
+        a = (Read(p, 4) << 32) | Read(p + shift, 4);
+        b = (Read(p + length - 4, 4) << 32) | Read(p + length - 4 - shift, 4);
+      } else if (length > 0) {
+        a = (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[length >> 1]) << 8) | p[length - 1];
+        b = 0;
+      } else {
+        a = b = 0;
+      }
+    } else {
+      size_t rest = length;
+      for (; rest > 16; rest -= 16, p += 16) {
+        seed = Mum(Read(p, 8) ^ P1, Read(p + 8, 8) ^ seed);
+      }
+      a = Read(p + rest - 16, 8);
+      b = Read(p + rest - 8, 8);
+    }
+    return Mum(P1 ^ length, Mum(a ^ P1, b ^ seed));
+  }
+};
+
+#ifdef __SSE4_2__
+/**
+ * The CRC32-C instruction, 8 bytes per cycle. The 32 bit checksum is multiplied out over the upper bits, which still
+ * leaves 32 bits of entropy: good for tables that compare the keys, not for hashes that stand in for keys.
+ */
+struct Crc32HashFamily {
+  static inline uint64_t Hash(const void *data, size_t length) {
+    auto p = static_cast<const uint8_t *>(data);
+    uint64_t crc = 0;
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+      uint64_t word;
+      memcpy(&word, p + i, sizeof(word));
+      crc = _mm_crc32_u64(crc, word);
+    }
+    if (i + 4 <= length) {
+      uint32_t word;
+      memcpy(&word, p + i, sizeof(word));
+      crc = _mm_crc32_u32(static_cast<uint32_t>(crc), word);
+      i += 4;
+    }
+    for (; i < length; i++) {
+      crc = _mm_crc32_u8(static_cast<uint32_t>(crc), p[i]);
+    }
+    // the length tells apart inputs of zeros, which all have a checksum of 0
+    return ((crc << 32 | crc) ^ length) * 0x9e3779b97f4a7c15ULL;
+  }
+};
+#endif
+
+/** Takes the first 8 bytes as the hash, for keys that are hashes already. */
+struct IdentityHashFamily {
+  static inline uint64_t Hash(const void *data, size_t length) {
+    uint64_t hash = 0;
+    memcpy(&hash, data, length < sizeof(hash) ? length : sizeof(hash));
+    return hash;
+  }
+};
+
+/**
+ * The hash family that is used unless a key type picks another one, selected at compile time with
+ * -DBUSTUB_HASH_FAMILY=<family>.
+ */
+#ifndef BUSTUB_HASH_FAMILY
+#ifdef __SSE4_2__
+#define BUSTUB_HASH_FAMILY Crc32HashFamily
+#else
+#define BUSTUB_HASH_FAMILY WyHashFamily
+#endif
+#endif
+
+using DefaultHashFamily = BUSTUB_HASH_FAMILY;
+
+}  // namespace bustub
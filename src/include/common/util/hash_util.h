@@ -18,6 +18,7 @@
 #include <string>
 
 #include "common/macros.h"
+#include "common/util/hash_family.h"
 #include "type/value.h"
 
 namespace bustub {
@@ -30,12 +31,8 @@ class HashUtil {
 
  public:
   static inline hash_t HashBytes(const char *bytes, size_t length) {
-    // https://github.com/greenplum-db/gpos/blob/b53c1acd6285de94044ff91fbee91589543feba1/libgpos/src/utils.cpp#L126
-    hash_t hash = length;
-    for (size_t i = 0; i < length; ++i) {
-      hash = ((hash << 5) ^ (hash >> 27)) ^ bytes[i];
-    }
-    return hash;
+    // a join key is such a hash, the join hash table finds its tuples by the hash alone, so it needs all 64 bits
+    return WyHashFamily::Hash(bytes, length);
   }
 
   static inline hash_t CombineHashes(hash_t l, hash_t r) {
@@ -42,6 +42,7 @@ enum class TransactionState { GROWING, SHRINKING, COMMITTED, ABORTED };
 enum class WType { INSERT = 0, DELETE, UPDATE };
 
 class TableHeap;
+class Index;
 
 /**
  * WriteRecord tracks information related to a write.
@@ -59,6 +60,22 @@ class WriteRecord {
   TableHeap *table_;
 };
 
+/**
+ * IndexWriteRecord tracks an entry a transaction wrote into an index, so that an abort can take it out again.
+ */
+class IndexWriteRecord {
+ public:
+  IndexWriteRecord(RID rid, WType wtype, const Tuple &key, Index *index)
+      : rid_(rid), wtype_(wtype), key_(key), index_(index) {}
+
+  RID rid_;
+  WType wtype_;
+  /** The key of the entry, built with the key schema of the index. */
+  Tuple key_;
+  /** The index this write record is for. */
+  Index *index_;
+};
+
 /**
  * Transaction tracks information related to a transaction.
  */
@@ -73,6 +90,7 @@ class Transaction {
         exclusive_lock_set_{new std::unordered_set<RID>} {
     // Initialize the sets that will be tracked.
     write_set_ = std::make_shared<std::deque<WriteRecord>>();
+    index_write_set_ = std::make_shared<std::deque<IndexWriteRecord>>();
     page_set_ = std::make_shared<std::deque<bustub::Page *>>();
     deleted_page_set_ = std::make_shared<std::unordered_set<page_id_t>>();
   }
@@ -90,6 +108,9 @@ class Transaction {
   /** @return the list of of write records of this transaction */
   inline std::shared_ptr<std::deque<WriteRecord>> GetWriteSet() { return write_set_; }
 
+  /** @return the list of index write records of this transaction */
+  inline std::shared_ptr<std::deque<IndexWriteRecord>> GetIndexWriteSet() { return index_write_set_; }
+
   /** @return the page set */
   inline std::shared_ptr<std::deque<Page *>> GetPageSet() { return page_set_; }
 
@@ -138,6 +159,15 @@ class Transaction {
    */
   inline void SetPrevLSN(lsn_t prev_lsn) { prev_lsn_ = prev_lsn; }
 
+  /** @return the log offset at or before the BEGIN record of this transaction */
+  inline int64_t GetBeginLogOffset() { return begin_log_offset_; }
+
+  /**
+   * Set the log offset of the BEGIN record.
+   * @param begin_log_offset log offset at or before the BEGIN record
+   */
+  inline void SetBeginLogOffset(int64_t begin_log_offset) { begin_log_offset_ = begin_log_offset; }
+
  private:
   /** The current transaction state. */
   TransactionState state_;
@@ -148,8 +178,12 @@ class Transaction {
 
   /** The undo set of the transaction. */
   std::shared_ptr<std::deque<WriteRecord>> write_set_;
+  /** The index undo set of the transaction. */
+  std::shared_ptr<std::deque<IndexWriteRecord>> index_write_set_;
   /** The LSN of the last record written by the transaction. */
   lsn_t prev_lsn_;
+  /** The log offset at or before the BEGIN record of the transaction, undo may need every record after it. */
+  int64_t begin_log_offset_{0};
 
   /** Concurrent index: the pages that were latched during index operation. */
   std::shared_ptr<std::deque<Page *>> page_set_;
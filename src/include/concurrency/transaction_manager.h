@@ -13,8 +13,10 @@
 #pragma once
 
 #include <atomic>
+#include <mutex>  // NOLINT
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "common/config.h"
 #include "concurrency/lock_manager.h"
@@ -78,6 +80,12 @@ class TransactionManager {
   /** Resumes all transactions, used for checkpointing. */
   void ResumeTransactions();
 
+  /**
+   * Collects the transactions whose COMMIT or ABORT record has not been logged yet, for a fuzzy checkpoint.
+   * @return the active transaction table
+   */
+  std::vector<ActiveTxnEntry> GetActiveTransactionTable();
+
  private:
   /**
    * Releases all the locks held by the given transaction.
@@ -102,6 +110,10 @@ class TransactionManager {
 
   /** The global transaction latch is used for checkpointing. */
   ReaderWriterLatch global_txn_latch_;
+
+  /** The transactions that are still active in the log, protected by active_txns_latch_. */
+  std::unordered_set<Transaction *> active_txns_;
+  std::mutex active_txns_latch_;
 };
 
 }  // namespace bustub
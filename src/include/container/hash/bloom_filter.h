@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter.h
+//
+// Identification: src/include/container/hash/bloom_filter.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "buffer/buffer_pool_manager.h"
+
+namespace bustub {
+
+/**
+ * A blocked Bloom filter over 64 bit hashes. The upper half of a hash picks a block of 8 words, i.e. 32 bytes that
+ * share a cache line, the lower half sets one bit in each of its words, chosen by multiplying it with a salt per
+ * word. A lookup thus touches one cache line, at a false positive rate slightly above that of a plain Bloom filter
+ * of the same size, about 1.2% at 10 bits per key.
+ *
+ * Adds and lookups are thread safe. Keys cannot be removed, the filter of a table with many removes is rebuilt.
+ */
+class BloomFilter {
+ public:
+  /** Number of words of a block, a key sets one bit in each. */
+  static constexpr uint32_t WORDS_PER_BLOCK = 8;
+
+  /**
+   * Creates an empty filter.
+   * @param num_keys the number of keys the filter is sized for
+   * @param bits_per_key the bits of the filter per key, more bits give fewer false positives
+   */
+  BloomFilter(size_t num_keys, size_t bits_per_key);
+
+  /** @param hash the hash of a key to add */
+  void Add(uint64_t hash);
+
+  /**
+   * @param hash the hash of a key
+   * @return false if the key was never added, true if it may have been
+   */
+  bool MayContain(uint64_t hash) const;
+
+  /** @return the size of the filter in bits */
+  size_t NumBits() const { return num_blocks_ * WORDS_PER_BLOCK * 32; }
+
+  /**
+   * Writes the filter into a chain of new BloomFilterPages.
+   * @param owner_page_id the page of the structure whose keys the filter holds
+   * @param num_keys the number of keys the structure holds
+   * @return the first page of the chain
+   */
+  page_id_t Persist(BufferPoolManager *buffer_pool_manager, page_id_t owner_page_id, uint64_t num_keys) const;
+
+  /**
+   * Reads a filter that Persist wrote.
+   * @param owner_page_id the page of the structure whose keys the filter should hold
+   * @param num_keys the number of keys the structure holds now
+   * @return the filter, nullptr if the pages do not hold one or it was written for another owner or number of keys
+   */
+  static std::unique_ptr<BloomFilter> Load(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id,
+                                           page_id_t owner_page_id, uint64_t num_keys);
+
+  /** Deletes the pages of a filter that Persist wrote. */
+  static void Drop(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id);
+
+ private:
+  explicit BloomFilter(size_t num_blocks) : num_blocks_(num_blocks), words_(new std::atomic<uint32_t>[NumWords()]()) {}
+
+  size_t NumWords() const { return num_blocks_ * WORDS_PER_BLOCK; }
+  /** @return the first word of the block of the hash */
+  size_t blockOf(uint64_t hash) const { return ((hash >> 32) * num_blocks_ >> 32) * WORDS_PER_BLOCK; }
+  /** @return the bit of the hash in word i of its block */
+  static uint32_t bitOf(uint64_t hash, uint32_t i) {
+    static constexpr uint32_t SALT[WORDS_PER_BLOCK] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                                       0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+    return 1U << (static_cast<uint32_t>(hash) * SALT[i] >> 27);
+  }
+
+  size_t num_blocks_;
+  std::unique_ptr<std::atomic<uint32_t>[]> words_;
+};
+
+}  // namespace bustub
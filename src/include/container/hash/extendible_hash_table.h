@@ -0,0 +1,132 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table.h
+//
+// Identification: src/include/container/hash/extendible_hash_table.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rwlatch.h"
+#include "concurrency/transaction.h"
+#include "container/hash/hash_function.h"
+#include "container/hash/hash_table.h"
+#include "storage/index/generic_key.h"
+#include "storage/page/hash_table_block_page.h"
+#include "storage/page/hash_table_directory_page.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+#define EXTENDIBLE_HASH_TABLE_TYPE ExtendibleHashTable<KeyType, ValueType, KeyComparator>
+
+/**
+ * Implementation of extendible hash table that is backed by a buffer pool manager. Non-unique keys are supported.
+ * Supports insert and delete. A full bucket is split in two while the rest of the table stays untouched, the
+ * directory doubles when the bucket already uses all bits of the global depth. An empty bucket is merged with its
+ * split image and the directory shrinks when no bucket needs all of its bits anymore.
+ *
+ * The buckets are block pages whose occupied slots form a prefix, so a probe stops at the first unoccupied slot.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class ExtendibleHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
+ public:
+  /**
+   * Creates a new ExtendibleHashTable with a single bucket
+   *
+   * @param buffer_pool_manager buffer pool manager to be used
+   * @param comparator comparator for keys
+   * @param hash_fn the hash function
+   */
+  explicit ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                               const KeyComparator &comparator, HashFunction<KeyType> hash_fn);
+
+  /**
+   * Inserts a key-value pair into the hash table.
+   * @param transaction the current transaction
+   * @param key the key to create
+   * @param value the value to be associated with the key
+   * @return true if insert succeeded, false if the pair exists or the bucket of the key cannot be split anymore
+   */
+  bool Insert(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Deletes the associated value for the given key.
+   * @param transaction the current transaction
+   * @param key the key to delete
+   * @param value the value to delete
+   * @return true if remove succeeded, false otherwise
+   */
+  bool Remove(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Performs a point query on the hash table.
+   * @param transaction the current transaction
+   * @param key the key to look up
+   * @param[out] result the value(s) associated with a given key
+   * @return the value(s) associated with the given key
+   */
+  bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
+
+  /**
+   * @return the global depth of the directory
+   */
+  uint32_t GetGlobalDepth();
+
+  /**
+   * Gets the size of the hash table
+   * @return current number of pairs in the hash table
+   */
+  size_t GetSize();
+
+  /**
+   * Asserts the invariants of the directory.
+   */
+  void VerifyIntegrity();
+
+ private:
+  using BucketPage = HashTableBlockPage<KeyType, ValueType, KeyComparator>;
+
+  // member variable
+  page_id_t directory_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+
+  // Readers include inserts and removes that stay within a bucket, writers split or merge buckets
+  ReaderWriterLatch table_latch_;
+
+  // Hash function
+  HashFunction<KeyType> hash_fn_;
+
+  // current table size
+  std::atomic<size_t> size_;
+
+  uint32_t hash(const KeyType &key);
+  uint8_t tag(const KeyType &key);
+  uint32_t keyToDirectoryIndex(const KeyType &key, HashTableDirectoryPage *dir_page);
+
+  /**
+   * Inserts into the bucket if it has room and does not hold the pair yet.
+   * @param[out] full set to true if the pair was not inserted because the bucket is full
+   */
+  bool bucketInsert(BucketPage *bucket, const KeyType &key, const ValueType &value, bool *full);
+  bool bucketIsEmpty(BucketPage *bucket);
+
+  /** Splits the bucket of the key if it is still full, returns false if the directory is full. */
+  bool splitBucket(const KeyType &key);
+
+  /** Merges the bucket of the key with its split image if the bucket is empty. */
+  void mergeBucket(const KeyType &key);
+};
+
+}  // namespace bustub
@@ -14,23 +14,37 @@
 
 #include <cstdint>
 
-#include "murmur3/MurmurHash3.h"
+#include "common/util/hash_family.h"
+#include "common/util/hash_util.h"
 
 namespace bustub {
 
+/** The hash family of a key type, DefaultHashFamily unless the key type picks another one. */
 template <typename KeyType>
+struct KeyHashFamily {
+  using type = DefaultHashFamily;
+};
+
+/** A hash_t key is the hash of a join key already, see HashJoinExecutor::HashValues. */
+template <>
+struct KeyHashFamily<hash_t> {
+  using type = IdentityHashFamily;
+};
+
+/**
+ * Hashes keys with a hash family that is picked at compile time, see hash_family.h. Key types that are not hashed
+ * over all of their bytes specialize it, e.g. GenericKey.
+ */
+template <typename KeyType, typename Family = typename KeyHashFamily<KeyType>::type>
 class HashFunction {
  public:
+  virtual ~HashFunction() = default;
+
   /**
    * @param key the key to be hashed
    * @return the hashed value
    */
-  virtual uint64_t GetHash(KeyType key) {
-    uint64_t hash[2];
-    murmur3::MurmurHash3_x64_128(reinterpret_cast<const void *>(&key), static_cast<int>(sizeof(KeyType)), 0,
-                                 reinterpret_cast<void *>(&hash));
-    return hash[0];
-  }
+  virtual uint64_t GetHash(KeyType key) { return Family::Hash(reinterpret_cast<const void *>(&key), sizeof(KeyType)); }
 };
 
 }  // namespace bustub
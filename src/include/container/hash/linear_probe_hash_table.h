@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <queue>
 #include <string>
 #include <vector>
@@ -19,9 +21,12 @@
 #include "buffer/buffer_pool_manager.h"
 #include "common/util/hash_util.h"
 #include "concurrency/transaction.h"
+#include "container/hash/bloom_filter.h"
 #include "container/hash/hash_function.h"
 #include "container/hash/hash_table.h"
+#include "recovery/log_manager.h"
 #include "storage/index/hash_comparator.h"
+#include "storage/page/hash_table_anchor_page.h"
 #include "storage/page/hash_table_block_page.h"
 #include "storage/page/hash_table_header_page.h"
 #include "storage/page/hash_table_page_defs.h"
@@ -33,11 +38,32 @@ namespace bustub {
 /**
  * Implementation of linear probing hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
- * table dynamically grows once full.
+ * table dynamically grows once it is three quarters full.
+ *
+ * Growing is incremental: a new table of twice the blocks takes all inserts, while every insert and remove moves
+ * the pairs of the next MIGRATE_SLOTS slots of the old table over. Lookups and removes search both tables until the
+ * old one is drained and dropped.
+ *
+ * Lookups, inserts and removes latch the block pages they probe only. The header page of a table never changes once
+ * the table is created, so its block page ids are kept in memory and it is not fetched at all. A resize and a bulk
+ * load replace the header page, the anchor page allocated with the hash table points at the current one, and at the
+ * one a resize in progress drains, so that the hash table opens again from the anchor page at any time. The table
+ * latch is held in shared mode by all of them and in write mode only to start a resize, to migrate a batch of slots,
+ * and by an insert whose probe wraps around from the last block to the first one.
+ *
+ * An optional Bloom filter over the hashes of the keys answers most lookups of absent keys without fetching a block.
+ * Inserts add to it, removes leave it as is, and a resize builds a new one for the new table.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
  public:
+  /** Number of slots of the old table that an insert or remove migrates during a resize. */
+  static constexpr size_t MIGRATE_SLOTS = 16;
+  /** Number of blocks whose page ids fit into the header page, the table does not grow beyond. */
+  static constexpr size_t MAX_BLOCKS = (PAGE_SIZE - sizeof(HashTableHeaderPage)) / sizeof(page_id_t);
+  /** Number of keys of a batch lookup whose block pages are fetched and prefetched before the first is probed. */
+  static constexpr size_t PREFETCH_GROUP = 16;
+
   /**
    * Creates a new LinearProbeHashTable
    *
@@ -45,16 +71,31 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
    * @param comparator comparator for keys
    * @param num_buckets initial number of buckets contained by this hash table
    * @param hash_fn the hash function
+   * @param log_manager the log manager that the changes of the pages are logged to, nullptr to not log them
    */
   explicit LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                const KeyComparator &comparator, size_t num_buckets, HashFunction<KeyType> hash_fn);
+                                const KeyComparator &comparator, size_t num_buckets, HashFunction<KeyType> hash_fn,
+                                LogManager *log_manager = nullptr);
+
+  /**
+   * Opens an existing LinearProbeHashTable, i.e. after recovery redid its pages. A resize that was in progress goes
+   * on from the first slot of the old table, the slots migrated before are empty.
+   *
+   * @param buffer_pool_manager buffer pool manager to be used
+   * @param comparator comparator for keys
+   * @param hash_fn the hash function
+   * @param anchor_page_id the anchor page of the hash table
+   * @param log_manager the log manager that the changes of the pages are logged to, nullptr to not log them
+   */
+  LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                       HashFunction<KeyType> hash_fn, page_id_t anchor_page_id, LogManager *log_manager = nullptr);
 
   /**
    * Inserts a key-value pair into the hash table.
    * @param transaction the current transaction
    * @param key the key to create
    * @param value the value to be associated with the key
-   * @return true if insert succeeded, false otherwise
+   * @return true if insert succeeded, false if the pair exists or the table is full at MAX_BLOCKS
    */
   bool Insert(Transaction *transaction, const KeyType &key, const ValueType &value) override;
 
@@ -77,7 +118,41 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
   bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
 
   /**
-   * Resizes the table to at least twice the initial size provided.
+   * Performs point queries for many keys at once. The keys are taken in groups of PREFETCH_GROUP: all keys of a
+   * group are hashed, the blocks their probes start in are fetched and the slots prefetched, and only then are the
+   * keys probed one after another, so that the cache misses of a group overlap instead of following each other.
+   * A group whose blocks do not fit into the buffer pool at once is probed one key at a time.
+   * @param transaction the current transaction
+   * @param keys the keys to look up
+   * @param[out] results the values of keys[i] are appended to (*results)[i], it is resized to the number of keys
+   */
+  void GetValues(Transaction *transaction, const std::vector<KeyType> &keys,
+                 std::vector<std::vector<ValueType>> *results);
+
+  /**
+   * Inserts many pairs into an empty table at once. The table is sized for all of them up front, so that it does not
+   * resize, and the pairs are partitioned by the block their probe starts in, so that every block is fetched and
+   * filled once. A table that is not empty inserts the pairs one by one.
+   * @param transaction the current transaction
+   * @param pairs the key-value pairs to insert, pairs that are repeated are inserted once
+   * @param[out] dropped if not nullptr, the pairs that find no room in a table of MAX_BLOCKS blocks are appended to it
+   * @return the number of pairs inserted
+   */
+  size_t BulkLoad(Transaction *transaction, const std::vector<MappingType> &pairs,
+                  std::vector<MappingType> *dropped = nullptr);
+
+  /**
+   * Removes all pairs whose values match, e.g. the entries of an index that point at the tuples whose inserts undo
+   * rolled back after a crash, see LogRecovery::GetRolledBackInserts. The slots are left as tombstones.
+   * @param transaction the current transaction
+   * @param is_removed returns true for the values of the pairs to remove
+   * @return the number of pairs removed
+   */
+  size_t RemoveValues(Transaction *transaction, const std::function<bool(const ValueType &)> &is_removed);
+
+  /**
+   * Resizes the table to at least twice the initial size provided, or to MAX_BLOCKS. A resize still in progress is
+   * finished first, the pairs of the resized table are migrated by the following inserts and removes.
    * @param initial_size the initial size of the hash table
    */
   void Resize(size_t initial_size);
@@ -88,28 +163,156 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
    */
   size_t GetSize();
 
+  /**
+   * Builds a Bloom filter that lookups consult before they probe, or drops it. The filter is sized for the pairs at
+   * which the table grows, and kept in memory only until PersistBloomFilter writes it.
+   * @param bits_per_key the bits of the filter per pair, 0 to drop the filter
+   * @param filter_page_id a filter that PersistBloomFilter wrote for the pairs of the table, INVALID_PAGE_ID to build
+   * it from the pairs instead. The filter is built from the pairs as well when it was written for another table, or
+   * when pairs were inserted since it was written.
+   */
+  void EnableBloomFilter(size_t bits_per_key, page_id_t filter_page_id = INVALID_PAGE_ID);
+
+  /**
+   * Finishes a resize in progress and writes the Bloom filter into pages, replacing those written before. Unlike the
+   * anchor page id, the page id only opens the filter again for the table as it is now.
+   * @return the first page of the filter, INVALID_PAGE_ID if there is no filter
+   */
+  page_id_t PersistBloomFilter();
+
+  /** Deletes the pages of the table, its anchor page and its persisted Bloom filter. Not used afterwards. */
+  void Drop();
+
+  /**
+   * Walks the whole table for the average length of a probe in slots, once a resize in progress is finished. Not
+   * thread safe, for tests and benchmarks.
+   * @param[out] hit_length the average length of a lookup of a pair in the table, from its start to the pair
+   * @param[out] miss_length the average length of a lookup of a key that is not, from each slot of the table as the
+   * start to the first unoccupied slot
+   */
+  void ProbeLengths(double *hit_length, double *miss_length);
+
+  /** @return the page id of the anchor page, which opens the hash table again */
+  page_id_t GetAnchorPageId();
+
  private:
+  using BlockPage = HashTableBlockPage<KeyType, ValueType, KeyComparator>;
+
+  /** Outcome of inserting into one table. */
+  enum class InsertResult { INSERTED, DUPLICATE, FULL, WRAPPED };
+
   // member variable
+  // the anchor page never changes, it points at header_page_id_ and old_header_page_id_
+  page_id_t anchor_page_id_;
   page_id_t header_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writer is only resize
+  // the block page ids of the header page of the table
+  std::vector<page_id_t> block_page_ids_;
+
+  // the table being drained by a resize, INVALID_PAGE_ID if there is none
+  page_id_t old_header_page_id_{INVALID_PAGE_ID};
+  std::vector<page_id_t> old_block_page_ids_;
+  // the next slot of the old table to migrate
+  size_t migrate_index_{0};
+
+  // Readers include inserts and removes, writers start a resize or migrate a batch of slots
   ReaderWriterLatch table_latch_;
 
   // Hash function
   HashFunction<KeyType> hash_fn_;
 
+  // the Bloom filters of the table and of the table being drained, nullptr without a filter
+  std::unique_ptr<BloomFilter> bloom_filter_;
+  std::unique_ptr<BloomFilter> old_bloom_filter_;
+  // 0 without a filter
+  size_t bloom_bits_per_key_{0};
+  // the pages the filter was last persisted to
+  page_id_t bloom_filter_page_id_{INVALID_PAGE_ID};
+  // whether those pages still hold every pair, the first insert after they were written marks them stale
+  std::atomic<bool> bloom_filter_page_current_{false};
+
   // current table size
   std::atomic<size_t> size_;
 
-  HashTableHeaderPage *loadHeaderPage(bool wlock, bool rlock);
-  HashTableBlockPage<KeyType, ValueType, KeyComparator> *loadBlockPage(HashTableHeaderPage *header_page,
-                                                                       size_t page_idx, bool wlock, bool rlock);
-  void freePage(Page *page, page_id_t page_id, bool wlock, bool rlock, bool dirty);
-  void gotoNextPosition(HashTableHeaderPage *header_page,
-                        HashTableBlockPage<KeyType, ValueType, KeyComparator> **block_page_p, page_id_t *page_id_p,
-                        slot_offset_t *offset_p, bool wlock, bool rlock);
+  // log manager of the changes of the pages, may be nullptr
+  LogManager *log_manager_;
+
+  lsn_t logPageChange(LogRecordType type, page_id_t page_id, std::string page_delta);
+  page_id_t createTable(size_t num_buckets, std::vector<page_id_t> *block_page_ids);
+  /** Reads the block page ids of a table and counts its pairs into size_. */
+  void loadTable(page_id_t header_page_id, std::vector<page_id_t> *block_page_ids);
+  /** Points the anchor page at the header pages of the tables, before the pages of a replaced table are dropped. */
+  void updateAnchor();
+  void dropTable(page_id_t header_page_id, const std::vector<page_id_t> &block_page_ids);
+  /** @return a Bloom filter for a table of num_blocks blocks, nullptr if the table has no filter */
+  std::unique_ptr<BloomFilter> newBloomFilter(size_t num_blocks);
+  /** Marks the persisted filter as written for another state of the table, so that it is not loaded again. */
+  void staleBloomFilterPage();
+
+  /** Looks up the key in one table, filter is the Bloom filter of the table or nullptr. */
+  bool getValue(const std::vector<page_id_t> &block_page_ids, const BloomFilter *filter, const KeyType &key,
+                std::vector<ValueType> *result);
+  void getValues(const std::vector<page_id_t> &block_page_ids, const BloomFilter *filter,
+                 const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results);
+  /**
+   * Probes for key from the start of its probe on, block is the pinned but not latched page the probe starts in.
+   * Releases block and all pages after it.
+   */
+  void probeValues(const std::vector<page_id_t> &block_page_ids, const KeyType &key, uint64_t hash_v, Page *block,
+                   std::vector<ValueType> *result);
+  /**
+   * Inserts the pair unless the table has it already, in a single probe.
+   * @param exclusive true if the caller holds the table latch in write mode, which allows the probe to wrap around
+   * @return WRAPPED if the probe had to wrap around without the table latch in write mode
+   */
+  InsertResult insertPair(const std::vector<page_id_t> &block_page_ids, const KeyType &key, const ValueType &value,
+                          bool exclusive);
+  /**
+   * Removes the pair in a single probe.
+   * @param[out] tombstone the position in the table of the tombstone the remove leaves, if it leaves one
+   */
+  bool removePair(const std::vector<page_id_t> &block_page_ids, const KeyType &key, const ValueType &value,
+                  size_t *tombstone);
+  /**
+   * Inserts the pair into the first free slot from offset on within the block, the caller holds the block write
+   * latched. Does not look beyond the block.
+   * @return FULL if the probe ran past the end of the block
+   */
+  InsertResult insertIntoBlock(BlockPage *block_page, page_id_t block_page_id, slot_offset_t offset, const KeyType &key,
+                               const ValueType &value, uint8_t tag);
+  void insertSlot(BlockPage *block_page, page_id_t block_page_id, slot_offset_t offset, const KeyType &key,
+                  const ValueType &value, uint8_t tag);
+  void removeSlot(BlockPage *block_page, page_id_t block_page_id, slot_offset_t offset);
+  /**
+   * Removes the pair at offset by backward shift: the pairs after it in its run of occupied slots whose probes pass
+   * it move back into the hole one after another, and the last hole is freed with the tombstones right before it,
+   * so that removed pairs do not leave tombstones that every later probe walks. Pairs in the next block stay where
+   * they are, a run that goes on there leaves a tombstone. The caller holds the block write latched.
+   * @return the offset of the tombstone left, BLOCK_ARRAY_SIZE if there is none
+   */
+  slot_offset_t removeAndShift(BlockPage *block_page, page_id_t block_page_id, size_t page_idx, size_t num_blocks,
+                                slot_offset_t offset);
+  /**
+   * Compacts the run of occupied slots from the tombstone at start on across blocks, the caller holds the table
+   * latch in write mode, so that pairs may move from one block into another. Every pair moves to the first hole its
+   * probe passes, and the holes that are left are freed.
+   */
+  void compactRun(size_t start);
+  bool growing();
+  /** @return the number of slots from offset on that a probe compares at once */
+  static uint32_t groupSize(size_t page_idx, slot_offset_t offset, size_t ori_page_idx, slot_offset_t ori_offset);
+
+  /** Starts a resize if the table is three quarters full and migrates a batch of slots of a resize in progress. */
+  void growStep();
+  /** Moves the pairs of the next num_slots slots of the old table, the caller holds the table latch in write mode. */
+  void migrate(size_t num_slots);
+  /** Starts a resize to num_buckets blocks, the caller holds the table latch in write mode. */
+  void startResize(size_t num_buckets);
+
+  Page *fetchBlockPage(page_id_t block_page_id, bool wlock);
+  void freeBlockPage(Page *page, bool wlock, bool dirty);
 };
 
 }  // namespace bustub
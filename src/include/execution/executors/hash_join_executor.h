@@ -31,17 +31,10 @@
 
 namespace bustub {
 /**
- * IdentityHashFunction hashes everything to itself, i.e. h(x) = x.
+ * IdentityHashFunction hashes everything to itself, i.e. h(x) = x. It is the hash function of every hash_t key, so
+ * the join hash table does not hash the hashes of HashValues again.
  */
-class IdentityHashFunction : public HashFunction<hash_t> {
- public:
-  /**
-   * Hashes the key.
-   * @param key the key to be hashed
-   * @return the hashed value
-   */
-  uint64_t GetHash(size_t key) override { return key; }
-};
+using IdentityHashFunction = HashFunction<hash_t, IdentityHashFamily>;
 
 /**
  * A simple hash table that supports hash joins.
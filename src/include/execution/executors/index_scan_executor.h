@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_scan_executor.h
+//
+// Identification: src/include/execution/executors/index_scan_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/index_scan_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * IndexScanExecutor executes an index scan over a range of keys, or a lookup of a single key. It reads the parts of
+ * the index that hold the keys only, and fetches their tuples from the table. The tuples of a range come in key
+ * order, those of a single key in the order of their rids, so that each table page is fetched once.
+ */
+class IndexScanExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new index scan executor.
+   * @param exec_ctx the executor context
+   * @param plan the index scan plan to be executed
+   */
+  IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan);
+
+  void Init() override;
+
+  bool Next(Tuple *tuple) override;
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+ private:
+  /** The index scan plan node to be executed. */
+  const IndexScanPlanNode *plan_;
+  IndexInfo *index_info_;
+  TableMetadata *table_meta_;
+  /** The key of a lookup of a single key, which the fetched tuples must have. */
+  Tuple key_;
+  /** The rids of the tuples to fetch, in the order they are returned. */
+  std::vector<RID> rids_;
+  size_t next_rid_{0};
+};
+}  // namespace bustub
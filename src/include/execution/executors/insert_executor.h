@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
@@ -45,9 +46,17 @@ class InsertExecutor : public AbstractExecutor {
   bool Next([[maybe_unused]] Tuple *tuple) override;
 
  private:
+  /**
+   * Inserts a tuple into the table and its key into every index of the table.
+   * @return false if the table or an index has no room for it
+   */
+  bool insertTuple(const Tuple &tuple);
+
   /** The insert plan node to be executed. */
   const InsertPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> child_executor_;
   TableMetadata *table_meta_;
+  /** The indexes of the table. */
+  std::vector<IndexInfo *> indexes_;
 };
 }  // namespace bustub
@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// nested_index_join_executor.h
+//
+// Identification: src/include/execution/executors/nested_index_join_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/nested_index_join_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * NestedIndexJoinExecutor executes index nested loop joins. There is no build phase: the outer tuples are read in
+ * batches, the keys of a batch are looked up in the index of the inner table at once, which lets a hash index
+ * overlap the cache misses of the lookups, and the matches are fetched from the inner table. A fetched tuple that
+ * does not have the key, as the entry outlived the tuple it was made for, is skipped. Outer tuples with a null key
+ * never match.
+ */
+class NestedIndexJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new index nested loop join executor.
+   * @param exec_ctx the context that the join should be performed in
+   * @param plan the index nested loop join plan node
+   * @param outer the outer child, whose tuples probe the index
+   */
+  NestedIndexJoinExecutor(ExecutorContext *exec_ctx, const NestedIndexJoinPlanNode *plan,
+                          std::unique_ptr<AbstractExecutor> &&outer);
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+  void Init() override;
+
+  bool Next(Tuple *tuple) override;
+
+ private:
+  /** Reads the next batch of outer tuples and looks up their keys, returns false if the outer side is exhausted. */
+  bool nextBatch();
+
+  /** The number of outer tuples whose keys are looked up at once. */
+  static constexpr size_t BATCH_SIZE = 64;
+
+  /** The index nested loop join plan node. */
+  const NestedIndexJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> outer_;
+  IndexInfo *index_info_;
+  TableMetadata *inner_table_;
+
+  /** The outer tuples of the current batch, the keys their matches must have, and the rids in rid order. */
+  std::vector<Tuple> outer_tuples_;
+  std::vector<Tuple> outer_keys_;
+  std::vector<std::vector<RID>> inner_rids_;
+  /** The outer tuple and the rid of its matches that are joined next. */
+  size_t outer_idx_{0};
+  size_t rid_idx_{0};
+};
+}  // namespace bustub
@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_scan_plan.h
+//
+// Identification: src/include/execution/plans/index_scan_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "catalog/simple_catalog.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+/**
+ * IndexScanPlanNode identifies an index whose keys in a range, or whose entries of a single key, should be scanned,
+ * with an optional predicate.
+ */
+class IndexScanPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new index scan plan node.
+   * @param output the output format of this scan plan node
+   * @param predicate the predicate to scan with, tuples are returned if predicate(tuple) = true or predicate = nullptr
+   * @param index_oid the identifier of the index to be scanned
+   * @param low_key the values of the smallest key to scan, in key schema order, empty to scan from the first key
+   * @param high_key the values of the largest key to scan, in key schema order, empty to scan to the last key
+   */
+  IndexScanPlanNode(const Schema *output, const AbstractExpression *predicate, index_oid_t index_oid,
+                    std::vector<Value> low_key, std::vector<Value> high_key)
+      : AbstractPlanNode(output, {}),
+        predicate_{predicate},
+        index_oid_(index_oid),
+        low_key_(std::move(low_key)),
+        high_key_(std::move(high_key)) {}
+
+  /**
+   * Creates a new index scan plan node that looks up the tuples of one key, which hash indexes support as well.
+   * @param output the output format of this scan plan node
+   * @param predicate the predicate to scan with, tuples are returned if predicate(tuple) = true or predicate = nullptr
+   * @param index_oid the identifier of the index to be scanned
+   * @param key the values of the key to look up, in key schema order
+   */
+  IndexScanPlanNode(const Schema *output, const AbstractExpression *predicate, index_oid_t index_oid,
+                    std::vector<Value> key)
+      : AbstractPlanNode(output, {}), predicate_{predicate}, index_oid_(index_oid), key_(std::move(key)) {}
+
+  PlanType GetType() const override { return PlanType::IndexScan; }
+
+  /** @return the predicate to test tuples against; tuples should only be returned if they evaluate to true */
+  const AbstractExpression *GetPredicate() const { return predicate_; }
+
+  /** @return the identifier of the index that should be scanned */
+  index_oid_t GetIndexOid() const { return index_oid_; }
+
+  /** @return the values of the smallest key to scan, empty if the range is open below */
+  const std::vector<Value> &GetLowKey() const { return low_key_; }
+
+  /** @return the values of the largest key to scan, empty if the range is open above */
+  const std::vector<Value> &GetHighKey() const { return high_key_; }
+
+  /** @return true if the scan looks up the tuples of a single key instead of a range */
+  bool IsPointLookup() const { return !key_.empty(); }
+
+  /** @return the values of the key to look up, empty if the scan is over a range */
+  const std::vector<Value> &GetKey() const { return key_; }
+
+ private:
+  /** The predicate that all returned tuples must satisfy. */
+  const AbstractExpression *predicate_;
+  /** The index whose keys should be scanned. */
+  index_oid_t index_oid_;
+  /** The bounds of the keys to scan, both included, the predicate drops the keys of an exclusive bound. */
+  std::vector<Value> low_key_;
+  std::vector<Value> high_key_;
+  /** The key of a point lookup, the bounds are unused then. */
+  std::vector<Value> key_;
+};
+
+}  // namespace bustub
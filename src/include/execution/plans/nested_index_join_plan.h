@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// nested_index_join_plan.h
+//
+// Identification: src/include/execution/plans/nested_index_join_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "catalog/simple_catalog.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * NestedIndexJoinPlanNode is used to represent an index nested loop join between a child plan node, the outer side,
+ * and the table of an index, the inner side. The keys of every outer tuple are looked up in the index, so no part of
+ * the inner table is read other than its matches. By convention, the outer tuple has a tuple index of 0 and the
+ * inner tuple, whose schema is that of its table, a tuple index of 1 in the predicate and the output expressions.
+ */
+class NestedIndexJoinPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new index nested loop join plan node.
+   * @param output_schema the output format of the join
+   * @param children the outer plan node, the only child
+   * @param predicate the predicate that joined tuples must satisfy besides the key equality, or nullptr
+   * @param index_oid the identifier of the index on the inner table
+   * @param outer_keys the expressions that compute the key of the index from an outer tuple, in key schema order
+   */
+  NestedIndexJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
+                          const AbstractExpression *predicate, index_oid_t index_oid,
+                          std::vector<const AbstractExpression *> &&outer_keys)
+      : AbstractPlanNode(output_schema, std::move(children)),
+        predicate_(predicate),
+        index_oid_(index_oid),
+        outer_keys_(std::move(outer_keys)) {}
+
+  PlanType GetType() const override { return PlanType::NestedIndexJoin; }
+
+  /** @return the predicate to be used in the join, nullptr if the key equality is the only condition */
+  const AbstractExpression *Predicate() const { return predicate_; }
+
+  /** @return the outer plan node of the join, whose tuples probe the index */
+  const AbstractPlanNode *GetOuterPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Index nested loop joins should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+  /** @return the identifier of the index that is probed */
+  index_oid_t GetIndexOid() const { return index_oid_; }
+
+  /** @return the expressions that compute the key of the index from an outer tuple */
+  const std::vector<const AbstractExpression *> &GetOuterKeys() const { return outer_keys_; }
+
+ private:
+  /** The join predicate. */
+  const AbstractExpression *predicate_;
+  /** The index on the inner table. */
+  index_oid_t index_oid_;
+  /** The outer child's keys. */
+  std::vector<const AbstractExpression *> outer_keys_;
+};
+}  // namespace bustub
@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <thread>  // NOLINT
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "concurrency/transaction_manager.h"
 #include "recovery/log_manager.h"
@@ -19,7 +22,11 @@
 namespace bustub {
 
 /**
- * CheckpointManager creates consistent checkpoints by blocking all other transactions temporarily.
+ * CheckpointManager creates ARIES-style fuzzy checkpoints without blocking transactions. BeginCheckpoint logs a
+ * BEGIN_CHECKPOINT record followed by an END_CHECKPOINT record that carries the active transaction table and the dirty
+ * page table, then writes the dirty pages out in the background. EndCheckpoint waits for the background flush and
+ * points the master record at the new checkpoint, so recovery starts from there instead of from the start of the log.
+ * The log segments before the checkpoint and before the oldest active transaction are recycled afterwards.
  */
 class CheckpointManager {
  public:
@@ -29,15 +36,25 @@ class CheckpointManager {
         log_manager_(log_manager),
         buffer_pool_manager_(buffer_pool_manager) {}
 
-  ~CheckpointManager() = default;
+  ~CheckpointManager();
 
   void BeginCheckpoint();
   void EndCheckpoint();
 
  private:
+  /** Writes out the pages that were dirty when the checkpoint began, one at a time. */
+  void FlushDirtyPages(std::vector<DirtyPageEntry> dirty_pages);
+
   TransactionManager *transaction_manager_ __attribute__((__unused__));
   LogManager *log_manager_ __attribute__((__unused__));
   BufferPoolManager *buffer_pool_manager_ __attribute__((__unused__));
+
+  /** Log offset at or before the BEGIN_CHECKPOINT record of the checkpoint in progress. */
+  int64_t checkpoint_offset_ = -1;
+  /** Recovery from the checkpoint in progress never reads the log before this offset. */
+  int64_t truncate_offset_ = -1;
+  /** Writes out the dirty pages of the checkpoint in progress. */
+  std::thread *flush_thread_ = nullptr;
 };
 
 }  // namespace bustub
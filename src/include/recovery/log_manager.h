@@ -16,6 +16,9 @@
 #include <condition_variable>  // NOLINT
 #include <future>              // NOLINT
 #include <mutex>               // NOLINT
+#include <thread>              // NOLINT
+#include <utility>
+#include <vector>
 
 #include "recovery/log_record.h"
 #include "storage/disk/disk_manager.h"
@@ -26,22 +29,40 @@ namespace bustub {
 /**
  * LogManager maintains a separate thread that is awakened whenever the log buffer is full or whenever a timeout
  * happens. When the thread is awakened, the log buffer's content is written into the disk log file.
+ *
+ * Appenders do not take a latch: a single compare-and-swap on reserve_state_ hands out both the LSN and a slot in the
+ * current log buffer, so buffer order always matches LSN order. Every appender then serializes its record into its
+ * own slot in parallel and publishes the completed bytes.
+ *
+ * The log buffers form a ring of LOG_BUFFER_COUNT buffers. Sealing the current buffer switches reserve_state_ to the
+ * next free buffer in the ring, so a full buffer is sealed by the appender that overflows it and appends continue
+ * while the flush thread writes out the sealed buffers in order. Appenders only wait when every buffer in the ring is
+ * sealed and waiting to be written.
+ *
+ * With log compression on, the flush thread compresses every buffer before it is written, see DiskManager::WriteLog.
  */
 class LogManager {
  public:
   const lsn_t INVALID_LSN = -1;
-  explicit LogManager(DiskManager *disk_manager)
-      : next_lsn_(0), persistent_lsn_(INVALID_LSN), disk_manager_(disk_manager) {
-    log_buffer_ = new char[LOG_BUFFER_SIZE];
-    flush_buffer_ = new char[LOG_BUFFER_SIZE];
+  /**
+   * Creates a new LogManager.
+   * @param disk_manager the disk manager the log is written to
+   * @param compress_log true to compress every log buffer that is written out
+   */
+  explicit LogManager(DiskManager *disk_manager, bool compress_log = false)
+      : persistent_lsn_(INVALID_LSN), compress_log_(compress_log), disk_manager_(disk_manager) {
+    for (auto &buffer : buffers_) {
+      buffer.data_ = new char[LOG_BUFFER_SIZE];
+    }
+    // new records are appended after the ones already in the log file
+    buffers_[0].base_offset_ = disk_manager_->GetLogSize();
   }
 
   ~LogManager() {
-    delete[] log_buffer_;
-    delete[] flush_buffer_;
-    log_buffer_ = nullptr;
-    flush_buffer_ = nullptr;
-    delete promise_;
+    for (auto &buffer : buffers_) {
+      delete[] buffer.data_;
+      buffer.data_ = nullptr;
+    }
   }
 
   void RunFlushThread();
@@ -50,32 +71,134 @@ class LogManager {
 
   lsn_t AppendLogRecord(LogRecord *log_record);
 
-  inline lsn_t GetNextLSN() { return next_lsn_; }
+  inline lsn_t GetNextLSN() { return StateLSN(reserve_state_.load()); }
+
+  /**
+   * @param[out] offset the log offset the next record is written at, or an earlier record boundary if records are
+   * appended concurrently
+   * @return the LSN of the next record, the record written at offset has this LSN or an earlier one
+   */
+  lsn_t GetNextLSNAndOffset(int64_t *offset);
+
+  /**
+   * Points the master record at a checkpoint whose records are persistent.
+   * @param checkpoint_offset log offset at or before the BEGIN_CHECKPOINT record
+   */
+  inline void WriteMasterRecord(int64_t checkpoint_offset) { disk_manager_->WriteMasterRecord(checkpoint_offset); }
+
+  /**
+   * Recycles the log segments that only hold records before the given offset.
+   * @param offset log offset of the oldest record that recovery may read
+   */
+  inline void TruncateLog(int64_t offset) { disk_manager_->TruncateLog(offset); }
+  /**
+   * Continues the LSNs of the log on disk, recovery calls it before it appends compensation records.
+   * @param next_lsn the LSN after the last one in the log
+   */
+  void SetNextLSN(lsn_t next_lsn);
+
   inline lsn_t GetPersistentLSN() { return persistent_lsn_; }
   inline void SetPersistentLSN(lsn_t lsn) { persistent_lsn_ = lsn; }
-  inline char *GetLogBuffer() { return log_buffer_; }
+  inline char *GetLogBuffer() { return buffers_[StateBuffer(reserve_state_.load())].data_; }
 
  private:
-  // TODO(students): you may add your own member variables
-  std::atomic<uint32_t> offset_ = 0;
-  std::atomic<bool> future_done_ = true;
-  std::atomic<bool> swap_done_ = false;
+  /** A log buffer that appenders fill concurrently. */
+  struct LogBuffer {
+    char *data_{nullptr};
+    /** Number of bytes whose serialization has been completed by their appenders. */
+    std::atomic<uint32_t> completed_{0};
+    /** Log offset of the first byte of the buffer, set before the buffer becomes the current one. */
+    std::atomic<int64_t> base_offset_{0};
+  };
+
+  /**
+   * reserve_state_ layout (bits):
+   * ----------------------------------------------------
+   * | next LSN (63-32) | buffer seq (31-24) | offset (23-0) |
+   * ----------------------------------------------------
+   */
+  static constexpr uint32_t OFFSET_BITS = 24;
+  static constexpr uint32_t SEQ_BITS = 8;
+  static constexpr uint32_t NUM_BUFFERS = LOG_BUFFER_COUNT;
+  static_assert(LOG_BUFFER_SIZE < (1 << OFFSET_BITS), "log buffer offset does not fit into reserve_state_");
+  static_assert(NUM_BUFFERS >= 2 && (1U << SEQ_BITS) % NUM_BUFFERS == 0, "buffer seq must wrap around the ring");
+
+  static inline lsn_t StateLSN(uint64_t state) { return static_cast<lsn_t>(state >> 32); }
+  static inline uint32_t StateSeq(uint64_t state) { return (state >> OFFSET_BITS) & ((1U << SEQ_BITS) - 1); }
+  static inline uint32_t StateBuffer(uint64_t state) { return StateSeq(state) % NUM_BUFFERS; }
+  static inline uint32_t StateOffset(uint64_t state) { return state & ((1U << OFFSET_BITS) - 1); }
+  /** @return the state that keeps the next LSN and starts appending at the beginning of the next buffer */
+  static inline uint64_t SealedState(uint64_t state) {
+    uint64_t next_seq = (StateSeq(state) + 1) & ((1U << SEQ_BITS) - 1);
+    return (state & ~((1ULL << 32) - 1)) | (next_seq << OFFSET_BITS);
+  }
+
+  /** A buffer that has been sealed and waits to be written out. */
+  struct SealedBuffer {
+    uint32_t size_;
+    lsn_t last_lsn_;
+  };
+
+  /** @return true if the ring has a free buffer to switch to, the caller must hold latch_ */
+  inline bool HasFreeBuffer() { return sealed_seq_ - written_seq_ < NUM_BUFFERS - 1; }
+
+  /**
+   * Seals the current log buffer if it is not empty and the ring has a free buffer, so that appends continue in the
+   * next buffer. The caller must hold latch_.
+   * @return true if the current buffer is empty after this call
+   */
+  bool SealLogBuffer();
+
+  /**
+   * Writes all sealed buffers to disk in order, then wakes up everyone waiting on them. Only called by the flush
+   * thread, or by FlushWithoutThread while there is none.
+   * @param lock the held lock on latch_, released while the disk writes are in progress
+   */
+  void FlushSealedBuffers(std::unique_lock<std::mutex> *lock);
+
+  /**
+   * Writes out the ring in the calling thread while no flush thread runs, i.e. while recovery appends compensation
+   * records.
+   * @param lock the held lock on latch_
+   * @param target_seq returns once this many buffers have been written
+   */
+  void FlushWithoutThread(std::unique_lock<std::mutex> *lock, uint64_t target_seq);
+
+  /** The next LSN, the buffer being appended to and the next free offset in it, updated with compare-and-swap. */
+  std::atomic<uint64_t> reserve_state_{0};
+  /** True if someone asked the flush thread to flush before log_timeout expires, protected by latch_. */
+  bool flush_requested_ = false;
+  /** SyncFlush callers waiting until the given number of buffers has been written, protected by latch_. */
+  std::vector<std::pair<uint64_t, std::promise<void>>> flush_waiters_;
+  /** Number of buffers sealed so far, the current buffer is the sealed_seq_-th one, protected by latch_. */
+  uint64_t sealed_seq_ = 0;
+  /** Number of buffers written to disk so far, protected by latch_. */
+  uint64_t written_seq_ = 0;
+  /** Sizes and last LSNs of the sealed buffers, indexed by buffer seq modulo the ring size, protected by latch_. */
+  SealedBuffer sealed_[NUM_BUFFERS];
 
-  /** The atomic counter which records the next log sequence number. */
-  std::atomic<lsn_t> next_lsn_;
   /** The log records before and including the persistent lsn have been written to disk. */
   std::atomic<lsn_t> persistent_lsn_;
 
-  char *log_buffer_;
-  char *flush_buffer_;
+  LogBuffer buffers_[NUM_BUFFERS];
 
+  /** Protects the flush thread state and the ring; buffers are only sealed while holding it. */
   std::mutex latch_;
 
-  std::atomic<bool> thread_run_forever_ = true;
-  std::thread *flush_thread_ __attribute__((__unused__));
+  /** Protected by latch_, the flush thread exits once this becomes false. */
+  bool thread_run_forever_ = true;
+  /** Protected by latch_, the log is written out by its appenders while there is no flush thread. */
+  std::thread *flush_thread_ = nullptr;
+  /** True while someone writes out sealed buffers, protected by latch_. */
+  bool flushing_ = false;
+
+  /** Wakes up the flush thread before log_timeout expires. */
+  std::condition_variable flush_cv_;
+  /** Wakes up appenders waiting for a buffer in the ring to be written out. */
+  std::condition_variable append_cv_;
 
-  std::condition_variable cv_;
-  std::promise<void> *promise_ = nullptr;
+  /** True if the log buffers are compressed when they are written out. */
+  const bool compress_log_;
 
   DiskManager *disk_manager_ __attribute__((__unused__));
 };
@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// log_reader.h
+//
+// Identification: src/include/recovery/log_reader.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <future>  // NOLINT
+#include <memory>
+
+#include "recovery/log_record.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * LogReader streams the log records from a log offset on for recovery.
+ *
+ * The log is read in chunks of LOG_READ_SIZE bytes into two buffers: while the records of one chunk are parsed, the
+ * next chunk is already being read in the background. The tuples of the returned records are not copied, they point
+ * into the chunk, which is reference counted so that a record can be kept after the reader has moved on.
+ *
+ * Chunk layout:
+ * ------------------------------------------------------------------------------
+ * | room for a record carried over (LOG_BUFFER_SIZE) | chunk data (chunk_size) |
+ * ------------------------------------------------------------------------------
+ * A record that crosses the end of a chunk is copied in front of the next chunk, so every record is contiguous.
+ */
+class LogReader {
+ public:
+  /**
+   * Creates a reader and starts reading the first chunk.
+   * @param disk_manager the disk manager holding the log
+   * @param offset log offset of the first record
+   * @param chunk_size number of bytes read from the log at once
+   */
+  LogReader(DiskManager *disk_manager, int64_t offset, int chunk_size = LOG_READ_SIZE);
+
+  ~LogReader();
+
+  /**
+   * Reads the next log record, the reader stops at the first incomplete or invalid record.
+   * @param[out] log_record the next record, its tuples are valid as long as the chunk returned by GetChunk is held
+   * @return false if there is no record left
+   */
+  bool Next(LogRecord *log_record);
+
+  /** @return log offset of the record returned by the last Next */
+  inline int64_t GetOffset() { return record_offset_; }
+
+  /** @return the chunk the tuples of the record returned by the last Next point into */
+  inline const std::shared_ptr<char[]> &GetChunk() { return chunk_; }
+
+  /**
+   * Parses a log record without copying its tuples.
+   * @param data the serialized record
+   * @param size number of bytes available at data
+   * @param[out] log_record the record, its tuples point into data
+   * @return false if the bytes do not hold a complete and valid record
+   */
+  static bool ParseLogRecord(const char *data, int size, LogRecord *log_record);
+
+ private:
+  /** Starts reading the chunk at next_offset_ into next_chunk_, unless a record still points into that buffer. */
+  void ReadAhead();
+
+  DiskManager *disk_manager_;
+  int chunk_size_;
+
+  /** The chunk being parsed, the unparsed bytes are chunk_[pos_, end_). */
+  std::shared_ptr<char[]> chunk_;
+  int pos_ = 0;
+  int end_ = 0;
+  /** Log offset of chunk_[pos_]. */
+  int64_t offset_;
+  int64_t record_offset_ = 0;
+  bool end_of_log_ = false;
+
+  /** The chunk being read in the background, it holds the log from next_offset_ on. */
+  std::shared_ptr<char[]> next_chunk_;
+  std::future<bool> next_read_;
+  int64_t next_offset_;
+};
+
+}  // namespace bustub
@@ -14,8 +14,12 @@
 
 #include <cassert>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
+#include "recovery/page_delta.h"
+#include "recovery/tuple_delta.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -32,6 +36,36 @@ enum class LogRecordType {
   ABORT,
   /** Creating a new page in the table heap. */
   NEWPAGE,
+  /** Start of a fuzzy checkpoint. */
+  BEGIN_CHECKPOINT,
+  /** End of a fuzzy checkpoint, carries the active transaction table and the dirty page table. */
+  END_CHECKPOINT,
+  /** Compensation log record, written by undo for the change that reverts a record, only ever redone. */
+  CLR,
+  /** Inserting into a slot of a hash index block page. */
+  HASH_INSERT,
+  /** Removing a slot of a hash index block page. */
+  HASH_REMOVE,
+  /** Setting up a hash index header page, i.e. when the table is created or resized. */
+  HASH_HEADER,
+};
+
+/** An entry of the active transaction table logged by a checkpoint. */
+struct ActiveTxnEntry {
+  txn_id_t txn_id_;
+  /** The LSN of the latest record of the transaction. */
+  lsn_t last_lsn_;
+  /** Log offset at or before the BEGIN record of the transaction, undo may need every record after it. */
+  int64_t begin_offset_;
+};
+
+/** An entry of the dirty page table logged by a checkpoint. */
+struct DirtyPageEntry {
+  page_id_t page_id_;
+  /** No record before this LSN is missing from the page on disk. */
+  lsn_t rec_lsn_;
+  /** Log offset at or before the record with rec_lsn_, redo of the page starts there. */
+  int64_t rec_offset_;
 };
 
 /**
@@ -49,23 +83,38 @@ enum class LogRecordType {
  *----------------------------------------------------------------
  * | HEADER | tuple_rid | tuple_size | tuple_data(char[] array) |
  *---------------------------------------------------------------
- * For update type log record
- *-----------------------------------------------------------------------------------
- * | HEADER | tuple_rid | tuple_size | old_tuple_data | tuple_size | new_tuple_data |
- *-----------------------------------------------------------------------------------
+ * For update type log record, only the changed byte ranges are logged (see TupleDelta)
+ *----------------------------------------------
+ * | HEADER | tuple_rid | delta_size | delta |
+ *----------------------------------------------
  * For new page type log record
  *------------------------------------
  * | HEADER | prev_page_id | page_id |
  *------------------------------------
+ * For end checkpoint type log record
+ *---------------------------------------------------------------------------------------------
+ * | HEADER | txn_count | ActiveTxnEntry[txn_count] | page_count | DirtyPageEntry[page_count] |
+ *---------------------------------------------------------------------------------------------
+ * For hash index type log record (HASH_INSERT/HASH_REMOVE/HASH_HEADER), only the changed bytes are logged (see
+ * PageDelta). These records belong to no transaction and are only ever redone.
+ *-------------------------------------------
+ * | HEADER | page_id | delta_size | delta |
+ *-------------------------------------------
+ * For compensation log record, the body is the one of the record type that undo applied to revert a change
+ *----------------------------------------------------------------------------
+ * | HEADER | undo_next_lsn | compensation_type | body of compensation_type |
+ *----------------------------------------------------------------------------
+ * undo_next_lsn is the prevLSN of the reverted record, undo continues there after a crash during recovery.
  */
 class LogRecord {
   friend class LogManager;
+  friend class LogReader;
   friend class LogRecovery;
 
  public:
   LogRecord() = default;
 
-  // constructor for Transaction type(BEGIN/COMMIT/ABORT)
+  // constructor for Transaction type(BEGIN/COMMIT/ABORT) and BEGIN_CHECKPOINT
   LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType log_record_type)
       : size_(HEADER_SIZE), txn_id_(txn_id), prev_lsn_(prev_lsn), log_record_type_(log_record_type) {}
 
@@ -88,14 +137,25 @@ class LogRecord {
   // constructor for UPDATE type
   LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType log_record_type, const RID &update_rid,
             const Tuple &old_tuple, const Tuple &new_tuple)
+      : LogRecord(txn_id, prev_lsn, log_record_type, update_rid, TupleDelta::Encode(old_tuple, new_tuple)) {}
+
+  // constructor for UPDATE type from the changed byte ranges of the tuple
+  LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType log_record_type, const RID &update_rid,
+            std::string update_delta)
       : txn_id_(txn_id),
         prev_lsn_(prev_lsn),
         log_record_type_(log_record_type),
         update_rid_(update_rid),
-        old_tuple_(old_tuple),
-        new_tuple_(new_tuple) {
+        update_delta_(std::move(update_delta)) {
     // calculate log record size
-    size_ = HEADER_SIZE + sizeof(RID) + old_tuple.GetLength() + new_tuple.GetLength() + 2 * sizeof(int32_t);
+    size_ = HEADER_SIZE + sizeof(RID) + sizeof(int32_t) + update_delta_.size();
+  }
+
+  // constructor for HASH_INSERT/HASH_REMOVE/HASH_HEADER type from the changed bytes of the page
+  LogRecord(LogRecordType log_record_type, page_id_t page_id, std::string page_delta)
+      : log_record_type_(log_record_type), page_id_(page_id), page_delta_(std::move(page_delta)) {
+    // calculate log record size
+    size_ = HEADER_SIZE + sizeof(page_id_t) + sizeof(int32_t) + page_delta_.size();
   }
 
   // constructor for NEWPAGE type
@@ -110,6 +170,30 @@ class LogRecord {
     size_ = HEADER_SIZE + sizeof(page_id_t) * 2;
   }
 
+  // constructor for END_CHECKPOINT type
+  LogRecord(std::vector<ActiveTxnEntry> active_txns, std::vector<DirtyPageEntry> dirty_pages)
+      : log_record_type_(LogRecordType::END_CHECKPOINT),
+        active_txns_(std::move(active_txns)),
+        dirty_pages_(std::move(dirty_pages)) {
+    // calculate log record size, header size + both tables with their entry counts
+    size_ = HEADER_SIZE + 2 * sizeof(int32_t) + active_txns_.size() * sizeof(ActiveTxnEntry) +
+            dirty_pages_.size() * sizeof(DirtyPageEntry);
+  }
+
+  // constructor for CLR type, compensates a record with the INSERT/DELETE/UPDATE record of the change undo applied
+  LogRecord(const LogRecord &compensation, lsn_t undo_next_lsn) : LogRecord(compensation) {
+    assert(compensation.log_record_type_ == LogRecordType::INSERT ||
+           compensation.log_record_type_ == LogRecordType::MARKDELETE ||
+           compensation.log_record_type_ == LogRecordType::APPLYDELETE ||
+           compensation.log_record_type_ == LogRecordType::ROLLBACKDELETE ||
+           compensation.log_record_type_ == LogRecordType::UPDATE);
+    log_record_type_ = LogRecordType::CLR;
+    compensation_type_ = compensation.log_record_type_;
+    undo_next_lsn_ = undo_next_lsn;
+    // calculate log record size, the body of the compensation follows the two fields
+    size_ += sizeof(lsn_t) + sizeof(LogRecordType);
+  }
+
   ~LogRecord() = default;
 
   inline RID &GetDeleteRID() { return delete_rid_; }
@@ -130,6 +214,17 @@ class LogRecord {
 
   inline LogRecordType &GetLogRecordType() { return log_record_type_; }
 
+  /** @return the type of the change a redo applies, the compensation type for a CLR */
+  inline LogRecordType GetRedoType() const {
+    return log_record_type_ == LogRecordType::CLR ? compensation_type_ : log_record_type_;
+  }
+
+  inline lsn_t GetUndoNextLSN() { return undo_next_lsn_; }
+
+  inline const std::vector<ActiveTxnEntry> &GetActiveTxns() { return active_txns_; }
+
+  inline const std::vector<DirtyPageEntry> &GetDirtyPages() { return dirty_pages_; }
+
   // For debug purpose
   inline std::string ToString() const {
     std::ostringstream os;
@@ -160,14 +255,22 @@ class LogRecord {
   RID insert_rid_;
   Tuple insert_tuple_;
 
-  // case3: for update opeartion
+  // case3: for update opeartion, the changed byte ranges of the tuple for both REDO and UNDO
   RID update_rid_;
-  Tuple old_tuple_;
-  Tuple new_tuple_;
+  std::string update_delta_;
 
-  // case4: for new page opeartion
+  // case4: for new page opeartion, page_id_ is the changed page for hash index operations as well
   page_id_t prev_page_id_{INVALID_PAGE_ID};
   page_id_t page_id_{INVALID_PAGE_ID};
+  std::string page_delta_;
+
+  // case5: for checkpoint end
+  std::vector<ActiveTxnEntry> active_txns_;
+  std::vector<DirtyPageEntry> dirty_pages_;
+
+  // case6: for compensation, the record of the change that undo applied is kept in the fields above
+  LogRecordType compensation_type_{LogRecordType::INVALID};
+  lsn_t undo_next_lsn_{INVALID_LSN};
   static const int HEADER_SIZE = 20;
 };  // namespace bustub
 
@@ -13,22 +13,45 @@
 #pragma once
 
 #include <algorithm>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <memory>
 #include <mutex>  // NOLINT
 #include <unordered_map>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "concurrency/lock_manager.h"
+#include "recovery/log_reader.h"
 #include "recovery/log_record.h"
 
 namespace bustub {
 
 /**
  * Read log file from disk, redo and undo.
+ *
+ * Given a log manager, undo writes a compensation log record (CLR) for every change it reverts and an ABORT record
+ * once a transaction is rolled back. A CLR is only ever redone, and its undo_next_lsn lets a recovery that follows a
+ * crash during undo continue where the previous one stopped instead of reverting the same changes again.
  */
 class LogRecovery {
  public:
-  LogRecovery(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager)
-      : disk_manager_(disk_manager), buffer_pool_manager_(buffer_pool_manager), buffer_offset_(0), offset_(0) {
+  /**
+   * Creates a new LogRecovery.
+   * @param disk_manager the disk manager holding the log
+   * @param buffer_pool_manager the buffer pool the pages are recovered in
+   * @param log_manager the log manager undo writes compensation log records to, nullptr to write none
+   * @param read_size number of bytes read from the log at once while the log is scanned
+   */
+  LogRecovery(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, LogManager *log_manager = nullptr,
+              int read_size = LOG_READ_SIZE)
+      : disk_manager_(disk_manager),
+        buffer_pool_manager_(buffer_pool_manager),
+        log_manager_(log_manager),
+        read_size_(read_size),
+        buffer_offset_(0),
+        offset_(0) {
     log_buffer_ = new char[LOG_BUFFER_SIZE];
   }
 
@@ -37,18 +60,145 @@ class LogRecovery {
     log_buffer_ = nullptr;
   }
 
-  void Redo();
-  void Undo();
+  /**
+   * Redo the log from the last checkpoint on, see LoadCheckpoint. With more than one worker, the calling thread only
+   * reads and parses the log and hands every record to the worker that owns the page it modifies: a page is always
+   * redone by the same worker in log order, while different pages are redone in parallel.
+   * @param num_workers number of threads that apply the log records to the pages
+   */
+  void Redo(size_t num_workers = 1);
+
+  /**
+   * Roll back the transactions that were active at the crash, after Redo. Losers that changed the same page form a
+   * group whose records are reverted from the latest one back, as a revert may need the space on the page that the
+   * revert of a later record frees. Groups share no pages and are rolled back in parallel.
+   * @param num_workers number of threads that roll back groups of loser transactions
+   */
+  void Undo(size_t num_workers = 1);
+
+  /**
+   * The hash index changes are redone but not undone, so after Undo the entries a loser made in an index point at
+   * tuples that are gone and whose slots may be reused. The owner of the index removes them, e.g. with
+   * LinearProbeHashTableIndex::DeleteEntries, before the index is used.
+   * @return the rids of the tuples whose inserts Undo rolled back, or an undo before the crash had rolled back
+   */
+  const std::vector<RID> &GetRolledBackInserts() const { return rolled_back_inserts_; }
+
   bool DeserializeLogRecord(const char *data, LogRecord *log_record);
 
  private:
+  /** A log record to be redone on one page, a NEWPAGE record is redone on both the new page and the previous page. */
+  struct RedoTask {
+    LogRecord log_record_;
+    page_id_t page_id_;
+    /** The log chunk the tuples of the record point into. */
+    std::shared_ptr<char[]> chunk_;
+  };
+
+  /** The redo tasks waiting for one redo worker, handed over in batches to keep the queue latch cold. */
+  struct RedoQueue {
+    std::mutex latch_;
+    std::condition_variable cv_;
+    std::deque<std::vector<RedoTask>> batches_;
+    bool done_ = false;
+  };
+
+  /** A record undo has to revert. */
+  struct UndoRecord {
+    lsn_t lsn_;
+    /** Log offset of the record. */
+    int64_t offset_;
+    /** Index of the loser transaction the record belongs to. */
+    size_t loser_;
+  };
+
+  /** Number of tasks handed to a redo worker at once. */
+  static constexpr size_t REDO_BATCH_SIZE = 64;
+  /** Number of batches a redo worker may fall behind before the log reader waits for it. */
+  static constexpr size_t REDO_QUEUE_DEPTH = 16;
+
+  /**
+   * Reads the log from where recovery has to start and updates active_txn_ and lsn_mapping_ with every record, in
+   * log order.
+   * @param visit called with every record and the reader positioned at it after the tables are updated
+   */
+  void ScanLog(const std::function<void(LogRecord *, LogReader *)> &visit);
+
+  /**
+   * Reads the checkpoint the master record points at and fills dirty_pages_ from it.
+   * @return the log offset where recovery starts reading the log
+   */
+  int64_t LoadCheckpoint();
+
+  /**
+   * Streams the log records from the given offset on through a LogReader.
+   * @param offset log offset of the first record
+   * @param visit called with every record and the reader positioned at it, stops the read by returning false
+   */
+  void ReadLogRecords(int64_t offset, const std::function<bool(LogRecord *, LogReader *)> &visit);
+
+  /**
+   * Reads a single log record, for undo that follows the records of a transaction backwards.
+   * @param offset log offset of the record
+   * @param buffer LOG_BUFFER_SIZE bytes to read the record into
+   * @param[out] log_record the record, its tuples point into buffer until the next read
+   * @return false if there is no complete record at the offset
+   */
+  bool ReadLogRecord(int64_t offset, char *buffer, LogRecord *log_record);
+
+  /**
+   * @param log_record the record to be redone
+   * @param offset log offset of the record
+   * @param[out] page_ids the pages modified by the record that may miss the change
+   * @return the number of pages that may need the record to be redone
+   */
+  int GetRedoPages(const LogRecord &log_record, int64_t offset, page_id_t page_ids[2]);
+
+  /**
+   * Redo the record on the given page, unless the page LSN shows that the page already contains it.
+   * @param log_record the record to be redone
+   * @param page_id one of the pages modified by the record
+   */
+  void RedoLogRecord(LogRecord *log_record, page_id_t page_id);
+
+  /**
+   * @param log_record a record of a loser transaction
+   * @param[out] rid the tuple the record changed
+   * @return false if undo has nothing to revert for the record
+   */
+  static bool GetUndoRID(const LogRecord &log_record, RID *rid);
+
+  /**
+   * Reverts the change of a record and logs the revert as a CLR.
+   * @param log_record the record to be undone
+   * @param[in,out] last_lsn the LSN of the latest record of the transaction, updated to the CLR
+   */
+  void UndoLogRecord(LogRecord *log_record, lsn_t *last_lsn);
+
+  /** Applies the batches in the queue until the log reader is done, run by every redo worker. */
+  void RunRedoWorker(RedoQueue *queue);
+
+  /** Hands a batch of tasks to a redo worker, waits while the worker is REDO_QUEUE_DEPTH batches behind. */
+  static void PushRedoBatch(RedoQueue *queue, std::vector<RedoTask> *batch);
+
   DiskManager *disk_manager_ __attribute__((__unused__));
   BufferPoolManager *buffer_pool_manager_ __attribute__((__unused__));
+  LogManager *log_manager_;
 
   /** Maintain active transactions and its corresponding latest lsn. */
   std::unordered_map<txn_id_t, lsn_t> active_txn_;
   /** Mapping the log sequence number to log file offset for undos. */
-  std::unordered_map<lsn_t, int> lsn_mapping_;
+  std::unordered_map<lsn_t, int64_t> lsn_mapping_;
+  /** The pages that were dirty at the last checkpoint and their recLSNs. */
+  std::unordered_map<page_id_t, lsn_t> dirty_pages_;
+  /** Log offset of the last checkpoint, records before it are only redone on the pages in dirty_pages_. */
+  int64_t checkpoint_offset_ = 0;
+  /** Number of bytes read from the log at once while the log is scanned. */
+  int read_size_;
+  /** The LSN after the latest one in the log, new records continue from there. */
+  lsn_t next_lsn_ = 0;
+  /** The tuples whose inserts the losers made and undo rolled back. */
+  std::vector<RID> rolled_back_inserts_;
 
   int buffer_offset_;
   int offset_ __attribute__((__unused__));
@@ -0,0 +1,56 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_delta.h
+//
+// Identification: src/include/recovery/page_delta.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace bustub {
+
+/**
+ * PageDelta encodes a change of a page as the XOR of the bytes it changes, for the log records of pages whose layout
+ * recovery does not know, i.e. the pages of a hash index.
+ *
+ * Delta format, a sequence of ranges:
+ *-------------------------------------------------
+ * | offset | length | old_bytes XOR new_bytes | ... |
+ *-------------------------------------------------
+ * offset and length are 16 bit, a range always lies within a page. Redo applies the delta to the page as it was
+ * before the change, the page LSN tells whether it was.
+ */
+class PageDelta {
+ public:
+  /** Size of the fields in front of the bytes of every range. */
+  static constexpr uint32_t RANGE_HEADER_SIZE = 2 * sizeof(uint16_t);
+
+  /**
+   * Appends the change of a range of the page to a delta.
+   * @param[out] delta the delta of the page
+   * @param offset position of the range in the page
+   * @param old_bytes the range before the change
+   * @param new_bytes the range after the change
+   * @param length length of the range
+   */
+  static void Append(std::string *delta, uint32_t offset, const char *old_bytes, const char *new_bytes,
+                     uint32_t length);
+
+  /**
+   * Applies a delta to a page.
+   * @param delta the delta built by Append
+   * @param[in,out] page_data the data of the page
+   * @return false if the delta does not fit into a page
+   */
+  static bool Apply(const std::string &delta, char *page_data);
+};
+
+}  // namespace bustub
@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_delta.h
+//
+// Identification: src/include/recovery/tuple_delta.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * TupleDelta encodes the byte ranges an update changes in a tuple, so that an UPDATE log record carries the changed
+ * bytes only instead of the whole old and new tuple.
+ *
+ * Delta format, a sequence of ranges in tuple order:
+ *--------------------------------------------------------------------
+ * | offset | old_length | new_length | old_bytes | new_bytes | ... |
+ *--------------------------------------------------------------------
+ * offset is the position of the range in the old tuple. The fields are 16 bit, a tuple always fits into a page.
+ * An update that keeps the tuple size logs every run of changed bytes as its own range, unless the unchanged gap
+ * between two runs is cheaper to log than a range header. An update that changes the size, i.e. of a varchar column,
+ * logs everything between the common prefix and the common suffix of both tuples as one range.
+ */
+class TupleDelta {
+ public:
+  /** Size of the fields in front of the bytes of every range. */
+  static constexpr uint32_t RANGE_HEADER_SIZE = 3 * sizeof(uint16_t);
+
+  /**
+   * @param old_tuple the tuple before the update
+   * @param new_tuple the tuple after the update
+   * @return the delta that turns old_tuple into new_tuple and back
+   */
+  static std::string Encode(const Tuple &old_tuple, const Tuple &new_tuple);
+
+  /**
+   * Applies a delta to a tuple.
+   * @param delta the delta returned by Encode
+   * @param tuple the old tuple to redo the update, or the new tuple to undo it
+   * @param undo true to turn the new tuple back into the old one
+   * @param[out] result the tuple after redo or undo
+   * @return false if the delta does not fit the tuple
+   */
+  static bool Apply(const std::string &delta, const Tuple &tuple, bool undo, Tuple *result);
+};
+
+}  // namespace bustub
@@ -15,7 +15,9 @@
 #include <atomic>
 #include <fstream>
 #include <future>  // NOLINT
+#include <mutex>   // NOLINT
 #include <string>
+#include <vector>
 
 #include "common/config.h"
 
@@ -28,10 +30,12 @@ namespace bustub {
 class DiskManager {
  public:
   /**
-   * Creates a new disk manager that writes to the specified database file.
+   * Creates a new disk manager that writes to the specified database file. The log is written into segment files
+   * named after the log file, the log file itself holds the master record and the first segment still in use.
    * @param db_file the file name of the database file to write to
+   * @param log_segment_size the number of log bytes in a log segment file
    */
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, int log_segment_size = LOG_SEGMENT_SIZE);
 
   ~DiskManager() = default;
 
@@ -55,20 +59,49 @@ class DiskManager {
   void ReadPage(page_id_t page_id, char *page_data);
 
   /**
-   * Flush the entire log buffer into disk.
+   * Flush the entire log buffer into disk, as one log block.
    * @param log_data raw log data
    * @param size size of log entry
+   * @param compress true to compress the block, it is only stored compressed if that makes it smaller
    */
-  void WriteLog(char *log_data, int size);
+  void WriteLog(char *log_data, int size, bool compress = false);
 
   /**
-   * Read a log entry from the log file.
+   * Read a log entry from the log file, compressed log blocks are decompressed transparently.
    * @param[out] log_data output buffer
    * @param size size of the log entry
-   * @param offset offset of the log entry in the file
+   * @param offset log offset of the log entry
    * @return true if the read was successful, false otherwise
    */
-  bool ReadLog(char *log_data, int size, int offset);
+  bool ReadLog(char *log_data, int size, int64_t offset);
+
+  /**
+   * Write the master record, which points at the last completed checkpoint, into the header of the log file.
+   * @param checkpoint_offset log offset at or before the BEGIN_CHECKPOINT record of the checkpoint
+   */
+  void WriteMasterRecord(int64_t checkpoint_offset);
+
+  /**
+   * Read the master record from the header of the log file.
+   * @return the log offset of the last completed checkpoint, -1 if there is none
+   */
+  int64_t ReadMasterRecord();
+
+  /**
+   * Remove the log segments that only hold records before the given offset, called once a checkpoint no longer needs
+   * them.
+   * @param offset log offset of the oldest record that recovery may read
+   */
+  void TruncateLog(int64_t offset);
+
+  /** @return the log offset where the log segments that have not been truncated begin */
+  int64_t GetLogStartOffset();
+
+  /** @return the log offset right after the last log record */
+  int64_t GetLogSize();
+
+  /** @return the number of bytes the log takes in the log segments, less than GetLogSize if it is compressed */
+  int64_t GetLogStoredSize();
 
   /**
    * Allocate a page on disk.
@@ -101,9 +134,65 @@ class DiskManager {
   inline bool HasFlushLogFuture() { return flush_log_f_ != nullptr; }
 
  private:
-  int GetFileSize(const std::string &file_name);
-  // stream to write log file
+  int64_t GetFileSize(const std::string &file_name);
+  std::string GetSegmentName(int segment);
+  void OpenSegment(int segment);
+  void LoadLogBlocks();
+  bool ReadLogBlock(size_t block);
+
+  /**
+   * The log file only holds a header:
+   * ----------------------------------------------
+   * | master record (8) | first log segment (4) |
+   * ----------------------------------------------
+   * Segment n covers the positions [n * log_segment_size_, (n + 1) * log_segment_size_) of the stored log. Every
+   * WriteLog stores one log block, a block never spans two segments:
+   * -------------------------------------------------------
+   * | log offset (8) | size (4) | stored size (4) | data |
+   * -------------------------------------------------------
+   * The data is compressed with CompressionUtil if the stored size is less than the size. Log offsets are 64 bit,
+   * the log grows past 2 GB long before its segments are recycled.
+   */
+  static constexpr int OFFSET_MASTER_RECORD = 0;
+  static constexpr int OFFSET_FIRST_SEGMENT = 8;
+
+  /** The header in front of the data of a log block. */
+  struct LogBlockHeader {
+    int64_t offset_;
+    int32_t size_;
+    int32_t stored_size_;
+  };
+  static constexpr int LOG_BLOCK_HEADER_SIZE = sizeof(LogBlockHeader);
+  static_assert(LOG_BLOCK_HEADER_SIZE == 16, "the log block header must not have padding");
+
+  /** Where a log block is stored, log offsets are the offsets in the uncompressed log. */
+  struct LogBlock {
+    int64_t offset_;
+    int size_;
+    int stored_size_;
+    /** Position of the block header in the stored log. */
+    int64_t position_;
+  };
+
+  // stream to write log file header
   std::fstream log_io_;
+  // stream to write the last log segment
+  std::fstream segment_io_;
+  int open_segment_ = -1;
+  int log_segment_size_;
+  int first_segment_ = 0;
+  int64_t log_size_ = 0;
+  // the blocks in the segments that have not been truncated, in log order
+  std::vector<LogBlock> log_blocks_;
+  // position in the stored log the next block is written at
+  int64_t write_position_ = 0;
+  // the block most recently read, decompressed, so that small reads do not decompress the same block again
+  std::vector<char> block_buffer_;
+  int64_t cached_block_offset_ = -1;
+  // where WriteLog compresses a block, only used by the flush thread
+  std::vector<char> compress_buffer_;
+  // protects the log streams and the segment bookkeeping, the flush thread and the checkpoint both use them
+  std::mutex log_latch_;
   std::string log_name_;
   // stream to write db file
   std::fstream db_io_;
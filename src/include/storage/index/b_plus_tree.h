@@ -0,0 +1,179 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree.h
+//
+// Identification: src/include/storage/index/b_plus_tree.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rwlatch.h"
+#include "concurrency/transaction.h"
+#include "storage/index/generic_key.h"
+#include "storage/index/index_iterator.h"
+#include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+namespace bustub {
+
+#define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
+
+/**
+ * Implementation of a B+ tree that is backed by a buffer pool manager. Duplicate keys are supported, a (key, value)
+ * pair is stored once. Supports insert, remove, point lookups and range scans with forward iterators. The leaves
+ * are linked from left to right.
+ *
+ * Concurrency uses latch crabbing. Lookups read latch a child before they release its parent. Inserts and removes
+ * write latch their path and release the pages above a child that is safe, i.e. that does not split or underflow,
+ * so that a split or merge only reaches pages that are still latched. The root latch protects the root page id and
+ * is released with the pages above the first safe child. Neighbouring pages are always latched from left to right.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTree {
+  using InternalPage = BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>;
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+
+ public:
+  /**
+   * Creates a new, empty BPlusTree
+   *
+   * @param buffer_pool_manager buffer pool manager to be used
+   * @param comparator comparator for keys
+   * @param leaf_max_size number of entries at which a leaf is split
+   * @param internal_max_size number of children at which an internal page is split
+   */
+  explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+
+  /** @return true if the tree has no entries */
+  bool IsEmpty();
+
+  /**
+   * Inserts a key-value pair into the tree.
+   *
+   * @param key the key to insert
+   * @param value the value to be associated with the key
+   * @param transaction the current transaction
+   * @return true if the pair was inserted, false if the tree already has it
+   */
+  bool Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  /**
+   * Removes a key-value pair from the tree.
+   *
+   * @param key the key of the pair
+   * @param value the value of the pair
+   * @param transaction the current transaction
+   * @return true if the pair was removed, false if the tree does not have it
+   */
+  bool Remove(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  /**
+   * Performs a point lookup.
+   *
+   * @param key the key to look up
+   * @param[out] result the values of the key
+   * @param transaction the current transaction
+   * @return true if the key has at least one value
+   */
+  bool GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr);
+
+  /**
+   * Builds an empty tree bottom up from many entries at once. The leaves are filled from the sorted entries and
+   * chained, then each level of internal pages is filled from the first entries of the pages below it. The pages of
+   * a level are as full as the max sizes allow, with the entries spread evenly over them.
+   *
+   * @param entries the entries, sorted and deduplicated in place unless they are sorted already
+   * @param transaction the current transaction
+   * @return false if the tree is not empty, nothing is inserted then
+   */
+  bool BulkLoad(std::vector<MappingType> *entries, Transaction *transaction = nullptr);
+
+  /** Deletes all pages of the tree, which is empty afterwards. */
+  void Drop();
+
+  /** @return an iterator at the first entry of the tree */
+  INDEXITERATOR_TYPE Begin();
+
+  /** @return an iterator at the first entry whose key is not smaller than key */
+  INDEXITERATOR_TYPE Begin(const KeyType &key);
+
+  /** @return the iterator past the last entry */
+  INDEXITERATOR_TYPE End();
+
+  /** @return the page id of the root, INVALID_PAGE_ID if the tree is empty */
+  page_id_t GetRootPageId();
+
+  /**
+   * Checks that the entries are in order within and across pages, that every page other than the root is at least
+   * half full, and that all leaves are at the same depth. Not thread safe, for tests.
+   * @return the number of entries in the tree, -1 if the tree is broken
+   */
+  int VerifyIntegrity();
+
+ private:
+  enum class Operation { SEARCH, INSERT, REMOVE };
+
+  /**
+   * The pages a writer holds latched on its way down, from the first page that may change to the leaf, and whether
+   * it holds the root latch, because the root page id may change as well.
+   */
+  struct LatchPath {
+    bool root_latched{false};
+    std::vector<Page *> pages;
+  };
+
+  /**
+   * Descends from the root to the leaf that holds (key, value), or the first entry of key if value is nullptr.
+   * Searches return the leaf read latched and hold no other latch. Writers return with the root latch and the
+   * pages in path latched as described there, the leaf last.
+   * @return the leaf, nullptr if the tree is empty
+   */
+  Page *findLeaf(const KeyType &key, const ValueType *value, Operation op, LatchPath *path);
+
+  /** Descends to the leftmost leaf, returns it read latched or nullptr if the tree is empty. */
+  Page *findFirstLeaf();
+
+  bool isSafe(BPlusTreePage *node, Operation op, bool is_root);
+  /** Releases the root latch and the pages of the path. */
+  void releasePath(LatchPath *path, bool dirty);
+
+  /** Creates a new page of the tree, initialized as a leaf or internal page. */
+  Page *newTreePage(bool leaf);
+
+  /** Splits the overfull page at level of the path and inserts the separator into its parent, up to the root. */
+  void splitUp(LatchPath *path, size_t level);
+
+  /** Merges or refills the underfull page at level of the path from a sibling, up to the root. */
+  void mergeUp(LatchPath *path, size_t level);
+
+  /** Drops a root that has no entries or only one child, returns true if it was dropped. */
+  bool adjustRoot(Page *root);
+
+  /** Deletes the page and the pages below it. */
+  void dropPage(page_id_t page_id);
+  void verifyPage(page_id_t page_id, int depth, int *leaf_depth, const MappingType *low, const MappingType *high,
+                  int *num_entries, bool *valid);
+  /** @return a negative value, zero, or a positive value if lhs is smaller, equal or larger than rhs */
+  int compareEntries(const MappingType &lhs, const MappingType &rhs);
+
+  // member variable
+  std::string index_name_;
+  page_id_t root_page_id_{INVALID_PAGE_ID};
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+  int leaf_max_size_;
+  int internal_max_size_;
+  ReaderWriterLatch root_latch_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_index.h
+//
+// Identification: src/include/storage/index/b_plus_tree_index.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/index.h"
+
+namespace bustub {
+
+#define BPLUSTREE_INDEX_TYPE BPlusTreeIndex<KeyType, ValueType, KeyComparator>
+
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTreeIndex : public Index {
+ public:
+  BPlusTreeIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager);
+
+  ~BPlusTreeIndex() override = default;
+
+  bool InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+  bool BulkLoad(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) override;
+
+  void Drop(Transaction *transaction) override { container_.Drop(); }
+
+  void ScanRange(const Tuple *low_key, const Tuple *high_key, std::vector<RID> *result,
+                 Transaction *transaction) override;
+
+  INDEXITERATOR_TYPE GetBeginIterator();
+
+  INDEXITERATOR_TYPE GetBeginIterator(const KeyType &key);
+
+  INDEXITERATOR_TYPE GetEndIterator();
+
+ protected:
+  // comparator for key
+  KeyComparator comparator_;
+  // container
+  BPlusTree<KeyType, ValueType, KeyComparator> container_;
+};
+
+}  // namespace bustub
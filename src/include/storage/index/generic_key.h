@@ -13,9 +13,14 @@
 #pragma once
 
 #include <cstring>
+#include <string>
 
+#include "common/macros.h"
+#include "container/hash/hash_function.h"
 #include "storage/table/tuple.h"
+#include "type/type.h"
 #include "type/value.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
@@ -25,39 +30,134 @@ namespace bustub {
  * This key type uses an fixed length array to hold data for indexing
  * purposes, the actual size of which is specified and instantiated
  * with a template argument.
+ *
+ * The key is stored normalized, so that comparing two keys byte by byte orders them like their values:
+ * - integers are stored big endian with the sign bit flipped, timestamps big endian
+ * - decimals have all bits flipped if they are negative and the sign bit set otherwise
+ * - varchars are stored as a null marker, their bytes with every 0 byte escaped as 0 0xff, and a 0 0 terminator
+ * The null of a fixed size type is its smallest value, or the largest for timestamps, so it needs no marker. A key
+ * that does not fit into KeySize bytes is cut off, so it would compare equal to the keys that share the prefix that
+ * fits. SetFromKey reports such a key, the indexes refuse to store it and find no entries for it.
  */
 template <size_t KeySize>
 class GenericKey {
  public:
-  inline void SetFromKey(const Tuple &tuple) {
+  /** @return false if the key needs more than KeySize bytes, it is then cut off */
+  inline bool SetFromKey(const Tuple &tuple, const Schema *key_schema) {
     // intialize to 0
     memset(data_, 0, KeySize);
-    memcpy(data_, tuple.GetData(), tuple.GetLength());
+    size_t offset = 0;
+    for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+      const Value value = tuple.GetValue(key_schema, i);
+      switch (value.GetTypeId()) {
+        case TypeId::BOOLEAN:
+        case TypeId::TINYINT:
+          putSigned(&offset, value.GetAs<int8_t>(), sizeof(int8_t));
+          break;
+        case TypeId::SMALLINT:
+          putSigned(&offset, value.GetAs<int16_t>(), sizeof(int16_t));
+          break;
+        case TypeId::INTEGER:
+          putSigned(&offset, value.GetAs<int32_t>(), sizeof(int32_t));
+          break;
+        case TypeId::BIGINT:
+          putSigned(&offset, value.GetAs<int64_t>(), sizeof(int64_t));
+          break;
+        case TypeId::DECIMAL: {
+          uint64_t bits;
+          auto decimal = value.GetAs<double>();
+          memcpy(&bits, &decimal, sizeof(bits));
+          putUnsigned(&offset, (bits >> 63) != 0 ? ~bits : bits | (1ULL << 63), sizeof(bits));
+          break;
+        }
+        case TypeId::TIMESTAMP:
+          putUnsigned(&offset, value.GetAs<uint64_t>(), sizeof(uint64_t));
+          break;
+        case TypeId::VARCHAR: {
+          if (value.IsNull()) {
+            putUnsigned(&offset, 0, 1);
+            break;
+          }
+          putUnsigned(&offset, 1, 1);
+          for (char c : value.ToString()) {
+            putUnsigned(&offset, static_cast<uint8_t>(c), 1);
+            if (c == '\0') {
+              putUnsigned(&offset, 0xff, 1);
+            }
+          }
+          putUnsigned(&offset, 0, 2);
+          break;
+        }
+        default:
+          UNREACHABLE("Cannot index a column of this type.");
+      }
+    }
+    return offset <= KeySize;
   }
 
   // NOTE: for test purpose only
+  // encodes the key as a single BIGINT column
   inline void SetFromInteger(int64_t key) {
     memset(data_, 0, KeySize);
-    memcpy(data_, &key, sizeof(int64_t));
+    size_t offset = 0;
+    putSigned(&offset, key, sizeof(int64_t));
   }
 
+  /** Decodes the value of a column of the key, a value that was cut off decodes as far as it fits. */
   inline Value ToValue(Schema *schema, uint32_t column_idx) const {
-    const char *data_ptr;
-    const auto &col = schema->GetColumn(column_idx);
-    const TypeId column_type = col.GetType();
-    const bool is_inlined = col.IsInlined();
-    if (is_inlined) {
-      data_ptr = (data_ + col.GetOffset());
-    } else {
-      int32_t offset = *reinterpret_cast<int32_t *>(const_cast<char *>(data_ + col.GetOffset()));
-      data_ptr = (data_ + offset);
+    size_t offset = 0;
+    for (uint32_t i = 0;; i++) {
+      const TypeId column_type = schema->GetColumn(i).GetType();
+      if (column_type == TypeId::VARCHAR) {
+        bool is_null = getUnsigned(&offset, 1) == 0;
+        std::string str;
+        while (!is_null && offset < KeySize) {
+          auto c = static_cast<char>(getUnsigned(&offset, 1));
+          if (c == '\0' && getUnsigned(&offset, 1) == 0) {
+            break;
+          }
+          str.push_back(c);
+        }
+        if (i == column_idx) {
+          return is_null ? ValueFactory::GetNullValueByType(TypeId::VARCHAR) : ValueFactory::GetVarcharValue(str);
+        }
+        continue;
+      }
+      const size_t width = Type::GetTypeSize(column_type);
+      const uint64_t bits = getUnsigned(&offset, width);
+      if (i < column_idx) {
+        continue;
+      }
+      const uint64_t sign_bit = 1ULL << (8 * width - 1);
+      switch (column_type) {
+        case TypeId::BOOLEAN:
+          return Value(column_type, static_cast<int8_t>(bits ^ sign_bit));
+        case TypeId::TINYINT:
+          return ValueFactory::GetTinyIntValue(static_cast<int8_t>(bits ^ sign_bit));
+        case TypeId::SMALLINT:
+          return ValueFactory::GetSmallIntValue(static_cast<int16_t>(bits ^ sign_bit));
+        case TypeId::INTEGER:
+          return ValueFactory::GetIntegerValue(static_cast<int32_t>(bits ^ sign_bit));
+        case TypeId::BIGINT:
+          return ValueFactory::GetBigIntValue(static_cast<int64_t>(bits ^ sign_bit));
+        case TypeId::DECIMAL: {
+          uint64_t decimal_bits = (bits & sign_bit) != 0 ? bits & ~sign_bit : ~bits;
+          double decimal;
+          memcpy(&decimal, &decimal_bits, sizeof(decimal));
+          return ValueFactory::GetDecimalValue(decimal);
+        }
+        default:
+          return ValueFactory::GetTimestampValue(bits);
+      }
     }
-    return Value::DeserializeFrom(data_ptr, column_type);
   }
 
   // NOTE: for test purpose only
-  // interpret the first 8 bytes as int64_t from data vector
-  inline int64_t ToString() const { return *reinterpret_cast<int64_t *>(const_cast<char *>(data_)); }
+  // interpret the first 8 bytes as a BIGINT column
+  inline int64_t ToString() const {
+    size_t offset = 0;
+    return static_cast<int64_t>(getUnsigned(&offset, sizeof(int64_t)) ^ (1ULL << 63));
+  }
 
   // NOTE: for test purpose only
   // interpret the first 8 bytes as int64_t from data vector
@@ -68,39 +168,67 @@ class GenericKey {
 
   // actual location of data, extends past the end.
   char data_[KeySize];
+
+ private:
+  /** Appends the lower width bytes of bits, most significant first, as far as they fit. The offset counts all. */
+  inline void putUnsigned(size_t *offset, uint64_t bits, size_t width) {
+    for (size_t shift = 8 * width; shift > 0; shift -= 8, (*offset)++) {
+      if (*offset < KeySize) {
+        data_[*offset] = static_cast<char>(bits >> (shift - 8));
+      }
+    }
+  }
+
+  inline void putSigned(size_t *offset, int64_t value, size_t width) {
+    putUnsigned(offset, static_cast<uint64_t>(value) ^ (1ULL << (8 * width - 1)), width);
+  }
+
+  /** Reads width bytes as written by putUnsigned, the bytes past the key read as 0. */
+  inline uint64_t getUnsigned(size_t *offset, size_t width) const {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < width; i++, (*offset)++) {
+      bits = (bits << 8) | (*offset < KeySize ? static_cast<uint8_t>(data_[*offset]) : 0);
+    }
+    return bits;
+  }
 };
 
 /**
  * Function object returns true if lhs < rhs, used for trees
+ *
+ * The keys are normalized by GenericKey::SetFromKey, so a single memcmp compares them. The key schema is not needed
+ * for that, it is still taken so that the comparator can be swapped for one that compares the values.
  */
 template <size_t KeySize>
 class GenericComparator {
  public:
   inline int operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const {
-    uint32_t column_count = key_schema_->GetColumnCount();
+    return memcmp(lhs.data_, rhs.data_, KeySize);
+  }
 
-    for (uint32_t i = 0; i < column_count; i++) {
-      Value lhs_value = (lhs.ToValue(key_schema_, i));
-      Value rhs_value = (rhs.ToValue(key_schema_, i));
+  // constructor
+  explicit GenericComparator(Schema *key_schema) {}
+};
 
-      if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
-        return -1;
-      }
-      if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) {
-        return 1;
+/**
+ * Hashes a GenericKey up to its last 8 bytes that are not all 0, so that a short key in a large KeySize costs no more
+ * than its length. Equal keys have the same bytes, so they are cut at the same length.
+ */
+template <size_t KeySize, typename Family>
+class HashFunction<GenericKey<KeySize>, Family> {
+ public:
+  virtual ~HashFunction() = default;
+
+  virtual uint64_t GetHash(const GenericKey<KeySize> &key) {
+    size_t length = KeySize;
+    for (uint64_t word; length >= sizeof(word); length -= sizeof(word)) {
+      memcpy(&word, key.data_ + length - sizeof(word), sizeof(word));
+      if (word != 0) {
+        break;
       }
     }
-    // equals
-    return 0;
+    return Family::Hash(key.data_, length);
   }
-
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
-
-  // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
-
- private:
-  Schema *key_schema_;
 };
 
 }  // namespace bustub
@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "common/exception.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -126,17 +127,62 @@ class Index {
     return os.str();
   }
 
+  // check that a tuple of the table has the key. A lookup rechecks the tuples it fetches, since an entry may outlive
+  // the tuple it was made for, whose slot then holds another one.
+  bool HasKey(const Tuple &key, const Tuple &table_tuple, const Schema &table_schema) const {
+    Tuple table_key = table_tuple.KeyFromTuple(table_schema, *GetKeySchema(), GetKeyAttrs());
+    for (uint32_t i = 0; i < GetKeySchema()->GetColumnCount(); i++) {
+      if (key.GetValue(GetKeySchema(), i).CompareEquals(table_key.GetValue(GetKeySchema(), i)) != CmpBool::CmpTrue) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   ///////////////////////////////////////////////////////////////////
   // Point Modification
   ///////////////////////////////////////////////////////////////////
-  // designed for secondary indexes.
-  virtual void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) = 0;
+  // designed for secondary indexes. Returns false if the index has no room for the entry or the key does not fit
+  // into the keys of the index, an entry that is in the index already counts as inserted.
+  virtual bool InsertEntry(const Tuple &key, RID rid, Transaction *transaction) = 0;
 
   // delete the index entry linked to given tuple
   virtual void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) = 0;
 
   virtual void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) = 0;
 
+  // look up many keys at once, the rids of keys[i] go to (*results)[i]. Indexes that can overlap the lookups of a
+  // batch override it, the others scan the keys one by one.
+  virtual void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                        Transaction *transaction) {
+    results->resize(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+      ScanKey(keys[i], &(*results)[i], transaction);
+    }
+  }
+
+  // insert many entries at once, e.g. those of the table a new index is created on. Indexes that can build their
+  // pages in one pass override it, the others insert the entries one by one. Returns false if some entries found no
+  // room or their keys do not fit, the index then misses them.
+  virtual bool BulkLoad(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) {
+    bool complete = true;
+    for (const auto &entry : entries) {
+      complete = InsertEntry(entry.first, entry.second, transaction) && complete;
+    }
+    return complete;
+  }
+
+  // delete the pages of the index, e.g. of one the catalog refused, which is not used afterwards. Indexes that keep
+  // their entries in pages of the buffer pool override it.
+  virtual void Drop(Transaction *transaction) {}
+
+  // collect the rids of the keys between low_key and high_key, both included, in key order. A nullptr bound leaves
+  // the range open on that side. Only indexes that keep their keys in order support it.
+  virtual void ScanRange(const Tuple *low_key, const Tuple *high_key, std::vector<RID> *result,
+                         Transaction *transaction) {
+    throw NotImplementedException("the index does not support range scans");
+  }
+
  private:
   //===--------------------------------------------------------------------===//
   //  Data members
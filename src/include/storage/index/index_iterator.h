@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_iterator.h
+//
+// Identification: src/include/storage/index/index_iterator.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "buffer/buffer_pool_manager.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+namespace bustub {
+
+#define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
+
+/**
+ * Forward iterator over the entries of a B+ tree, in (key, value) order.
+ *
+ * The iterator keeps the leaf it points into pinned and read latched. It moves to the next leaf by latching that one
+ * before it releases the current one, in the same left to right order that writers latch neighbouring leaves in. A
+ * thread must not change the tree while it holds an iterator that is not at the end.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class IndexIterator {
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+
+ public:
+  /** Creates the end iterator. */
+  IndexIterator() = default;
+
+  /**
+   * @param buffer_pool_manager the buffer pool manager of the tree
+   * @param leaf the leaf to start in, pinned and read latched, nullptr for the end iterator
+   * @param index the index of the first entry in the leaf, may be the size of the leaf
+   */
+  IndexIterator(BufferPoolManager *buffer_pool_manager, Page *leaf, int index);
+  ~IndexIterator();
+
+  IndexIterator(IndexIterator &&other) noexcept;
+  IndexIterator &operator=(IndexIterator &&other) noexcept;
+  IndexIterator(const IndexIterator &other) = delete;
+  IndexIterator &operator=(const IndexIterator &other) = delete;
+
+  bool IsEnd() const { return leaf_ == nullptr; }
+
+  const MappingType &operator*() const;
+
+  IndexIterator &operator++();
+
+  bool operator==(const IndexIterator &itr) const { return leaf_ == itr.leaf_ && index_ == itr.index_; }
+
+  bool operator!=(const IndexIterator &itr) const { return !(*this == itr); }
+
+ private:
+  /** Moves on to the next leaf while the index is past the entries of the current one. */
+  void skipToEntry();
+  void release();
+
+  BufferPoolManager *buffer_pool_manager_{nullptr};
+  Page *leaf_{nullptr};
+  int index_{0};
+};
+
+}  // namespace bustub
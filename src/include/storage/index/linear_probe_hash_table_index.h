@@ -14,6 +14,8 @@
 
 #include <map>
 #include <string>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "container/hash/hash_function.h"
@@ -28,16 +30,38 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTableIndex : public Index {
  public:
   LinearProbeHashTableIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager, size_t num_buckets,
-                            const HashFunction<KeyType> &hash_fn);
+                            const HashFunction<KeyType> &hash_fn, LogManager *log_manager = nullptr);
 
   ~LinearProbeHashTableIndex() override = default;
 
-  void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+  bool InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
 
   void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                Transaction *transaction) override;
+
+  bool BulkLoad(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) override;
+
+  void Drop(Transaction *transaction) override { container_.Drop(); }
+
+  /**
+   * Keeps a Bloom filter of the keys that lookups of absent keys consult instead of the pages.
+   * @param bits_per_key the bits of the filter per entry, 0 to drop the filter
+   */
+  void EnableBloomFilter(size_t bits_per_key) { container_.EnableBloomFilter(bits_per_key); }
+
+  /**
+   * Deletes the entries that point at any of the tuples, whatever their keys, e.g. those of the inserts that undo
+   * rolled back after a crash.
+   * @param rids the tuples whose entries are deleted
+   */
+  void DeleteEntries(const std::unordered_set<RID> &rids, Transaction *transaction) {
+    container_.RemoveValues(transaction, [&](const RID &rid) { return rids.count(rid) != 0; });
+  }
+
  protected:
   // comparator for key
   KeyComparator comparator_;
@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_internal_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_internal_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
+#define INTERNAL_PAGE_HEADER_SIZE 20
+// one slot stays free, a child split into a full page goes in before the page is split
+#define INTERNAL_PAGE_SIZE \
+  (static_cast<int>((PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / sizeof(std::pair<MappingType, page_id_t>)) - 1)
+
+/**
+ * Internal page of the B+ tree, stores n child page ids and n - 1 separators between them.
+ *
+ * A separator is a whole leaf entry, so that the entries of a key that is repeated many times can be split over
+ * several leaves and still have one place in the tree. The child left of a separator holds the entries smaller than
+ * it, the child right of it the entries that are equal or larger. The separator at index 0 is not used.
+ *
+ * Internal page format (separators are stored in order):
+ * ----------------------------------------------------------------------------------
+ * | HEADER | INVALID_SEPARATOR + PAGE_ID(0) | SEPARATOR(1) + PAGE_ID(1) | ... | SEPARATOR(n - 1) + PAGE_ID(n - 1)
+ * ----------------------------------------------------------------------------------
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTreeInternalPage : public BPlusTreePage {
+ public:
+  /**
+   * Initializes a new internal page, with no children.
+   * @param page_id the id of the page
+   * @param max_size number of children at which the page is split
+   */
+  void Init(page_id_t page_id, int max_size = INTERNAL_PAGE_SIZE);
+
+  const MappingType &KeyAt(int index) const;
+  void SetKeyAt(int index, const MappingType &separator);
+  page_id_t ValueAt(int index) const;
+
+  /** @return the index of a child page, -1 if the page is no child of this page */
+  int ValueIndex(page_id_t page_id) const;
+
+  /**
+   * @param key the key to look for
+   * @param value the value to look for, nullptr to look for the first entry of the key
+   * @param comparator the comparator of the keys
+   * @return the index of the child that holds (key, value) if the tree has it
+   */
+  int ChildIndex(const KeyType &key, const ValueType *value, const KeyComparator &comparator) const;
+
+  /** Turns an empty page into a root with the two halves of a split page as children. */
+  void PopulateNewRoot(page_id_t old_page_id, const MappingType &separator, page_id_t new_page_id);
+
+  /** Inserts a separator and the child right of it at index, the page must have room for them. */
+  void InsertAt(int index, const MappingType &separator, page_id_t page_id);
+
+  /** Removes the child at index and the separator left of it. */
+  void RemoveAt(int index);
+
+  /**
+   * Moves the upper half of the children to an empty page.
+   * @return the separator between this page and the recipient, which goes up into the parent
+   */
+  MappingType MoveHalfTo(BPlusTreeInternalPage *recipient);
+
+  /**
+   * Appends all children to the page to the left.
+   * @param middle_separator the separator between both pages in the parent, it moves down into the recipient
+   */
+  void MoveAllTo(BPlusTreeInternalPage *recipient, const MappingType &middle_separator);
+
+  /**
+   * Moves the first child to the end of the page to the left.
+   * @param middle_separator the separator between both pages in the parent
+   * @return the new separator between both pages
+   */
+  MappingType MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const MappingType &middle_separator);
+
+  /**
+   * Moves the last child to the front of the page to the right.
+   * @param middle_separator the separator between both pages in the parent
+   * @return the new separator between both pages
+   */
+  MappingType MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const MappingType &middle_separator);
+
+ private:
+  std::pair<MappingType, page_id_t> array_[0];
+};
+
+}  // namespace bustub
@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_leaf_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_leaf_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
+#define LEAF_PAGE_HEADER_SIZE 24
+// one slot stays free, an insert into a full page goes in before the page is split
+#define LEAF_PAGE_SIZE (static_cast<int>((PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType)) - 1)
+
+/**
+ * Leaf page of the B+ tree, stores the entries of the tree in (key, value) order.
+ *
+ * The tree allows duplicate keys, an entry is identified by its key and its value. Entries with the same key are
+ * ordered by value, so that every entry has one place in the tree.
+ *
+ * Leaf page format (keys are stored in order):
+ * ----------------------------------------------------------------------
+ * | HEADER | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
+ * ----------------------------------------------------------------------
+ *
+ * Header format (size in byte, 24 bytes in total):
+ * ---------------------------------------------------------------------
+ * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
+ * ---------------------------------------------------------------------
+ * -----------------------------------------------
+ * | PageId (4) | NextPageId (4)
+ * -----------------------------------------------
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTreeLeafPage : public BPlusTreePage {
+ public:
+  /**
+   * Initializes a new leaf page, with no entries and no next page.
+   * @param page_id the id of the page
+   * @param max_size number of entries at which the page is split
+   */
+  void Init(page_id_t page_id, int max_size = LEAF_PAGE_SIZE);
+
+  /** @return the id of the leaf page to the right, INVALID_PAGE_ID for the last leaf */
+  page_id_t GetNextPageId() const;
+  void SetNextPageId(page_id_t next_page_id);
+
+  KeyType KeyAt(int index) const;
+  ValueType ValueAt(int index) const;
+  const MappingType &GetItem(int index) const;
+
+  /**
+   * @param key the key to look for
+   * @param value the value to look for, nullptr to look for the first entry of the key
+   * @param comparator the comparator of the keys
+   * @return the index of the first entry that is not smaller than (key, value), GetSize() if there is none
+   */
+  int KeyIndex(const KeyType &key, const ValueType *value, const KeyComparator &comparator) const;
+
+  /** @return true if the entry at index is (key, value) */
+  bool IsEntryAt(int index, const KeyType &key, const ValueType &value, const KeyComparator &comparator) const;
+
+  /** Inserts an entry before the entry at index, the page must have room for it. */
+  void InsertAt(int index, const KeyType &key, const ValueType &value);
+
+  /** Removes the entry at index. */
+  void RemoveAt(int index);
+
+  /** Moves the upper half of the entries to an empty page, which becomes the next page. */
+  void MoveHalfTo(BPlusTreeLeafPage *recipient);
+
+  /** Appends all entries to the page to the left, which takes over the next page. */
+  void MoveAllTo(BPlusTreeLeafPage *recipient);
+
+  /** Moves the first entry to the end of the page to the left. */
+  void MoveFirstToEndOf(BPlusTreeLeafPage *recipient);
+
+  /** Moves the last entry to the front of the page to the right. */
+  void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
+
+ private:
+  page_id_t next_page_id_;
+  MappingType array_[0];
+};
+
+}  // namespace bustub
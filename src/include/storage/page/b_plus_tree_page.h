@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+
+#include "common/config.h"
+
+namespace bustub {
+
+#define MappingType std::pair<KeyType, ValueType>
+
+#define INDEX_TEMPLATE_ARGUMENTS template <typename KeyType, typename ValueType, typename KeyComparator>
+
+enum class IndexPageType { INVALID_INDEX_PAGE = 0, LEAF_PAGE, INTERNAL_PAGE };
+
+/**
+ * Both internal and leaf pages of the B+ tree inherit from this page.
+ *
+ * Header format (size in byte, 20 bytes in total):
+ * --------------------------------------------------------------------
+ * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) | PageId (4) |
+ * --------------------------------------------------------------------
+ * The pages keep no parent page id. Writers hold the latches of every page they may change on the way down, so the
+ * parents a split or merge reaches are known without it.
+ */
+class BPlusTreePage {
+ public:
+  bool IsLeafPage() const;
+  void SetPageType(IndexPageType page_type);
+
+  /** @return the number of entries, for an internal page including the child without a separator */
+  int GetSize() const;
+  void SetSize(int size);
+  void IncreaseSize(int amount);
+
+  /** @return the number of entries at which the page is split */
+  int GetMaxSize() const;
+  void SetMaxSize(int max_size);
+  /** @return the number of entries below which a page other than the root is merged or borrows from a sibling */
+  int GetMinSize() const;
+
+  page_id_t GetPageId() const;
+  void SetPageId(page_id_t page_id);
+
+  lsn_t GetLSN() const;
+  void SetLSN(lsn_t lsn = INVALID_LSN);
+
+ private:
+  IndexPageType page_type_;
+  lsn_t lsn_;
+  int size_;
+  int max_size_;
+  page_id_t page_id_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter_page.h
+//
+// Identification: src/include/storage/page/bloom_filter_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * A page of the bits of a persisted BloomFilter, which spans a chain of these pages.
+ *
+ * Page format (size in byte, 28 bytes in total), followed by the words of the filter:
+ * ----------------------------------------------------------------------------------------
+ * | PageId (4) | LSN (4) | NextPageId (4) | NumWords (4) | NumKeys (8) | OwnerPageId (4)
+ * ----------------------------------------------------------------------------------------
+ *
+ * NumKeys and OwnerPageId are only set in the first page of a chain, they name what the filter was written for.
+ */
+class BloomFilterPage {
+ public:
+  /** Number of words of the filter that fit into a page. */
+  static constexpr uint32_t WORDS_PER_PAGE = (PAGE_SIZE - 28) / sizeof(uint32_t);
+
+  /** Initializes an empty page of a filter, the last one of its chain. */
+  void Init(page_id_t page_id);
+
+  /** @return the page ID of this page */
+  page_id_t GetPageId() const;
+
+  /** @return the next page of the filter, INVALID_PAGE_ID for the last one */
+  page_id_t GetNextPageId() const;
+
+  /** @param next_page_id the next page of the filter */
+  void SetNextPageId(page_id_t next_page_id);
+
+  /** @return the number of words of the filter stored in this page */
+  uint32_t GetNumWords() const;
+
+  /** @param num_words the number of words of the filter stored in this page, at most WORDS_PER_PAGE */
+  void SetNumWords(uint32_t num_words);
+
+  /** @return the number of keys the filter held when it was written */
+  uint64_t GetNumKeys() const;
+
+  /** @param num_keys the number of keys the filter held when it was written */
+  void SetNumKeys(uint64_t num_keys);
+
+  /** @return the page of the structure the filter was written for, INVALID_PAGE_ID if it no longer matches */
+  page_id_t GetOwnerPageId() const;
+
+  /** @param owner_page_id the page of the structure the filter was written for */
+  void SetOwnerPageId(page_id_t owner_page_id);
+
+  /** @return the words of the filter stored in this page */
+  uint32_t *GetWords();
+
+ private:
+  __attribute__((unused)) page_id_t page_id_;
+  __attribute__((unused)) lsn_t lsn_;
+  page_id_t next_page_id_;
+  uint32_t num_words_;
+  uint64_t num_keys_;
+  page_id_t owner_page_id_;
+  uint32_t words_[0];
+};
+
+}  // namespace bustub
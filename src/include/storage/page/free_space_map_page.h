@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_page.h
+//
+// Identification: src/include/storage/page/free_space_map_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * A page of a persisted FreeSpaceMap, which spans a chain of these pages. Each entry is a table page and the
+ * category of its free space, in one byte. The entries are in the order of the pages in the table.
+ *
+ * Page format (size in byte, 16 bytes in total), followed by the table page ids and then the categories:
+ * -------------------------------------------------------------
+ * | PageId (4) | LSN (4) | NextPageId (4) | NumEntries (4)
+ * -------------------------------------------------------------
+ */
+class FreeSpaceMapPage {
+ public:
+  /** Number of entries that fit into a page, each takes a page id and a category. */
+  static constexpr uint32_t ENTRIES_PER_PAGE = (PAGE_SIZE - 4 * sizeof(uint32_t)) / (sizeof(page_id_t) + 1);
+
+  /** Initializes an empty page of a map, the last one of its chain. */
+  void Init(page_id_t page_id);
+
+  /** @return the page ID of this page */
+  page_id_t GetPageId() const;
+
+  /** @return the next page of the map, INVALID_PAGE_ID for the last one */
+  page_id_t GetNextPageId() const;
+
+  /** @param next_page_id the next page of the map */
+  void SetNextPageId(page_id_t next_page_id);
+
+  /** @return the number of entries stored in this page */
+  uint32_t GetNumEntries() const;
+
+  /** @param num_entries the number of entries stored in this page, at most ENTRIES_PER_PAGE */
+  void SetNumEntries(uint32_t num_entries);
+
+  /** @return the table page of the entry at index */
+  page_id_t TablePageIdAt(uint32_t index) const;
+
+  /** @return the free space category of the entry at index */
+  uint8_t CategoryAt(uint32_t index) const;
+
+  /** Sets the entry at index. */
+  void SetEntryAt(uint32_t index, page_id_t table_page_id, uint8_t category);
+
+  /** Sets the free space category of the entry at index. */
+  void SetCategoryAt(uint32_t index, uint8_t category);
+
+ private:
+  __attribute__((unused)) page_id_t page_id_;
+  __attribute__((unused)) lsn_t lsn_;
+  page_id_t next_page_id_;
+  uint32_t num_entries_;
+  page_id_t table_page_ids_[ENTRIES_PER_PAGE];
+  uint8_t categories_[ENTRIES_PER_PAGE];
+};
+
+static_assert(sizeof(FreeSpaceMapPage) <= PAGE_SIZE);
+
+}  // namespace bustub
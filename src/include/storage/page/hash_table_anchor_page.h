@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_anchor_page.h
+//
+// Identification: src/include/storage/page/hash_table_anchor_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * Anchor Page for linear probing hash table. It is allocated once with the hash table and points at the header page
+ * of the current table, which a resize or a bulk load replaces, so that the hash table opens again from the anchor.
+ *
+ * Page format (size in byte, 16 bytes in total):
+ * -------------------------------------------------------------
+ * | PageId (4) | LSN (4) | HeaderPageId (4) | OldHeaderPageId (4)
+ * -------------------------------------------------------------
+ * OldHeaderPageId is the header page of the table a resize in progress drains, INVALID_PAGE_ID if there is none.
+ */
+class HashTableAnchorPage {
+ public:
+  /** @return the page ID of this page */
+  page_id_t GetPageId() const;
+
+  /** @param page_id the page ID of this page */
+  void SetPageId(page_id_t page_id);
+
+  /** @return the lsn of this page */
+  lsn_t GetLSN() const;
+
+  /** @param lsn the log sequence number of the latest change of this page */
+  void SetLSN(lsn_t lsn);
+
+  /** @return the header page of the table that takes the inserts */
+  page_id_t GetHeaderPageId() const;
+
+  /** @param header_page_id the header page of the table that takes the inserts */
+  void SetHeaderPageId(page_id_t header_page_id);
+
+  /** @return the header page of the table being drained by a resize, INVALID_PAGE_ID if there is none */
+  page_id_t GetOldHeaderPageId() const;
+
+  /** @param old_header_page_id the header page of the table being drained by a resize, or INVALID_PAGE_ID */
+  void SetOldHeaderPageId(page_id_t old_header_page_id);
+
+ private:
+  __attribute__((unused)) page_id_t page_id_;
+  __attribute__((unused)) lsn_t lsn_;
+  page_id_t header_page_id_;
+  page_id_t old_header_page_id_;
+};
+
+}  // namespace bustub
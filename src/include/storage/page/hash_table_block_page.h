@@ -13,6 +13,7 @@
 #pragma once
 
 #include <atomic>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -28,19 +29,35 @@ namespace bustub {
  * non-unique keys.
  *
  * Block page format (keys are stored in order):
- *  ----------------------------------------------------------------
- * | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
- *  ----------------------------------------------------------------
+ *  ---------------------------------------------------------------------------------------------------
+ * | PageId (4) | LSN (4) | occupied | readable | tags | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
+ *  ---------------------------------------------------------------------------------------------------
  *
- *  Here '+' means concatenation.
+ *  Here '+' means concatenation. The LSN is at the same offset as in every other page, so that the buffer pool
+ *  writes the log ahead of the page.
+ *
+ *  Every slot has a one byte tag taken from the hash of its key. A probe compares the tags of TAG_GROUP_SIZE slots at
+ *  once, with AVX2 or SSE2 where available, and only compares the keys of the slots whose tag matches.
  *
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class HashTableBlockPage {
  public:
+#if defined(__AVX2__)
+  static constexpr uint32_t TAG_GROUP_SIZE = 32;
+#else
+  static constexpr uint32_t TAG_GROUP_SIZE = 16;
+#endif
+
   // Delete all constructor / destructor to ensure memory safety
   HashTableBlockPage() = delete;
 
+  /**
+   * @param hash the hash of a key
+   * @return the tag of the key, taken from the bits of the hash that select the slot the least
+   */
+  static uint8_t TagOf(uint64_t hash) { return static_cast<uint8_t>(hash >> 56); }
+
   /**
    * Gets the key at an index in the block.
    *
@@ -66,11 +83,12 @@ class HashTableBlockPage {
    * @param bucket_ind index to write the key and value to
    * @param key key to insert
    * @param value value to insert
+   * @param tag the tag of the key
    * @return If the value is inserted successfully, it returns true. If the
    * index is marked as occupied before the key and value can be inserted,
    * Insert returns false.
    */
-  bool Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value);
+  bool Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value, uint8_t tag);
 
   /**
    * Removes a key and value at index.
@@ -79,6 +97,14 @@ class HashTableBlockPage {
    */
   void Remove(slot_offset_t bucket_ind);
 
+  /**
+   * Frees a removed slot, i.e. turns its tombstone into a slot that was never occupied. Only valid if no probe
+   * needs to go past the slot anymore.
+   *
+   * @param bucket_ind index of a slot that is not readable
+   */
+  void Free(slot_offset_t bucket_ind);
+
   /**
    * Returns whether or not an index is occupied (key/value pair or tombstone)
    *
@@ -95,11 +121,74 @@ class HashTableBlockPage {
    */
   bool IsReadable(slot_offset_t bucket_ind) const;
 
+  /**
+   * @param bucket_ind index to look at
+   * @return the tag of the key at the index
+   */
+  uint8_t TagAt(slot_offset_t bucket_ind) const;
+
+  /**
+   * Probes a group of slots at once, up to the first unoccupied slot, which ends every probe.
+   *
+   * @param bucket_ind first slot of the group
+   * @param num_slots number of slots of the group, at most TAG_GROUP_SIZE and not beyond the block
+   * @param tag the tag of the key to look for
+   * @param[out] matches bit i is set if slot bucket_ind + i is part of the probe, readable and has the tag
+   * @param[out] free_slots bit i is set if slot bucket_ind + i is part of the probe and not readable
+   * @return the number of occupied slots from bucket_ind on, the probe ends within the group if it is below num_slots
+   */
+  uint32_t ProbeGroup(slot_offset_t bucket_ind, uint32_t num_slots, uint8_t tag, uint32_t *matches,
+                      uint32_t *free_slots) const;
+
+  /**
+   * Prefetches what ProbeGroup and the key comparisons of its matches read, i.e. the flags, the tags and the first
+   * pairs from bucket_ind on, into the cache. The caller need not hold the page latched, it is a hint only.
+   *
+   * @param bucket_ind first slot of the group
+   */
+  void PrefetchGroup(slot_offset_t bucket_ind) const;
+
+  /**
+   * @return the change Insert makes to the page, as a PageDelta for the log
+   */
+  std::string InsertDelta(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value, uint8_t tag) const;
+
+  /**
+   * @return the change Remove makes to the page, as a PageDelta for the log
+   */
+  std::string RemoveDelta(slot_offset_t bucket_ind) const;
+
+  /**
+   * @return the change Free makes to the page, as a PageDelta for the log
+   */
+  std::string FreeDelta(slot_offset_t bucket_ind) const;
+
+  /**
+   * @return the lsn of this page
+   */
+  lsn_t GetLSN() const;
+
+  /**
+   * Sets the LSN of this page
+   *
+   * @param lsn the log sequence number for the lsn field to be set to
+   */
+  void SetLSN(lsn_t lsn);
+
  private:
+  /** @return the position of a byte of this page in the page */
+  uint32_t OffsetOf(const void *ptr) const;
+
+  /** @return bit i set if the flag of slot bucket_ind + i is set in the bitmap, for the slots of a tag group */
+  static uint32_t FlagsAt(const std::atomic_char *bitmap, slot_offset_t bucket_ind);
+
+  __attribute__((unused)) page_id_t page_id_;
+  lsn_t lsn_;
   std::atomic_char occupied_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
 
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
   std::atomic_char readable_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
+  uint8_t tags_[BLOCK_ARRAY_SIZE];
   MappingType array_[0];
 };
 
@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_directory_page.h
+//
+// Identification: src/include/storage/page/hash_table_directory_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+/**
+ *
+ * Directory Page for extendible hash table.
+ *
+ * Directory format (size in byte):
+ * --------------------------------------------------------------------------------------------
+ * | PageId (4) | LSN (4) | GlobalDepth (4) | LocalDepths (512) | BucketPageIds (2048) | Free (1524)
+ * --------------------------------------------------------------------------------------------
+ * Entry i of the directory holds the bucket of the keys whose hash ends with the global depth low bits of i. A bucket
+ * of local depth d is shared by the 2^(global depth - d) entries that agree on the low d bits.
+ */
+class HashTableDirectoryPage {
+ public:
+  /**
+   * @return the page ID of this page
+   */
+  page_id_t GetPageId() const;
+
+  /**
+   * Sets the page ID of this page
+   *
+   * @param page_id the page id for the page id field to be set to
+   */
+  void SetPageId(page_id_t page_id);
+
+  /**
+   * @return the lsn of this page
+   */
+  lsn_t GetLSN() const;
+
+  /**
+   * Sets the LSN of this page
+   *
+   * @param lsn the log sequence number for the lsn field to be set to
+   */
+  void SetLSN(lsn_t lsn);
+
+  /**
+   * @return the number of low hash bits that select a directory entry
+   */
+  uint32_t GetGlobalDepth() const;
+
+  /**
+   * @return the mask of the low hash bits that select a directory entry
+   */
+  uint32_t GetGlobalDepthMask() const;
+
+  /**
+   * Doubles the directory, the new upper half points to the same buckets as the lower half.
+   */
+  void IncrGlobalDepth();
+
+  /**
+   * Halves the directory, only valid if CanShrink.
+   */
+  void DecrGlobalDepth();
+
+  /**
+   * @return true if no bucket uses all the bits of the global depth
+   */
+  bool CanShrink() const;
+
+  /**
+   * @return the number of entries of the directory
+   */
+  uint32_t Size() const;
+
+  /**
+   * @param bucket_idx index of a directory entry
+   * @return the page id of the bucket of the entry
+   */
+  page_id_t GetBucketPageId(uint32_t bucket_idx) const;
+
+  /**
+   * Sets the bucket of a directory entry
+   *
+   * @param bucket_idx index of a directory entry
+   * @param bucket_page_id page id of the bucket
+   */
+  void SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id);
+
+  /**
+   * @param bucket_idx index of a directory entry
+   * @return the local depth of the bucket of the entry
+   */
+  uint32_t GetLocalDepth(uint32_t bucket_idx) const;
+
+  /**
+   * Sets the local depth of a directory entry
+   *
+   * @param bucket_idx index of a directory entry
+   * @param local_depth the local depth of the bucket of the entry
+   */
+  void SetLocalDepth(uint32_t bucket_idx, uint32_t local_depth);
+
+  /**
+   * @param bucket_idx index of a directory entry with a local depth of at least 1
+   * @return the index of the entry that differs from it in the highest bit of its local depth
+   */
+  uint32_t GetSplitImageIndex(uint32_t bucket_idx) const;
+
+  /**
+   * Asserts that every bucket has a local depth of at most the global depth and is shared by exactly the entries that
+   * its local depth asks for.
+   */
+  void VerifyIntegrity() const;
+
+ private:
+  __attribute__((unused)) page_id_t page_id_;
+  __attribute__((unused)) lsn_t lsn_;
+  uint32_t global_depth_;
+  uint8_t local_depths_[DIRECTORY_ARRAY_SIZE];
+  page_id_t bucket_page_ids_[DIRECTORY_ARRAY_SIZE];
+};
+
+}  // namespace bustub
@@ -26,10 +26,11 @@ namespace bustub {
  *
  * Header Page for linear probing hash table.
  *
- * Header format (size in byte, 16 bytes in total):
+ * Header format (size in byte, 24 bytes in total), followed by the page ids of the blocks:
  * -------------------------------------------------------------
- * | LSN (4) | Size (4) | PageId(4) | NextBlockIndex(4)
+ * | PageId (4) | LSN (4) | Size (8) | NextBlockIndex (8)
  * -------------------------------------------------------------
+ * The LSN is at the same offset as in every other page, so that the buffer pool writes the log ahead of the page.
  */
 class HashTableHeaderPage {
  public:
@@ -89,10 +90,15 @@ class HashTableHeaderPage {
    */
   size_t NumBlocks();
 
+  /**
+   * @return the number of bytes of the page in use, i.e. the header and the block page ids
+   */
+  size_t GetUsedSize();
+
  private:
+  __attribute__((unused)) page_id_t page_id_;
   __attribute__((unused)) lsn_t lsn_;
   __attribute__((unused)) size_t size_;
-  __attribute__((unused)) page_id_t page_id_;
   __attribute__((unused)) size_t next_ind_;
   __attribute__((unused)) page_id_t block_page_ids_[0];
 };
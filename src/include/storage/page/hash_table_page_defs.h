@@ -16,9 +16,18 @@
 
 /** BLOCK_ARRAY_SIZE is the number of (key, value) pairs that can be stored in   * a block page. It is an approximate
  * calculation based on the size of MappingType (which is a std::pair of KeyType and ValueType). For each key/value
- * pair, we need two additional bits for occupied_ and readable_. 4 * PAGE_SIZE / (4 * sizeof (MappingType) + 1) =
- * PAGE_SIZE/(sizeof (MappingType) + 0.25) because 0.25 bytes = 2 bits is the space required to maintain the occupied
- * and readable flags for a key value pair.*/
-#define BLOCK_ARRAY_SIZE (4 * PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+ * pair, we need two additional bits for occupied_ and readable_ and a byte for its tag. 4 * PAGE_SIZE / (4 * sizeof
+ * (MappingType) + 5) = PAGE_SIZE/(sizeof (MappingType) + 1.25) because 0.25 bytes = 2 bits is the space required to
+ * maintain the occupied and readable flags for a key value pair. The header of the block page is left out.*/
+#define BLOCK_ARRAY_SIZE (4 * (PAGE_SIZE - HASH_TABLE_BLOCK_HEADER_SIZE) / (4 * sizeof(MappingType) + 5))
+
+/** Size of the page id and the LSN in front of the flags of a block page. */
+#define HASH_TABLE_BLOCK_HEADER_SIZE 8
 
 #define HASH_TABLE_BLOCK_TYPE HashTableBlockPage<KeyType, ValueType, KeyComparator>
+
+/** Number of entries of the directory of an extendible hash table, a power of two that fits into a page. */
+#define DIRECTORY_ARRAY_SIZE 512
+
+/** The global depth at which the directory page is full. */
+#define MAX_GLOBAL_DEPTH 9
@@ -86,6 +86,10 @@ class Page {
   int pin_count_ = 0;
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
   bool is_dirty_ = false;
+  /** LSN at or before the first change that is not on disk yet, INVALID_LSN while the page is clean and unpinned. */
+  lsn_t rec_lsn_ = INVALID_LSN;
+  /** Log offset at or before the record with rec_lsn_. */
+  int64_t rec_offset_ = 0;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
 };
@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.h
+//
+// Identification: src/include/storage/table/free_space_map.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * FreeSpaceMap tracks how much free space each page of a table heap has, so that an insert finds a page with room
+ * without visiting the pages in between. The free space of a page is kept as a category of one byte, the number of
+ * whole CATEGORY_SIZE units free, which underestimates it: a page that the map picks always has room, and a page
+ * with more room than the map knows of is corrected when the page changes next.
+ *
+ * The pages are grouped by category, so that FindPage looks at the categories from the one the tuple needs upwards
+ * only, a constant number of steps whatever the size of the table.
+ *
+ * The map may be persisted into a chain of FreeSpaceMapPages, which every change is written through to. The pages
+ * are not logged: the map is a hint, and it is checked against the table before it is trusted.
+ */
+class FreeSpaceMap {
+ public:
+  /** Free space is counted in units of this many bytes, so that the category of any page fits into a byte. */
+  static constexpr uint32_t CATEGORY_SIZE = PAGE_SIZE / 256;
+  static constexpr uint32_t NUM_CATEGORIES = PAGE_SIZE / CATEGORY_SIZE;
+
+  /**
+   * Creates a map, either empty and kept in memory only, or read from the pages that Persist wrote.
+   * @param buffer_pool_manager the buffer pool manager of the pages of the map
+   * @param first_page_id the first page of a persisted map, INVALID_PAGE_ID for a new map
+   */
+  explicit FreeSpaceMap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id = INVALID_PAGE_ID);
+
+  /**
+   * Writes the map into a chain of new FreeSpaceMapPages, later changes are written into them as well.
+   * @return the first page of the chain
+   */
+  page_id_t Persist();
+
+  /** @return the first page of the map, INVALID_PAGE_ID unless it is persisted */
+  page_id_t GetFirstPageId();
+
+  /**
+   * Records the free space of a page of the table, and adds the page at the end of the map unless the map has it.
+   * @param table_page_id the page, which is the last one of the table if it is new
+   * @param free_space the bytes free in the page
+   */
+  void AddPage(page_id_t table_page_id, uint32_t free_space);
+
+  /** Records the free space of a page of the table, the map is left as it is if it does not have the page. */
+  void Update(page_id_t table_page_id, uint32_t free_space);
+
+  /**
+   * Finds a page with room for space bytes. Of the pages that have room, one with the least is picked, which keeps
+   * the pages with much room for large tuples.
+   * @return the page, INVALID_PAGE_ID if no page has room
+   */
+  page_id_t FindPage(uint32_t space);
+
+  /** @return the last page of the table that the map has, INVALID_PAGE_ID if it is empty */
+  page_id_t GetLastPageId();
+
+  /** @return the number of pages of the table in the map */
+  size_t GetNumPages();
+
+ private:
+  /** @return the category of a page with free_space bytes free */
+  static uint8_t categoryOf(uint32_t free_space) {
+    return static_cast<uint8_t>(std::min(free_space / CATEGORY_SIZE, NUM_CATEGORIES - 1));
+  }
+
+  /** Adds an entry at the end of the map in memory. */
+  void addEntry(page_id_t table_page_id, uint8_t category);
+
+  /** Moves the entry at ordinal into the group of its new category. */
+  void setCategory(uint32_t ordinal, uint8_t category);
+
+  /** Writes the entry at ordinal into the pages of the map, appending a page if it is the first one of its page. */
+  void writeEntry(uint32_t ordinal);
+
+  BufferPoolManager *buffer_pool_manager_;
+  std::mutex latch_;
+  /** The pages of the table in table order, and their categories. */
+  std::vector<page_id_t> table_page_ids_;
+  std::vector<uint8_t> categories_;
+  /** table page id -> ordinal, the position of the page in the map */
+  std::unordered_map<page_id_t, uint32_t> ordinals_;
+  /** buckets_[c]: the ordinals of the pages of category c */
+  std::vector<std::vector<uint32_t>> buckets_;
+  /** The position of each page in its bucket, by ordinal. */
+  std::vector<uint32_t> bucket_positions_;
+  /** The pages the map is persisted in, empty if it is kept in memory only. */
+  std::vector<page_id_t> map_page_ids_;
+};
+
+}  // namespace bustub
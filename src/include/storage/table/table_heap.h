@@ -12,9 +12,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <mutex>  // NOLINT
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
+#include "storage/table/free_space_map.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
 
@@ -22,7 +26,7 @@ namespace bustub {
 
 /**
  * TableHeap represents a physical table on disk.
- * This is just a doubly-linked list of pages.
+ * This is just a doubly-linked list of pages, and a free space map that inserts pick a page with room from.
  */
 class TableHeap {
   friend class TableIterator;
@@ -36,9 +40,11 @@ class TableHeap {
    * @param lock_manager the lock manager
    * @param log_manager the log manager
    * @param first_page_id the id of the first page
+   * @param free_space_map_page_id the id of the first page of the free space map, INVALID_PAGE_ID to rebuild the map
+   * from the pages of the table when it is first needed, which then is kept in memory only
    */
   TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-            page_id_t first_page_id);
+            page_id_t first_page_id, page_id_t free_space_map_page_id = INVALID_PAGE_ID);
 
   /**
    * Create a table heap with a transaction. (create table)
@@ -108,11 +114,27 @@ class TableHeap {
   /** @return the id of the first page of this table */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /** @return the id of the first page of the free space map, INVALID_PAGE_ID if it is kept in memory only */
+  page_id_t GetFreeSpaceMapPageId() { return free_space_map_.GetFirstPageId(); }
+
  private:
+  /** Adds the pages of the table that the free space map misses, once, before an insert uses the map first. */
+  void syncFreeSpaceMap();
+
+  /**
+   * Appends a new page to the chain. The caller holds the append latch.
+   * @return the new page, INVALID_PAGE_ID if the buffer pool has no room for it
+   */
+  page_id_t appendPage(Transaction *txn);
+
   BufferPoolManager *buffer_pool_manager_;
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+  FreeSpaceMap free_space_map_;
+  std::atomic<bool> free_space_map_synced_{false};
+  /** Serializes the appends of pages to the chain. */
+  std::mutex append_latch_;
 };
 
 }  // namespace bustub
@@ -37,6 +37,8 @@ class Tuple {
 
   friend class TmpTuplePage;
 
+  friend class TupleDelta;
+
  public:
   // Default constructor (to create a dummy tuple)
   Tuple() = default;
@@ -66,6 +68,9 @@ class Tuple {
   // deserialize tuple data(deep copy)
   void DeserializeFrom(const char *storage);
 
+  // deserialize tuple data(shallow copy), the tuple only points into storage, which must outlive it
+  void DeserializeViewFrom(const char *storage);
+
   // return RID of current tuple
   inline RID GetRid() const { return rid_; }
 
@@ -79,6 +84,9 @@ class Tuple {
   // checks the schema to see how to return the Value.
   Value GetValue(const Schema *schema, uint32_t column_idx) const;
 
+  // Get the key of an index from the tuple, key_attrs are the columns of the key in the tuple
+  Tuple KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs) const;
+
   // Is the column value null ?
   inline bool IsNull(const Schema *schema, uint32_t column_idx) const {
     Value value = GetValue(schema, column_idx);
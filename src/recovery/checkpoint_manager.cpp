@@ -12,20 +12,65 @@
 
 #include "recovery/checkpoint_manager.h"
 
+#include <algorithm>
+#include <utility>
+
+#include "common/macros.h"
+
 namespace bustub {
 
+CheckpointManager::~CheckpointManager() {
+  if (flush_thread_ != nullptr) {
+    flush_thread_->join();
+    delete flush_thread_;
+  }
+}
+
 void CheckpointManager::BeginCheckpoint() {
-  // Block all the transactions and ensure that both the WAL and all dirty buffer pool pages are persisted to disk,
-  // creating a consistent checkpoint. Do NOT allow transactions to resume at the end of this method, resume them
-  // in CheckpointManager::EndCheckpoint() instead. This is for grading purposes.
-  transaction_manager_->BlockAllTransactions();
-  log_manager_->SyncFlush(true);
-  buffer_pool_manager_->FlushAllPages();
+  // Log the tables of a fuzzy checkpoint while transactions keep running, then write out the pages that were dirty
+  // in the background. The checkpoint is completed in CheckpointManager::EndCheckpoint().
+  if (!enable_logging) {
+    buffer_pool_manager_->FlushAllPages();
+    return;
+  }
+  BUSTUB_ASSERT(flush_thread_ == nullptr, "The previous checkpoint has not ended.");
+  log_manager_->GetNextLSNAndOffset(&checkpoint_offset_);
+  LogRecord begin_record(INVALID_TXN_ID, INVALID_LSN, LogRecordType::BEGIN_CHECKPOINT);
+  log_manager_->AppendLogRecord(&begin_record);
+
+  // both tables are taken after BEGIN_CHECKPOINT, recovery sees every later change while reading the log from there
+  std::vector<DirtyPageEntry> dirty_pages = buffer_pool_manager_->GetDirtyPageTable();
+  std::vector<ActiveTxnEntry> active_txns = transaction_manager_->GetActiveTransactionTable();
+  // the dirty pages are written out before the checkpoint completes, only undo needs to go further back
+  truncate_offset_ = checkpoint_offset_;
+  for (auto &entry : active_txns) {
+    truncate_offset_ = std::min(truncate_offset_, entry.begin_offset_);
+  }
+  LogRecord end_record(std::move(active_txns), dirty_pages);
+  log_manager_->AppendLogRecord(&end_record);
+
+  flush_thread_ = new std::thread(&CheckpointManager::FlushDirtyPages, this, std::move(dirty_pages));
 }
 
 void CheckpointManager::EndCheckpoint() {
-  // Allow transactions to resume, completing the checkpoint.
-  transaction_manager_->ResumeTransactions();
+  // Wait for the dirty pages and the checkpoint records to reach the disk, then make recovery start from them.
+  if (flush_thread_ == nullptr) {
+    return;
+  }
+  flush_thread_->join();
+  delete flush_thread_;
+  flush_thread_ = nullptr;
+  log_manager_->SyncFlush(true);
+  log_manager_->WriteMasterRecord(checkpoint_offset_);
+  log_manager_->TruncateLog(truncate_offset_);
+}
+
+void CheckpointManager::FlushDirtyPages(std::vector<DirtyPageEntry> dirty_pages) {
+  for (auto &entry : dirty_pages) {
+    // the page may have been evicted and written out meanwhile
+    buffer_pool_manager_->FlushPage(entry.page_id_);
+    std::this_thread::yield();
+  }
 }
 
 }  // namespace bustub
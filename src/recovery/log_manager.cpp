@@ -12,24 +12,45 @@
 
 #include "recovery/log_manager.h"
 
+#include <utility>
+
+#include "common/macros.h"
+
 namespace bustub {
 
+/*
+ * Ask the flush thread to write out every log record appended so far. The returned future becomes ready once those
+ * records are persistent; if the flush_page is given and its LSN is already persistent, no flush is needed at all.
+ */
 std::future<void> LogManager::SyncFlush(bool wait_until_flush, Page *flush_page) {
-  if (promise_ != nullptr) {
-    while (!future_done_) {
+  std::promise<void> promise;
+  std::future<void> future = promise.get_future();
+
+  {
+    std::unique_lock<std::mutex> lock(latch_);
+    lsn_t target_lsn = flush_page == nullptr ? GetNextLSN() - 1 : flush_page->GetLSN();
+    if (target_lsn <= persistent_lsn_) {
+      promise.set_value();
+      return future;
+    }
+    // every record appended so far is in a sealed buffer once the current buffer is sealed, if the ring is full the
+    // flush thread seals it as soon as a buffer has been written out
+    bool sealed = SealLogBuffer();
+    uint64_t target_seq = sealed ? sealed_seq_ : sealed_seq_ + 1;
+    if (target_seq <= written_seq_) {
+      promise.set_value();
+      return future;
     }
-    delete promise_;
-    promise_ = nullptr;
+    if (flush_thread_ == nullptr) {
+      // recovery appends compensation records before the flush thread runs
+      FlushWithoutThread(&lock, target_seq);
+      promise.set_value();
+      return future;
+    }
+    flush_requested_ = flush_requested_ || !sealed;
+    flush_waiters_.emplace_back(target_seq, std::move(promise));
   }
-  future_done_ = false;
-  swap_done_ = false;
-  promise_ = new std::promise<void>();
-
-  // wait for swap notify
-  std::unique_lock<std::mutex> lk(latch_);
-  cv_.wait(lk, [&]() { return static_cast<bool>(swap_done_); });
-
-  std::future<void> future = promise_->get_future();
+  flush_cv_.notify_one();
 
   if (wait_until_flush) {
     future.wait();
@@ -47,39 +68,29 @@ std::future<void> LogManager::SyncFlush(bool wait_until_flush, Page *flush_page)
  * This thread runs forever until system shutdown/StopFlushThread
  */
 void LogManager::RunFlushThread() {
+  std::lock_guard<std::mutex> lg(latch_);
+  thread_run_forever_ = true;
   enable_logging = true;
 
+  // the thread starts once the latch is released
   flush_thread_ = new std::thread([&]() {
+    std::unique_lock<std::mutex> lock(latch_);
     while (thread_run_forever_) {
-      if (promise_ == nullptr || future_done_) {
-        continue;
-      }
-
-      // swap log buffer with flush buffer
-      char *tmp;
-      lsn_t tmp_lsn;
-      int32_t tmp_offset;
-
-      {
-        std::lock_guard<std::mutex> lk(latch_);
-        tmp = log_buffer_;
-        log_buffer_ = flush_buffer_;
-        flush_buffer_ = tmp;
-
-        tmp_lsn = next_lsn_ - 1;
-        tmp_offset = offset_;
-        offset_ = 0;
-        swap_done_ = true;
+      // sleep until a buffer is sealed or someone needs a flush, or flush periodically once log_timeout expires
+      flush_cv_.wait_for(lock, log_timeout, [&]() {
+        return flush_requested_ || sealed_seq_ > written_seq_ || !thread_run_forever_;
+      });
+      if (flush_requested_ || sealed_seq_ == written_seq_) {
+        flush_requested_ = !SealLogBuffer();
       }
-      // swap done, notify other thread
-      cv_.notify_one();
-
-      // flush log data to disk_manager
-      disk_manager_->WriteLog(flush_buffer_, tmp_offset);
-      SetPersistentLSN(tmp_lsn);
-      promise_->set_value();
-      future_done_ = true;
+      FlushSealedBuffers(&lock);
     }
+    // write out whatever is left before exiting
+    bool all_sealed;
+    do {
+      all_sealed = SealLogBuffer();
+      FlushSealedBuffers(&lock);
+    } while (!all_sealed);
   });
 }
 
@@ -87,10 +98,102 @@ void LogManager::RunFlushThread() {
  * Stop and join the flush thread, set enable_logging = false
  */
 void LogManager::StopFlushThread() {
-  thread_run_forever_ = false;
   enable_logging = false;
+  {
+    std::lock_guard<std::mutex> lg(latch_);
+    thread_run_forever_ = false;
+  }
+  flush_cv_.notify_one();
   flush_thread_->join();
+  std::lock_guard<std::mutex> lg(latch_);
   delete flush_thread_;
+  flush_thread_ = nullptr;
+}
+
+void LogManager::SetNextLSN(lsn_t next_lsn) {
+  uint64_t state = reserve_state_.load();
+  while (StateLSN(state) < next_lsn &&
+         !reserve_state_.compare_exchange_weak(state, (static_cast<uint64_t>(next_lsn) << 32) | (state & UINT32_MAX))) {
+  }
+  if (persistent_lsn_ < next_lsn - 1) {
+    SetPersistentLSN(next_lsn - 1);
+  }
+}
+
+bool LogManager::SealLogBuffer() {
+  uint64_t state = reserve_state_.load();
+  while (StateOffset(state) > 0 && HasFreeBuffer()) {
+    // the next buffer is not in use, it continues the log where the current one ends
+    buffers_[(StateBuffer(state) + 1) % NUM_BUFFERS].base_offset_ =
+        buffers_[StateBuffer(state)].base_offset_ + StateOffset(state);
+    // switch appenders to the next buffer in the ring, no slot can be reserved in the sealed one afterwards
+    if (reserve_state_.compare_exchange_weak(state, SealedState(state))) {
+      BUSTUB_ASSERT(StateSeq(state) == (sealed_seq_ & ((1U << SEQ_BITS) - 1)), "Only the current buffer is sealed.");
+      sealed_[sealed_seq_ % NUM_BUFFERS] = {StateOffset(state), StateLSN(state) - 1};
+      sealed_seq_++;
+      return true;
+    }
+  }
+  return StateOffset(state) == 0;
+}
+
+void LogManager::FlushSealedBuffers(std::unique_lock<std::mutex> *lock) {
+  flushing_ = true;
+  while (written_seq_ < sealed_seq_) {
+    SealedBuffer sealed = sealed_[written_seq_ % NUM_BUFFERS];
+    LogBuffer &buffer = buffers_[written_seq_ % NUM_BUFFERS];
+    lock->unlock();
+
+    // every slot in the sealed buffer has been reserved, wait until their appenders finish writing them
+    while (buffer.completed_.load(std::memory_order_acquire) != sealed.size_) {
+      std::this_thread::yield();
+    }
+    // flush log data to disk_manager
+    disk_manager_->WriteLog(buffer.data_, sealed.size_, compress_log_);
+    buffer.completed_.store(0, std::memory_order_relaxed);
+    SetPersistentLSN(sealed.last_lsn_);
+
+    lock->lock();
+    written_seq_++;
+    // wake up the SyncFlush callers whose records are all written
+    auto waiter = flush_waiters_.begin();
+    while (waiter != flush_waiters_.end()) {
+      if (waiter->first <= written_seq_) {
+        waiter->second.set_value();
+        waiter = flush_waiters_.erase(waiter);
+      } else {
+        ++waiter;
+      }
+    }
+    // the buffer is free again, appenders waiting for the ring may continue
+    append_cv_.notify_all();
+  }
+  flushing_ = false;
+}
+
+void LogManager::FlushWithoutThread(std::unique_lock<std::mutex> *lock, uint64_t target_seq) {
+  while (written_seq_ < target_seq) {
+    if (flushing_) {
+      // another appender is writing out the ring
+      append_cv_.wait(*lock);
+      continue;
+    }
+    SealLogBuffer();
+    FlushSealedBuffers(lock);
+  }
+}
+
+lsn_t LogManager::GetNextLSNAndOffset(int64_t *offset) {
+  uint64_t state = reserve_state_.load();
+  while (true) {
+    *offset = buffers_[StateBuffer(state)].base_offset_ + StateOffset(state);
+    // the buffer may have been reused for a later part of the log meanwhile
+    uint64_t current = reserve_state_.load();
+    if (StateSeq(current) == StateSeq(state)) {
+      return StateLSN(state);
+    }
+    state = current;
+  }
 }
 
 /*
@@ -114,44 +217,98 @@ void LogManager::StopFlushThread() {
  *
  */
 lsn_t LogManager::AppendLogRecord(LogRecord *log_record) {
-  if (offset_ + log_record->size_ > LOG_BUFFER_SIZE) {
-    // buffer is not enough
-    SyncFlush();
+  const uint32_t size = log_record->size_;
+  BUSTUB_ASSERT(size <= LOG_BUFFER_SIZE, "A log record must fit into a log buffer.");
+  // reserve the lsn and a slot in the current buffer together
+  uint64_t state = reserve_state_.load();
+  while (true) {
+    if (StateOffset(state) + size > LOG_BUFFER_SIZE) {
+      // buffer is not enough, seal it and continue in the next buffer of the ring
+      std::unique_lock<std::mutex> lock(latch_);
+      while (StateSeq(reserve_state_.load()) == StateSeq(state)) {
+        if (HasFreeBuffer()) {
+          SealLogBuffer();
+          flush_cv_.notify_one();
+          break;
+        }
+        // every buffer in the ring is waiting to be written
+        if (flush_thread_ == nullptr) {
+          FlushWithoutThread(&lock, written_seq_ + 1);
+        } else {
+          append_cv_.wait(lock);
+        }
+      }
+      state = reserve_state_.load();
+      continue;
+    }
+    if (reserve_state_.compare_exchange_weak(state, state + (1ULL << 32) + size)) {
+      break;
+    }
   }
 
-  std::lock_guard<std::mutex> lg(latch_);
-  log_record->lsn_ = next_lsn_++;
-  memcpy(log_buffer_ + offset_, &log_record->size_, 4);
-  memcpy(log_buffer_ + offset_ + 4, &log_record->lsn_, 4);
-  memcpy(log_buffer_ + offset_ + 8, &log_record->txn_id_, 4);
-  memcpy(log_buffer_ + offset_ + 12, &log_record->prev_lsn_, 4);
-  memcpy(log_buffer_ + offset_ + 16, &log_record->log_record_type_, 4);
-  uint64_t pos = offset_ + 20;
-
-  if (log_record->log_record_type_ == LogRecordType::INSERT) {
-    memcpy(log_buffer_ + pos, &log_record->insert_rid_, sizeof(RID));
+  // serialize into the reserved slot, other appenders are writing their own slots in parallel
+  LogBuffer &buffer = buffers_[StateBuffer(state)];
+  char *log_buffer = buffer.data_ + StateOffset(state);
+  log_record->lsn_ = StateLSN(state);
+  memcpy(log_buffer, &log_record->size_, 4);
+  memcpy(log_buffer + 4, &log_record->lsn_, 4);
+  memcpy(log_buffer + 8, &log_record->txn_id_, 4);
+  memcpy(log_buffer + 12, &log_record->prev_lsn_, 4);
+  memcpy(log_buffer + 16, &log_record->log_record_type_, 4);
+  uint64_t pos = 20;
+
+  // a compensation log record continues with the body of the change undo applied
+  LogRecordType body_type = log_record->log_record_type_;
+  if (body_type == LogRecordType::CLR) {
+    memcpy(log_buffer + pos, &log_record->undo_next_lsn_, sizeof(lsn_t));
+    pos += sizeof(lsn_t);
+    memcpy(log_buffer + pos, &log_record->compensation_type_, sizeof(LogRecordType));
+    pos += sizeof(LogRecordType);
+    body_type = log_record->compensation_type_;
+  }
+
+  if (body_type == LogRecordType::INSERT) {
+    memcpy(log_buffer + pos, &log_record->insert_rid_, sizeof(RID));
     pos += sizeof(RID);
-    log_record->insert_tuple_.SerializeTo(log_buffer_ + pos);
-  } else if (log_record->log_record_type_ == LogRecordType::MARKDELETE ||
-             log_record->log_record_type_ == LogRecordType::APPLYDELETE ||
-             log_record->log_record_type_ == LogRecordType::ROLLBACKDELETE) {
-    memcpy(log_buffer_ + pos, &log_record->delete_rid_, sizeof(RID));
+    log_record->insert_tuple_.SerializeTo(log_buffer + pos);
+  } else if (body_type == LogRecordType::MARKDELETE || body_type == LogRecordType::APPLYDELETE ||
+             body_type == LogRecordType::ROLLBACKDELETE) {
+    memcpy(log_buffer + pos, &log_record->delete_rid_, sizeof(RID));
     pos += sizeof(RID);
-    log_record->delete_tuple_.SerializeTo(log_buffer_ + pos);
-  } else if (log_record->log_record_type_ == LogRecordType::UPDATE) {
-    memcpy(log_buffer_ + pos, &log_record->update_rid_, sizeof(RID));
+    log_record->delete_tuple_.SerializeTo(log_buffer + pos);
+  } else if (body_type == LogRecordType::UPDATE) {
+    memcpy(log_buffer + pos, &log_record->update_rid_, sizeof(RID));
     pos += sizeof(RID);
-    log_record->old_tuple_.SerializeTo(log_buffer_ + pos);
-    // add old tuple size
-    pos += (sizeof(int32_t) + log_record->old_tuple_.GetLength());
-    log_record->new_tuple_.SerializeTo(log_buffer_ + pos);
-  } else if (log_record->log_record_type_ == LogRecordType::NEWPAGE) {
-    memcpy(log_buffer_ + pos, &log_record->prev_page_id_, sizeof(page_id_t));
+    int32_t delta_size = log_record->update_delta_.size();
+    memcpy(log_buffer + pos, &delta_size, sizeof(int32_t));
+    pos += sizeof(int32_t);
+    memcpy(log_buffer + pos, log_record->update_delta_.data(), delta_size);
+  } else if (body_type == LogRecordType::HASH_INSERT || body_type == LogRecordType::HASH_REMOVE ||
+             body_type == LogRecordType::HASH_HEADER) {
+    memcpy(log_buffer + pos, &log_record->page_id_, sizeof(page_id_t));
+    pos += sizeof(page_id_t);
+    int32_t delta_size = log_record->page_delta_.size();
+    memcpy(log_buffer + pos, &delta_size, sizeof(int32_t));
+    pos += sizeof(int32_t);
+    memcpy(log_buffer + pos, log_record->page_delta_.data(), delta_size);
+  } else if (body_type == LogRecordType::NEWPAGE) {
+    memcpy(log_buffer + pos, &log_record->prev_page_id_, sizeof(page_id_t));
     pos += sizeof(page_id_t);
-    memcpy(log_buffer_ + pos, &log_record->page_id_, sizeof(page_id_t));
+    memcpy(log_buffer + pos, &log_record->page_id_, sizeof(page_id_t));
+  } else if (body_type == LogRecordType::END_CHECKPOINT) {
+    int32_t txn_count = log_record->active_txns_.size();
+    memcpy(log_buffer + pos, &txn_count, sizeof(int32_t));
+    pos += sizeof(int32_t);
+    memcpy(log_buffer + pos, log_record->active_txns_.data(), txn_count * sizeof(ActiveTxnEntry));
+    pos += txn_count * sizeof(ActiveTxnEntry);
+    int32_t page_count = log_record->dirty_pages_.size();
+    memcpy(log_buffer + pos, &page_count, sizeof(int32_t));
+    pos += sizeof(int32_t);
+    memcpy(log_buffer + pos, log_record->dirty_pages_.data(), page_count * sizeof(DirtyPageEntry));
   }
 
-  offset_ += log_record->size_;
+  // publish the slot so that the flush thread may write it out
+  buffer.completed_.fetch_add(size, std::memory_order_release);
   return log_record->lsn_;
 }
 
@@ -0,0 +1,228 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// log_reader.cpp
+//
+// Identification: src/recovery/log_reader.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "recovery/log_reader.h"
+
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+LogReader::LogReader(DiskManager *disk_manager, int64_t offset, int chunk_size)
+    : disk_manager_(disk_manager), chunk_size_(chunk_size), offset_(offset), next_offset_(offset) {
+  ReadAhead();
+}
+
+LogReader::~LogReader() {
+  // the background read still writes into next_chunk_
+  if (next_read_.valid()) {
+    next_read_.wait();
+  }
+}
+
+bool LogReader::Next(LogRecord *log_record) {
+  while (true) {
+    int available = end_ - pos_;
+    if (available > 0 && ParseLogRecord(chunk_.get() + pos_, available, log_record)) {
+      record_offset_ = offset_;
+      pos_ += log_record->size_;
+      offset_ += log_record->size_;
+      return true;
+    }
+    if (end_of_log_) {
+      return false;
+    }
+    if (available >= LogRecord::HEADER_SIZE) {
+      // a record that is complete in the chunk but cannot be parsed ends the log
+      const int32_t size = *reinterpret_cast<const int32_t *>(chunk_.get() + pos_);
+      if (size < LogRecord::HEADER_SIZE || size > LOG_BUFFER_SIZE || size <= available) {
+        end_of_log_ = true;
+        return false;
+      }
+    }
+
+    // the rest of the record is in the next chunk
+    if (!next_read_.get()) {
+      end_of_log_ = true;
+      return false;
+    }
+    if (available > 0) {
+      memcpy(next_chunk_.get() + LOG_BUFFER_SIZE - available, chunk_.get() + pos_, available);
+    }
+    std::swap(chunk_, next_chunk_);
+    pos_ = LOG_BUFFER_SIZE - available;
+    end_ = LOG_BUFFER_SIZE + chunk_size_;
+    next_offset_ += chunk_size_;
+    ReadAhead();
+  }
+}
+
+void LogReader::ReadAhead() {
+  if (next_chunk_ == nullptr || next_chunk_.use_count() > 1) {
+    // records handed out before still point into the old buffer
+    next_chunk_ = std::shared_ptr<char[]>(new char[LOG_BUFFER_SIZE + chunk_size_]);
+  }
+  char *data = next_chunk_.get() + LOG_BUFFER_SIZE;
+  int64_t offset = next_offset_;
+  next_read_ = std::async(std::launch::async, [this, data, offset]() {
+    return disk_manager_->ReadLog(data, chunk_size_, offset);
+  });
+}
+
+bool LogReader::ParseLogRecord(const char *data, int size, LogRecord *log_record) {
+  if (size < LogRecord::HEADER_SIZE) {
+    return false;
+  }
+
+  // read record
+  const int32_t record_size = *reinterpret_cast<const int32_t *>(data);
+  const lsn_t lsn = *reinterpret_cast<const lsn_t *>(data + 4);
+  const txn_id_t txn_id = *reinterpret_cast<const txn_id_t *>(data + 8);
+  const lsn_t prev_lsn = *reinterpret_cast<const lsn_t *>(data + 12);
+  const LogRecordType record_type = *reinterpret_cast<const LogRecordType *>(data + 16);
+
+  if (record_type != LogRecordType::BEGIN && record_type != LogRecordType::ABORT &&
+      record_type != LogRecordType::COMMIT && record_type != LogRecordType::INSERT &&
+      record_type != LogRecordType::MARKDELETE && record_type != LogRecordType::APPLYDELETE &&
+      record_type != LogRecordType::ROLLBACKDELETE && record_type != LogRecordType::UPDATE &&
+      record_type != LogRecordType::NEWPAGE && record_type != LogRecordType::BEGIN_CHECKPOINT &&
+      record_type != LogRecordType::END_CHECKPOINT && record_type != LogRecordType::CLR &&
+      record_type != LogRecordType::HASH_INSERT && record_type != LogRecordType::HASH_REMOVE &&
+      record_type != LogRecordType::HASH_HEADER) {
+    return false;
+  }
+  if (record_size < LogRecord::HEADER_SIZE || record_size > size) {
+    return false;
+  }
+
+  // every length inside the record is checked against the record size, a torn record may hold anything
+  const char *record_ptr = data + LogRecord::HEADER_SIZE;
+  int body_size = record_size - LogRecord::HEADER_SIZE;
+  // a compensation log record continues with the body of the change undo applied
+  LogRecordType body_type = record_type;
+  lsn_t undo_next_lsn = INVALID_LSN;
+  if (record_type == LogRecordType::CLR) {
+    if (body_size < static_cast<int>(sizeof(lsn_t) + sizeof(LogRecordType))) {
+      return false;
+    }
+    undo_next_lsn = *reinterpret_cast<const lsn_t *>(record_ptr);
+    body_type = *reinterpret_cast<const LogRecordType *>(record_ptr + sizeof(lsn_t));
+    if (body_type != LogRecordType::INSERT && body_type != LogRecordType::MARKDELETE &&
+        body_type != LogRecordType::APPLYDELETE && body_type != LogRecordType::ROLLBACKDELETE &&
+        body_type != LogRecordType::UPDATE) {
+      return false;
+    }
+    record_ptr += sizeof(lsn_t) + sizeof(LogRecordType);
+    body_size -= sizeof(lsn_t) + sizeof(LogRecordType);
+  }
+  switch (body_type) {
+    case LogRecordType::BEGIN:
+    case LogRecordType::ABORT:
+    case LogRecordType::COMMIT:
+    case LogRecordType::BEGIN_CHECKPOINT: {
+      *log_record = LogRecord(txn_id, prev_lsn, record_type);
+      break;
+    }
+    case LogRecordType::INSERT:
+    case LogRecordType::MARKDELETE:
+    case LogRecordType::APPLYDELETE:
+    case LogRecordType::ROLLBACKDELETE: {
+      if (body_size < static_cast<int>(sizeof(RID) + sizeof(int32_t))) {
+        return false;
+      }
+      const RID tuple_id = *reinterpret_cast<const RID *>(record_ptr);
+      Tuple tuple;
+      tuple.DeserializeViewFrom(record_ptr + sizeof(RID));
+      if (tuple.GetLength() > body_size - sizeof(RID) - sizeof(int32_t)) {
+        return false;
+      }
+      *log_record = LogRecord(txn_id, prev_lsn, body_type, tuple_id, tuple);
+      break;
+    }
+    case LogRecordType::UPDATE: {
+      if (body_size < static_cast<int>(sizeof(RID) + sizeof(int32_t))) {
+        return false;
+      }
+      const RID tuple_id = *reinterpret_cast<const RID *>(record_ptr);
+      const int32_t delta_size = *reinterpret_cast<const int32_t *>(record_ptr + sizeof(RID));
+      if (delta_size < 0 || delta_size > body_size - static_cast<int>(sizeof(RID) + sizeof(int32_t))) {
+        return false;
+      }
+      *log_record = LogRecord(txn_id, prev_lsn, body_type, tuple_id,
+                              std::string(record_ptr + sizeof(RID) + sizeof(int32_t), delta_size));
+      break;
+    }
+    case LogRecordType::HASH_INSERT:
+    case LogRecordType::HASH_REMOVE:
+    case LogRecordType::HASH_HEADER: {
+      if (body_size < static_cast<int>(sizeof(page_id_t) + sizeof(int32_t))) {
+        return false;
+      }
+      const page_id_t page_id = *reinterpret_cast<const page_id_t *>(record_ptr);
+      const int32_t delta_size = *reinterpret_cast<const int32_t *>(record_ptr + sizeof(page_id_t));
+      if (delta_size < 0 || delta_size > body_size - static_cast<int>(sizeof(page_id_t) + sizeof(int32_t))) {
+        return false;
+      }
+      *log_record = LogRecord(body_type, page_id,
+                              std::string(record_ptr + sizeof(page_id_t) + sizeof(int32_t), delta_size));
+      break;
+    }
+    case LogRecordType::NEWPAGE: {
+      if (body_size < static_cast<int>(2 * sizeof(page_id_t))) {
+        return false;
+      }
+      const page_id_t prev_page_id = *reinterpret_cast<const page_id_t *>(record_ptr);
+      const page_id_t page_id = *reinterpret_cast<const page_id_t *>(record_ptr + sizeof(page_id_t));
+      *log_record = LogRecord(txn_id, prev_lsn, record_type, prev_page_id, page_id);
+      break;
+    }
+    case LogRecordType::END_CHECKPOINT: {
+      if (body_size < static_cast<int>(2 * sizeof(int32_t))) {
+        return false;
+      }
+      const int32_t txn_count = *reinterpret_cast<const int32_t *>(record_ptr);
+      if (txn_count < 0 || txn_count > (body_size - 2 * static_cast<int>(sizeof(int32_t))) /
+                                           static_cast<int>(sizeof(ActiveTxnEntry))) {
+        return false;
+      }
+      // the entries hold 64 bit log offsets, they are copied out as the record is not aligned for them
+      std::vector<ActiveTxnEntry> txns(txn_count);
+      memcpy(txns.data(), record_ptr + sizeof(int32_t), txn_count * sizeof(ActiveTxnEntry));
+      record_ptr += sizeof(int32_t) + txn_count * sizeof(ActiveTxnEntry);
+      const int32_t page_count = *reinterpret_cast<const int32_t *>(record_ptr);
+      const int pages_size = body_size - 2 * static_cast<int>(sizeof(int32_t)) -
+                             txn_count * static_cast<int>(sizeof(ActiveTxnEntry));
+      if (page_count < 0 || page_count > pages_size / static_cast<int>(sizeof(DirtyPageEntry))) {
+        return false;
+      }
+      std::vector<DirtyPageEntry> pages(page_count);
+      memcpy(pages.data(), record_ptr + sizeof(int32_t), page_count * sizeof(DirtyPageEntry));
+      *log_record = LogRecord(std::move(txns), std::move(pages));
+      break;
+    }
+    default:
+      break;
+  }
+  if (record_type == LogRecordType::CLR) {
+    *log_record = LogRecord(*log_record, undo_next_lsn);
+  }
+  if (log_record->size_ != record_size) {
+    // the lengths inside the record do not add up, it has not been written completely
+    return false;
+  }
+  log_record->lsn_ = lsn;
+  return true;
+}
+
+}  // namespace bustub
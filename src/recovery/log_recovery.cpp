@@ -12,235 +12,472 @@
 
 #include "recovery/log_recovery.h"
 
+#include <atomic>
+#include <thread>  // NOLINT
+#include <utility>
+
+#include "common/macros.h"
+#include "recovery/log_reader.h"
 #include "storage/page/table_page.h"
 
 namespace bustub {
 /*
- * deserialize a log record from log buffer
+ * deserialize a log record from log buffer, the tuples of the record point into
+ * the log buffer
  * @return: true means deserialize succeed, otherwise can't deserialize cause
  * incomplete log record
  */
 bool LogRecovery::DeserializeLogRecord(const char *data, LogRecord *log_record) {
-  if (buffer_offset_ + LogRecord::HEADER_SIZE > LOG_BUFFER_SIZE) {
-    return false;
+  return LogReader::ParseLogRecord(data + buffer_offset_, LOG_BUFFER_SIZE - buffer_offset_, log_record);
+}
+
+/*
+ *redo phase on TABLE PAGE level(table/table_page.h)
+ *read log file from the beginning to end (you must prefetch log records into
+ *log buffer to reduce unnecessary I/O operations), remember to compare page's
+ *LSN with log_record's sequence number, and also build active_txn_ table &
+ *lsn_mapping_ table
+ */
+void LogRecovery::Redo(size_t num_workers) {
+  if (num_workers <= 1) {
+    ScanLog([&](LogRecord *log_record, LogReader *reader) {
+      page_id_t page_ids[2];
+      int page_count = GetRedoPages(*log_record, reader->GetOffset(), page_ids);
+      for (int i = 0; i < page_count; i++) {
+        RedoLogRecord(log_record, page_ids[i]);
+      }
+    });
+    buffer_pool_manager_->FlushAllPages();
+    return;
+  }
+
+  // every page belongs to exactly one worker, so the records of a page are redone in log order
+  std::vector<RedoQueue> queues(num_workers);
+  std::vector<std::vector<RedoTask>> batches(num_workers);
+  std::vector<std::thread> workers;
+  workers.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; i++) {
+    workers.emplace_back(&LogRecovery::RunRedoWorker, this, &queues[i]);
   }
 
-  // read record
-  const int32_t size = *reinterpret_cast<const int32_t *>(data + buffer_offset_);
-  const lsn_t lsn = *reinterpret_cast<const lsn_t *>(data + buffer_offset_ + 4);
-  const txn_id_t txn_id = *reinterpret_cast<const txn_id_t *>(data + buffer_offset_ + 8);
-  const lsn_t prev_lsn = *reinterpret_cast<const lsn_t *>(data + buffer_offset_ + 12);
-  const LogRecordType record_type = *reinterpret_cast<const LogRecordType *>(data + buffer_offset_ + 16);
+  ScanLog([&](LogRecord *log_record, LogReader *reader) {
+    page_id_t page_ids[2];
+    int page_count = GetRedoPages(*log_record, reader->GetOffset(), page_ids);
+    for (int i = 0; i < page_count; i++) {
+      size_t worker = static_cast<size_t>(page_ids[i]) % num_workers;
+      batches[worker].push_back({*log_record, page_ids[i], reader->GetChunk()});
+      if (batches[worker].size() == REDO_BATCH_SIZE) {
+        PushRedoBatch(&queues[worker], &batches[worker]);
+      }
+    }
+  });
+
+  for (size_t i = 0; i < num_workers; i++) {
+    if (!batches[i].empty()) {
+      PushRedoBatch(&queues[i], &batches[i]);
+    }
+    {
+      std::lock_guard<std::mutex> lg(queues[i].latch_);
+      queues[i].done_ = true;
+    }
+    queues[i].cv_.notify_all();
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  buffer_pool_manager_->FlushAllPages();
+}
+
+void LogRecovery::ScanLog(const std::function<void(LogRecord *, LogReader *)> &visit) {
+  ReadLogRecords(LoadCheckpoint(), [&](LogRecord *log_record, LogReader *reader) {
+    txn_id_t txn_id = log_record->GetTxnId();
+    next_lsn_ = std::max(next_lsn_, log_record->GetLSN() + 1);
+    switch (log_record->GetLogRecordType()) {
+      case LogRecordType::ABORT:
+      case LogRecordType::COMMIT:
+        active_txn_.erase(txn_id);
+        break;
+      case LogRecordType::BEGIN_CHECKPOINT:
+      case LogRecordType::END_CHECKPOINT:
+        return true;
+      case LogRecordType::HASH_INSERT:
+      case LogRecordType::HASH_REMOVE:
+      case LogRecordType::HASH_HEADER:
+        // hash index records belong to no transaction, undo leaves the entries of losers to the owners of the
+        // indexes, see GetRolledBackInserts
+        break;
+      default:
+        // records of a transaction are in log order, so this is always its latest lsn
+        active_txn_[txn_id] = log_record->GetLSN();
+        break;
+    }
+    lsn_mapping_[log_record->GetLSN()] = reader->GetOffset();
+    visit(log_record, reader);
+    return true;
+  });
+  if (log_manager_ != nullptr) {
+    // the compensation records of undo must not reuse the LSNs of the log
+    log_manager_->SetNextLSN(next_lsn_);
+  }
+}
+
+int64_t LogRecovery::LoadCheckpoint() {
+  int64_t log_start_offset = disk_manager_->GetLogStartOffset();
+  checkpoint_offset_ = disk_manager_->ReadMasterRecord();
+  if (checkpoint_offset_ < 0) {
+    // no checkpoint, everything in the log may need redo
+    checkpoint_offset_ = log_start_offset;
+    return log_start_offset;
+  }
+
+  int64_t start_offset = checkpoint_offset_;
+  ReadLogRecords(checkpoint_offset_, [&](LogRecord *log_record, LogReader *reader) {
+    if (log_record->GetLogRecordType() != LogRecordType::END_CHECKPOINT) {
+      return true;
+    }
+    // undo follows the transactions active at the checkpoint back to their first records
+    for (auto &entry : log_record->GetActiveTxns()) {
+      start_offset = std::min(start_offset, entry.begin_offset_);
+    }
+    // redo starts at the oldest change that might not have been written out
+    for (auto &entry : log_record->GetDirtyPages()) {
+      dirty_pages_[entry.page_id_] = entry.rec_lsn_;
+      start_offset = std::min(start_offset, entry.rec_offset_);
+    }
+    return false;
+  });
+  // the checkpoint wrote out the dirty pages before the log before it was recycled
+  return std::max(start_offset, log_start_offset);
+}
+
+void LogRecovery::ReadLogRecords(int64_t offset, const std::function<bool(LogRecord *, LogReader *)> &visit) {
+  LogReader reader(disk_manager_, offset, read_size_);
+  LogRecord log_record;
+  while (reader.Next(&log_record)) {
+    if (!visit(&log_record, &reader)) {
+      return;
+    }
+  }
+}
 
-  if (record_type != LogRecordType::BEGIN && record_type != LogRecordType::ABORT &&
-      record_type != LogRecordType::COMMIT && record_type != LogRecordType::INSERT &&
-      record_type != LogRecordType::MARKDELETE && record_type != LogRecordType::APPLYDELETE &&
-      record_type != LogRecordType::ROLLBACKDELETE && record_type != LogRecordType::UPDATE &&
-      record_type != LogRecordType::NEWPAGE) {
+bool LogRecovery::ReadLogRecord(int64_t offset, char *buffer, LogRecord *log_record) {
+  // the header tells how much of the record is left to read
+  if (!disk_manager_->ReadLog(buffer, LogRecord::HEADER_SIZE, offset)) {
     return false;
   }
-  if (buffer_offset_ + size > LOG_BUFFER_SIZE) {
+  const int32_t size = *reinterpret_cast<const int32_t *>(buffer);
+  if (size < LogRecord::HEADER_SIZE || size > LOG_BUFFER_SIZE || !disk_manager_->ReadLog(buffer, size, offset)) {
     return false;
   }
+  return LogReader::ParseLogRecord(buffer, size, log_record);
+}
 
-  const char *record_ptr = data + buffer_offset_ + LogRecord::HEADER_SIZE;
-  switch (record_type) {
-    case LogRecordType::BEGIN:
-    case LogRecordType::ABORT:
-    case LogRecordType::COMMIT: {
-      *log_record = LogRecord(txn_id, prev_lsn, record_type);
-      break;
-    }
+int LogRecovery::GetRedoPages(const LogRecord &log_record, int64_t offset, page_id_t page_ids[2]) {
+  int page_count = 0;
+  switch (log_record.GetRedoType()) {
     case LogRecordType::INSERT:
+      page_ids[page_count++] = log_record.insert_rid_.GetPageId();
+      break;
     case LogRecordType::MARKDELETE:
     case LogRecordType::APPLYDELETE:
-    case LogRecordType::ROLLBACKDELETE: {
-      const RID tuple_id = *reinterpret_cast<const RID *>(record_ptr);
-      Tuple tuple;
-      tuple.DeserializeFrom(record_ptr + sizeof(RID));
-      *log_record = LogRecord(txn_id, prev_lsn, record_type, tuple_id, tuple);
+    case LogRecordType::ROLLBACKDELETE:
+      page_ids[page_count++] = log_record.delete_rid_.GetPageId();
+      break;
+    case LogRecordType::UPDATE:
+      page_ids[page_count++] = log_record.update_rid_.GetPageId();
+      break;
+    case LogRecordType::HASH_INSERT:
+    case LogRecordType::HASH_REMOVE:
+    case LogRecordType::HASH_HEADER:
+      page_ids[page_count++] = log_record.page_id_;
+      break;
+    case LogRecordType::NEWPAGE:
+      page_ids[page_count++] = log_record.page_id_;
+      if (log_record.prev_page_id_ != INVALID_PAGE_ID) {
+        // the previous page is linked to the new page as well
+        page_ids[page_count++] = log_record.prev_page_id_;
+      }
+      break;
+    default:
+      break;
+  }
+  if (offset >= checkpoint_offset_) {
+    return page_count;
+  }
+
+  // before the checkpoint, only the pages that were dirty at the checkpoint may miss the change
+  int redo_count = 0;
+  for (int i = 0; i < page_count; i++) {
+    auto dirty_page = dirty_pages_.find(page_ids[i]);
+    if (dirty_page != dirty_pages_.end() && dirty_page->second <= log_record.lsn_) {
+      page_ids[redo_count++] = page_ids[i];
+    }
+  }
+  return redo_count;
+}
+
+void LogRecovery::RedoLogRecord(LogRecord *log_record, page_id_t page_id) {
+  auto table_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  BUSTUB_ASSERT(table_page != nullptr, "Redo needs a free frame in the buffer pool.");
+  if (table_page->GetLSN() >= log_record->GetLSN()) {
+    // the page was written out after the record had been applied
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    return;
+  }
+
+  switch (log_record->GetRedoType()) {
+    case LogRecordType::INSERT: {
+      RID rid = log_record->GetInsertRID();
+      table_page->InsertTuple(log_record->insert_tuple_, &rid, nullptr, nullptr, nullptr);
       break;
     }
+    case LogRecordType::MARKDELETE:
+      table_page->MarkDelete(log_record->GetDeleteRID(), nullptr, nullptr, nullptr);
+      break;
+    case LogRecordType::APPLYDELETE:
+      table_page->ApplyDelete(log_record->GetDeleteRID(), nullptr, nullptr);
+      break;
+    case LogRecordType::ROLLBACKDELETE:
+      table_page->RollbackDelete(log_record->GetDeleteRID(), nullptr, nullptr);
+      break;
     case LogRecordType::UPDATE: {
-      const RID tuple_id = *reinterpret_cast<const RID *>(record_ptr);
+      // the page holds the tuple as it was before the update, the record only has the changed bytes
       Tuple old_tuple;
-      old_tuple.DeserializeFrom(record_ptr + sizeof(RID));
-
       Tuple new_tuple;
-      new_tuple.DeserializeFrom(record_ptr + sizeof(RID) + sizeof(uint32_t) + old_tuple.GetLength());
-      *log_record = LogRecord(txn_id, prev_lsn, record_type, tuple_id, old_tuple, new_tuple);
+      table_page->GetTuple(log_record->update_rid_, &old_tuple, nullptr, nullptr);
+      bool applied = TupleDelta::Apply(log_record->update_delta_, old_tuple, false, &new_tuple);
+      BUSTUB_ASSERT(applied, "The update must fit the tuple on the page.");
+      table_page->UpdateTuple(new_tuple, &old_tuple, log_record->update_rid_, nullptr, nullptr, nullptr);
       break;
     }
-    case LogRecordType::NEWPAGE: {
-      const page_id_t prev_page_id = *reinterpret_cast<const page_id_t *>(record_ptr);
-      const page_id_t page_id = *reinterpret_cast<const page_id_t *>(record_ptr + sizeof(page_id_t));
-      *log_record = LogRecord(txn_id, prev_lsn, record_type, prev_page_id, page_id);
+    case LogRecordType::HASH_INSERT:
+    case LogRecordType::HASH_REMOVE:
+    case LogRecordType::HASH_HEADER: {
+      // the page is a hash index page, the record has the bytes that changed
+      bool applied = PageDelta::Apply(log_record->page_delta_, table_page->GetData());
+      BUSTUB_ASSERT(applied, "The change must fit the page.");
       break;
     }
+    case LogRecordType::NEWPAGE:
+      if (page_id == log_record->page_id_) {
+        table_page->Init(page_id, PAGE_SIZE, log_record->prev_page_id_, nullptr, nullptr);
+      } else {
+        table_page->SetNextPageId(log_record->page_id_);
+      }
+      break;
     default:
       break;
   }
-  log_record->lsn_ = lsn;
-  return true;
+  table_page->SetLSN(log_record->GetLSN());
+  buffer_pool_manager_->UnpinPage(page_id, true);
 }
 
-/*
- *redo phase on TABLE PAGE level(table/table_page.h)
- *read log file from the beginning to end (you must prefetch log records into
- *log buffer to reduce unnecessary I/O operations), remember to compare page's
- *LSN with log_record's sequence number, and also build active_txn_ table &
- *lsn_mapping_ table
- */
-void LogRecovery::Redo() {
-  while (disk_manager_->ReadLog(log_buffer_, LOG_BUFFER_SIZE, offset_)) {
-    LogRecord log_record;
-    while (DeserializeLogRecord(log_buffer_, &log_record)) {
-      txn_id_t txn_id = log_record.GetTxnId();
-
-      switch (log_record.GetLogRecordType()) {
-        case LogRecordType::BEGIN:
-          active_txn_[txn_id] = log_record.GetLSN();
-          break;
-        case LogRecordType::ABORT:
-        case LogRecordType::COMMIT: {
-          active_txn_.erase(txn_id);
-          break;
-        }
-        case LogRecordType::INSERT: {
-          RID rid = log_record.GetInsertRID();
-          auto table_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
-          if (table_page->GetLSN() < log_record.GetLSN()) {
-            table_page->InsertTuple(log_record.insert_tuple_, &rid, nullptr, nullptr, nullptr);
-          }
-          active_txn_[txn_id] = std::max(table_page->GetLSN(), log_record.GetLSN());
-          break;
-        }
-        case LogRecordType::MARKDELETE: {
-          RID rid = log_record.GetDeleteRID();
-          auto table_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
-          if (table_page->GetLSN() < log_record.GetLSN()) {
-            table_page->MarkDelete(rid, nullptr, nullptr, nullptr);
-          }
-          active_txn_[txn_id] = std::max(table_page->GetLSN(), log_record.GetLSN());
-          break;
-        }
-        case LogRecordType::APPLYDELETE: {
-          RID rid = log_record.GetDeleteRID();
-          auto table_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
-          if (table_page->GetLSN() < log_record.GetLSN()) {
-            table_page->ApplyDelete(rid, nullptr, nullptr);
-          }
-          active_txn_[txn_id] = std::max(table_page->GetLSN(), log_record.GetLSN());
-          break;
-        }
-        case LogRecordType::ROLLBACKDELETE: {
-          RID rid = log_record.GetDeleteRID();
-          auto table_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
-          if (table_page->GetLSN() < log_record.GetLSN()) {
-            table_page->RollbackDelete(rid, nullptr, nullptr);
-          }
-          active_txn_[txn_id] = std::max(table_page->GetLSN(), log_record.GetLSN());
-          break;
-        }
-        case LogRecordType::UPDATE: {
-          RID rid = log_record.update_rid_;
-          auto table_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
-          if (table_page->GetLSN() < log_record.GetLSN()) {
-            table_page->UpdateTuple(log_record.new_tuple_, &log_record.old_tuple_, rid, nullptr, nullptr, nullptr);
-          }
-          active_txn_[txn_id] = std::max(table_page->GetLSN(), log_record.GetLSN());
-          break;
-        }
-        case LogRecordType::NEWPAGE: {
-          page_id_t prev_page_id = log_record.prev_page_id_;
-          page_id_t page_id = log_record.page_id_;
-          auto table_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
-          if (table_page->GetLSN() < log_record.GetLSN()) {
-            table_page->Init(page_id, PAGE_SIZE, prev_page_id, nullptr, nullptr);
-          }
-          active_txn_[txn_id] = std::max(table_page->GetLSN(), log_record.GetLSN());
-          break;
-        }
-        default:
-          break;
+void LogRecovery::RunRedoWorker(RedoQueue *queue) {
+  while (true) {
+    std::vector<RedoTask> batch;
+    {
+      std::unique_lock<std::mutex> lock(queue->latch_);
+      queue->cv_.wait(lock, [&]() { return !queue->batches_.empty() || queue->done_; });
+      if (queue->batches_.empty()) {
+        return;
       }
-
-      lsn_mapping_[log_record.GetLSN()] = buffer_offset_;
-      buffer_offset_ += log_record.size_;
+      batch = std::move(queue->batches_.front());
+      queue->batches_.pop_front();
+    }
+    // the log reader may be waiting for room in the queue
+    queue->cv_.notify_all();
+    for (auto &task : batch) {
+      RedoLogRecord(&task.log_record_, task.page_id_);
     }
-    offset_ = buffer_offset_;
-    buffer_offset_ = 0;
   }
-  buffer_pool_manager_->FlushAllPages();
+}
+
+void LogRecovery::PushRedoBatch(RedoQueue *queue, std::vector<RedoTask> *batch) {
+  {
+    std::unique_lock<std::mutex> lock(queue->latch_);
+    queue->cv_.wait(lock, [&]() { return queue->batches_.size() < REDO_QUEUE_DEPTH; });
+    queue->batches_.push_back(std::move(*batch));
+  }
+  queue->cv_.notify_all();
+  batch->clear();
+  batch->reserve(REDO_BATCH_SIZE);
 }
 
 /*
  *undo phase on TABLE PAGE level(table/table_page.h)
  *iterate through active txn map and undo each operation
  */
-void LogRecovery::Undo() {
+void LogRecovery::Undo(size_t num_workers) {
+  std::vector<txn_id_t> losers;
+  std::vector<lsn_t> last_lsns;
   for (auto &pair : active_txn_) {
-    // undo every transaction
-    lsn_t lsn = pair.second;
-    offset_ = lsn_mapping_[lsn];
-
-    LogRecord log_record;
-    buffer_offset_ = 0;
-    while (disk_manager_->ReadLog(log_buffer_, LOG_BUFFER_SIZE, offset_)) {
-      if (!DeserializeLogRecord(log_buffer_, &log_record)) {
-        // we can't undo more log
+    losers.push_back(pair.first);
+    last_lsns.push_back(pair.second);
+  }
+
+  // follow every loser back to its BEGIN record, a CLR shows how far an interrupted undo had come, and join the
+  // losers that changed the same page into one group
+  std::vector<size_t> parents(losers.size());
+  auto find_group = [&](size_t loser) {
+    while (parents[loser] != loser) {
+      loser = parents[loser] = parents[parents[loser]];
+    }
+    return loser;
+  };
+  std::unordered_map<page_id_t, size_t> page_losers;
+  std::vector<UndoRecord> records;
+  LogRecord log_record;
+  for (size_t loser = 0; loser < losers.size(); loser++) {
+    parents[loser] = loser;
+    lsn_t undo_lsn = last_lsns[loser];
+    while (undo_lsn != INVALID_LSN) {
+      auto offset = lsn_mapping_.find(undo_lsn);
+      if (offset == lsn_mapping_.end() || !ReadLogRecord(offset->second, log_buffer_, &log_record)) {
         break;
       }
-
-      switch (log_record.GetLogRecordType()) {
-        case LogRecordType::BEGIN:
-        case LogRecordType::ABORT:
-        case LogRecordType::COMMIT: {
-          break;
-        }
-        case LogRecordType::INSERT: {
-          RID rid = log_record.GetInsertRID();
-          auto table_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
-          table_page->ApplyDelete(rid, nullptr, nullptr);
-          break;
-        }
-        case LogRecordType::MARKDELETE: {
-          RID rid = log_record.GetDeleteRID();
-          auto table_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
-          table_page->RollbackDelete(rid, nullptr, nullptr);
-          break;
-        }
-        case LogRecordType::APPLYDELETE: {
-          RID rid = log_record.GetDeleteRID();
-          auto table_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
-          table_page->InsertTuple(log_record.delete_tuple_, &rid, nullptr, nullptr, nullptr);
-          break;
+      if (log_record.GetLogRecordType() == LogRecordType::CLR) {
+        if (log_record.GetRedoType() == LogRecordType::APPLYDELETE) {
+          // an insert the interrupted undo rolled back, its index entries may still be there
+          rolled_back_inserts_.push_back(log_record.delete_rid_);
         }
-        case LogRecordType::ROLLBACKDELETE: {
-          RID rid = log_record.GetDeleteRID();
-          auto table_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
-          table_page->MarkDelete(rid, nullptr, nullptr, nullptr);
-          break;
+        undo_lsn = log_record.GetUndoNextLSN();
+        continue;
+      }
+      RID rid;
+      if (GetUndoRID(log_record, &rid)) {
+        if (log_record.GetLogRecordType() == LogRecordType::INSERT) {
+          rolled_back_inserts_.push_back(rid);
         }
-        case LogRecordType::UPDATE: {
-          RID rid = log_record.update_rid_;
-          auto table_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
-          table_page->UpdateTuple(log_record.new_tuple_, &log_record.old_tuple_, rid, nullptr, nullptr, nullptr);
-          break;
+        records.push_back({undo_lsn, offset->second, loser});
+        auto page_loser = page_losers.emplace(rid.GetPageId(), loser);
+        if (!page_loser.second) {
+          parents[find_group(loser)] = find_group(page_loser.first->second);
         }
-        case LogRecordType::NEWPAGE:
-        default:
-          break;
       }
+      undo_lsn = log_record.GetPrevLSN();
+    }
+  }
 
-      lsn_t prev_lsn = log_record.GetPrevLSN();
-      if (prev_lsn == INVALID_LSN) {
-        break;
-      }
-      offset_ = lsn_mapping_[prev_lsn];
-      buffer_offset_ = 0;
+  std::sort(records.begin(), records.end(),
+            [](const UndoRecord &a, const UndoRecord &b) { return a.lsn_ > b.lsn_; });
+  std::vector<std::vector<UndoRecord>> groups;
+  std::unordered_map<size_t, size_t> group_index;
+  for (auto &record : records) {
+    auto index = group_index.emplace(find_group(record.loser_), groups.size());
+    if (index.second) {
+      groups.emplace_back();
+    }
+    groups[index.first->second].push_back(record);
+  }
+
+  auto undo_group = [&](const std::vector<UndoRecord> &group, char *buffer) {
+    LogRecord group_record;
+    for (auto &record : group) {
+      bool read = ReadLogRecord(record.offset_, buffer, &group_record);
+      BUSTUB_ASSERT(read, "A record read before must be read again.");
+      UndoLogRecord(&group_record, &last_lsns[record.loser_]);
     }
+  };
+  if (num_workers <= 1 || groups.size() <= 1) {
+    for (auto &group : groups) {
+      undo_group(group, log_buffer_);
+    }
+  } else {
+    // every worker takes the next group until none is left, each one reads the log into its own buffer
+    std::atomic<size_t> next_group{0};
+    std::vector<std::thread> workers;
+    workers.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; i++) {
+      workers.emplace_back([&]() {
+        std::unique_ptr<char[]> buffer(new char[LOG_BUFFER_SIZE]);
+        for (size_t group = next_group++; group < groups.size(); group = next_group++) {
+          undo_group(groups[group], buffer.get());
+        }
+      });
+    }
+    for (auto &worker : workers) {
+      worker.join();
+    }
+  }
+
+  if (log_manager_ != nullptr) {
+    // the losers are rolled back completely, a later recovery does not undo them again
+    for (size_t loser = 0; loser < losers.size(); loser++) {
+      LogRecord abort_record(losers[loser], last_lsns[loser], LogRecordType::ABORT);
+      log_manager_->AppendLogRecord(&abort_record);
+    }
+    log_manager_->SyncFlush(true);
+  }
+}
+
+bool LogRecovery::GetUndoRID(const LogRecord &log_record, RID *rid) {
+  switch (log_record.log_record_type_) {
+    case LogRecordType::INSERT:
+      *rid = log_record.insert_rid_;
+      return true;
+    case LogRecordType::MARKDELETE:
+    case LogRecordType::APPLYDELETE:
+    case LogRecordType::ROLLBACKDELETE:
+      *rid = log_record.delete_rid_;
+      return true;
+    case LogRecordType::UPDATE:
+      *rid = log_record.update_rid_;
+      return true;
+    default:
+      // nothing to revert for NEWPAGE, the page stays linked into the table
+      return false;
+  }
+}
+
+void LogRecovery::UndoLogRecord(LogRecord *log_record, lsn_t *last_lsn) {
+  RID rid;
+  if (!GetUndoRID(*log_record, &rid)) {
+    return;
+  }
+  page_id_t page_id = rid.GetPageId();
+  auto table_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  BUSTUB_ASSERT(table_page != nullptr, "Undo needs a free frame in the buffer pool.");
+  txn_id_t txn_id = log_record->GetTxnId();
+  LogRecord compensation;
+  switch (log_record->GetLogRecordType()) {
+    case LogRecordType::INSERT:
+      table_page->ApplyDelete(rid, nullptr, nullptr);
+      compensation = LogRecord(txn_id, *last_lsn, LogRecordType::APPLYDELETE, rid, log_record->insert_tuple_);
+      break;
+    case LogRecordType::MARKDELETE:
+      table_page->RollbackDelete(rid, nullptr, nullptr);
+      compensation = LogRecord(txn_id, *last_lsn, LogRecordType::ROLLBACKDELETE, rid, log_record->delete_tuple_);
+      break;
+    case LogRecordType::APPLYDELETE:
+      table_page->InsertTuple(log_record->delete_tuple_, &rid, nullptr, nullptr, nullptr);
+      compensation = LogRecord(txn_id, *last_lsn, LogRecordType::INSERT, rid, log_record->delete_tuple_);
+      break;
+    case LogRecordType::ROLLBACKDELETE:
+      table_page->MarkDelete(rid, nullptr, nullptr, nullptr);
+      compensation = LogRecord(txn_id, *last_lsn, LogRecordType::MARKDELETE, rid, log_record->delete_tuple_);
+      break;
+    case LogRecordType::UPDATE: {
+      Tuple new_tuple;
+      Tuple old_tuple;
+      table_page->GetTuple(rid, &new_tuple, nullptr, nullptr);
+      bool applied = TupleDelta::Apply(log_record->update_delta_, new_tuple, true, &old_tuple);
+      BUSTUB_ASSERT(applied, "The update must fit the tuple on the page.");
+      // the revert is logged as an update of its own, from the tuple on the page back to the old one
+      compensation = LogRecord(txn_id, *last_lsn, LogRecordType::UPDATE, rid, TupleDelta::Encode(new_tuple, old_tuple));
+      table_page->UpdateTuple(old_tuple, &new_tuple, rid, nullptr, nullptr, nullptr);
+      break;
+    }
+    default:
+      break;
+  }
+
+  if (log_manager_ != nullptr && compensation.GetLogRecordType() != LogRecordType::INVALID) {
+    // undo continues with the record before the reverted one when it is interrupted after this CLR
+    LogRecord clr(compensation, log_record->GetPrevLSN());
+    *last_lsn = log_manager_->AppendLogRecord(&clr);
+    table_page->SetLSN(*last_lsn);
   }
+  buffer_pool_manager_->UnpinPage(page_id, true);
 }
 
 }  // namespace bustub
@@ -0,0 +1,52 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_delta.cpp
+//
+// Identification: src/recovery/page_delta.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "recovery/page_delta.h"
+
+#include <cstring>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+void PageDelta::Append(std::string *delta, uint32_t offset, const char *old_bytes, const char *new_bytes,
+                       uint32_t length) {
+  BUSTUB_ASSERT(offset + length <= PAGE_SIZE, "A range must lie within a page.");
+  const uint16_t header[2] = {static_cast<uint16_t>(offset), static_cast<uint16_t>(length)};
+  delta->append(reinterpret_cast<const char *>(header), sizeof(header));
+  for (uint32_t i = 0; i < length; i++) {
+    delta->push_back(static_cast<char>(old_bytes[i] ^ new_bytes[i]));
+  }
+}
+
+bool PageDelta::Apply(const std::string &delta, char *page_data) {
+  size_t pos = 0;
+  while (pos < delta.size()) {
+    if (pos + RANGE_HEADER_SIZE > delta.size()) {
+      return false;
+    }
+    uint16_t header[2];
+    memcpy(header, delta.data() + pos, sizeof(header));
+    pos += RANGE_HEADER_SIZE;
+    if (pos + header[1] > delta.size() || header[0] + header[1] > PAGE_SIZE) {
+      return false;
+    }
+    for (uint32_t i = 0; i < header[1]; i++) {
+      page_data[header[0] + i] ^= delta[pos + i];
+    }
+    pos += header[1];
+  }
+  return true;
+}
+
+}  // namespace bustub
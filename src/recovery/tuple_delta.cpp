@@ -0,0 +1,126 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_delta.cpp
+//
+// Identification: src/recovery/tuple_delta.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "recovery/tuple_delta.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+namespace {
+
+void AppendRange(std::string *delta, const char *old_data, const char *new_data, uint32_t offset, uint32_t old_length,
+                 uint32_t new_length) {
+  const uint16_t header[3] = {static_cast<uint16_t>(offset), static_cast<uint16_t>(old_length),
+                              static_cast<uint16_t>(new_length)};
+  delta->append(reinterpret_cast<const char *>(header), sizeof(header));
+  delta->append(old_data + offset, old_length);
+  delta->append(new_data + offset, new_length);
+}
+
+}  // namespace
+
+std::string TupleDelta::Encode(const Tuple &old_tuple, const Tuple &new_tuple) {
+  const uint32_t old_size = old_tuple.GetLength();
+  const uint32_t new_size = new_tuple.GetLength();
+  BUSTUB_ASSERT(old_size <= UINT16_MAX && new_size <= UINT16_MAX, "A tuple must fit into a page.");
+  const char *old_data = old_tuple.GetData();
+  const char *new_data = new_tuple.GetData();
+  std::string delta;
+
+  if (old_size != new_size) {
+    // the columns after the resized one have moved, only the common prefix and suffix are kept
+    uint32_t prefix = 0;
+    const uint32_t min_size = std::min(old_size, new_size);
+    while (prefix < min_size && old_data[prefix] == new_data[prefix]) {
+      prefix++;
+    }
+    uint32_t suffix = 0;
+    while (suffix < min_size - prefix && old_data[old_size - suffix - 1] == new_data[new_size - suffix - 1]) {
+      suffix++;
+    }
+    AppendRange(&delta, old_data, new_data, prefix, old_size - prefix - suffix, new_size - prefix - suffix);
+    return delta;
+  }
+
+  uint32_t pos = 0;
+  while (pos < old_size) {
+    if (old_data[pos] == new_data[pos]) {
+      pos++;
+      continue;
+    }
+    // extend the range over short unchanged gaps, logging a gap twice is cheaper than another range header
+    uint32_t end = pos + 1;
+    uint32_t gap = 0;
+    while (end + gap < old_size && gap <= RANGE_HEADER_SIZE / 2) {
+      if (old_data[end + gap] != new_data[end + gap]) {
+        end += gap + 1;
+        gap = 0;
+      } else {
+        gap++;
+      }
+    }
+    AppendRange(&delta, old_data, new_data, pos, end - pos, end - pos);
+    pos = end;
+  }
+  return delta;
+}
+
+bool TupleDelta::Apply(const std::string &delta, const Tuple &tuple, bool undo, Tuple *result) {
+  const char *data = tuple.GetData();
+  const uint32_t size = tuple.GetLength();
+  std::string output;
+  output.reserve(size);
+
+  // offsets are positions in the old tuple, undo shifts them by the size changes of the ranges before
+  int32_t shift = 0;
+  uint32_t pos = 0;
+  size_t delta_pos = 0;
+  while (delta_pos < delta.size()) {
+    if (delta_pos + RANGE_HEADER_SIZE > delta.size()) {
+      return false;
+    }
+    uint16_t header[3];
+    memcpy(header, delta.data() + delta_pos, sizeof(header));
+    const uint32_t old_length = header[1];
+    const uint32_t new_length = header[2];
+    const char *old_bytes = delta.data() + delta_pos + RANGE_HEADER_SIZE;
+    const char *new_bytes = old_bytes + old_length;
+    delta_pos += RANGE_HEADER_SIZE + old_length + new_length;
+
+    const uint32_t offset = header[0] + (undo ? shift : 0);
+    const uint32_t replaced_length = undo ? new_length : old_length;
+    if (delta_pos > delta.size() || offset < pos || offset + replaced_length > size) {
+      return false;
+    }
+    output.append(data + pos, offset - pos);
+    output.append(undo ? old_bytes : new_bytes, undo ? old_length : new_length);
+    pos = offset + replaced_length;
+    shift += static_cast<int32_t>(new_length) - static_cast<int32_t>(old_length);
+  }
+  output.append(data + pos, size - pos);
+
+  if (result->allocated_) {
+    delete[] result->data_;
+  }
+  result->size_ = output.size();
+  result->data_ = new char[result->size_];
+  memcpy(result->data_, output.data(), result->size_);
+  result->rid_ = tuple.rid_;
+  result->allocated_ = true;
+  return true;
+}
+
+}  // namespace bustub
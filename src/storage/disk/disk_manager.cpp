@@ -11,14 +11,17 @@
 //===----------------------------------------------------------------------===//
 
 #include <sys/stat.h>
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <iostream>
+#include <iterator>
 #include <string>
 #include <thread>  // NOLINT
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "common/util/compression_util.h"
 #include "storage/disk/disk_manager.h"
 
 namespace bustub {
@@ -29,8 +32,14 @@ static char *buffer_used;
  * Constructor: open/create a single database file & log file
  * @input db_file: database file name
  */
-DiskManager::DiskManager(const std::string &db_file)
-    : file_name_(db_file), next_page_id_(0), num_flushes_(0), num_writes_(0), flush_log_(false), flush_log_f_(nullptr) {
+DiskManager::DiskManager(const std::string &db_file, int log_segment_size)
+    : log_segment_size_(log_segment_size),
+      file_name_(db_file),
+      next_page_id_(0),
+      num_flushes_(0),
+      num_writes_(0),
+      flush_log_(false),
+      flush_log_f_(nullptr) {
   std::string::size_type n = file_name_.rfind('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
@@ -38,20 +47,33 @@ DiskManager::DiskManager(const std::string &db_file)
   }
   log_name_ = file_name_.substr(0, n) + ".log";
 
-  log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::app | std::ios::out);
+  log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::out);
   // directory or file does not exist
   if (!log_io_.is_open()) {
     log_io_.clear();
-    // create a new file
-    log_io_.open(log_name_, std::ios::binary | std::ios::trunc | std::ios::app | std::ios::out);
+    // create a new file, the log starts in segment 0 and has no checkpoint yet
+    log_io_.open(log_name_, std::ios::binary | std::ios::trunc | std::ios::out);
+    int64_t checkpoint_offset = -1;
+    int first_segment = 0;
+    log_io_.write(reinterpret_cast<const char *>(&checkpoint_offset), sizeof(checkpoint_offset));
+    log_io_.write(reinterpret_cast<const char *>(&first_segment), sizeof(first_segment));
     log_io_.close();
     // reopen with original mode
-    log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::app | std::ios::out);
+    log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::out);
     if (!log_io_.is_open()) {
       throw Exception("can't open dblog file");
     }
+    // segments left behind by an earlier log must not be mistaken for this one
+    int segment = 0;
+    while (remove(GetSegmentName(segment).c_str()) == 0) {
+      segment++;
+    }
   }
 
+  log_io_.seekg(OFFSET_FIRST_SEGMENT);
+  log_io_.read(reinterpret_cast<char *>(&first_segment_), sizeof(first_segment_));
+  LoadLogBlocks();
+
   db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
   // directory or file does not exist
   if (!db_io_.is_open()) {
@@ -74,6 +96,7 @@ DiskManager::DiskManager(const std::string &db_file)
 void DiskManager::ShutDown() {
   db_io_.close();
   log_io_.close();
+  segment_io_.close();
 }
 
 /**
@@ -98,7 +121,8 @@ void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
  * Read the contents of the specified page into the given memory area
  */
 void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  int offset = page_id * PAGE_SIZE;
+  // 64 bits, files grow past 2 GB
+  int64_t offset = static_cast<int64_t>(page_id) * PAGE_SIZE;
   // check if read beyond file length
   if (offset > GetFileSize(file_name_)) {
     LOG_DEBUG("I/O error reading past end of file");
@@ -126,7 +150,7 @@ void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
  * Write the contents of the log into disk file
  * Only return when sync is done, and only perform sequence write
  */
-void DiskManager::WriteLog(char *log_data, int size) {
+void DiskManager::WriteLog(char *log_data, int size, bool compress) {
   // enforce swap log buffer
   assert(log_data != buffer_used);
   buffer_used = log_data;
@@ -143,16 +167,44 @@ void DiskManager::WriteLog(char *log_data, int size) {
   }
 
   num_flushes_ += 1;
-  // sequence write
-  log_io_.write(log_data, size);
+  // compress before taking the latch, so that readers are not held up by it
+  const char *stored_data = log_data;
+  int stored_size = size;
+  if (compress) {
+    compress_buffer_.resize(size);
+    int compressed_size = CompressionUtil::Compress(log_data, size, compress_buffer_.data(), size - 1);
+    if (compressed_size > 0) {
+      stored_data = compress_buffer_.data();
+      stored_size = compressed_size;
+    }
+  }
+
+  std::lock_guard<std::mutex> lg(log_latch_);
+  // sequence write, a block that does not fit into the current segment starts the next one
+  int block_size = LOG_BLOCK_HEADER_SIZE + stored_size;
+  assert(block_size <= log_segment_size_);
+  if (write_position_ % log_segment_size_ + block_size > log_segment_size_) {
+    write_position_ += log_segment_size_ - write_position_ % log_segment_size_;
+  }
+  int segment = write_position_ / log_segment_size_;
+  if (!segment_io_.is_open() || segment != open_segment_) {
+    OpenSegment(segment);
+  }
+  LogBlockHeader header{log_size_, size, stored_size};
+  segment_io_.seekp(write_position_ % log_segment_size_);
+  segment_io_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  segment_io_.write(stored_data, stored_size);
 
   // check for I/O error
-  if (log_io_.bad()) {
+  if (segment_io_.bad()) {
     LOG_DEBUG("I/O error while writing log");
     return;
   }
   // needs to flush to keep disk file in sync
-  log_io_.flush();
+  segment_io_.flush();
+  log_blocks_.push_back({log_size_, size, stored_size, write_position_});
+  write_position_ += block_size;
+  log_size_ += size;
   flush_log_ = false;
 }
 
@@ -161,29 +213,141 @@ void DiskManager::WriteLog(char *log_data, int size) {
  * Always read from the beginning and perform sequence read
  * @return: false means already reach the end
  */
-bool DiskManager::ReadLog(char *log_data, int size, int offset) {
-  if (offset >= GetFileSize(log_name_)) {
+bool DiskManager::ReadLog(char *log_data, int size, int64_t offset) {
+  std::lock_guard<std::mutex> lg(log_latch_);
+  if (log_blocks_.empty() || offset >= log_size_ || offset < log_blocks_.front().offset_) {
     // LOG_DEBUG("end of log file");
-    // LOG_DEBUG("file size is %d", GetFileSize(log_name_));
     return false;
   }
-  log_io_.seekp(offset);
-  log_io_.read(log_data, size);
 
-  if (log_io_.bad()) {
-    LOG_DEBUG("I/O error while reading log");
-    return false;
+  // the read may span several blocks, starting at the last block that begins at or before the offset
+  auto next_block =
+      std::upper_bound(log_blocks_.begin(), log_blocks_.end(), offset,
+                       [](int64_t log_offset, const LogBlock &block) { return log_offset < block.offset_; });
+  size_t block = next_block - log_blocks_.begin() - 1;
+  int read_count = 0;
+  for (; read_count < size && block < log_blocks_.size(); block++) {
+    const LogBlock &log_block = log_blocks_[block];
+    auto block_offset = static_cast<int>(offset + read_count - log_block.offset_);
+    int count = std::min(size - read_count, log_block.size_ - block_offset);
+    if (log_block.stored_size_ == log_block.size_) {
+      // an uncompressed block is read straight into the output
+      std::ifstream segment_in(GetSegmentName(log_block.position_ / log_segment_size_), std::ios::binary);
+      segment_in.seekg(log_block.position_ % log_segment_size_ + LOG_BLOCK_HEADER_SIZE + block_offset);
+      segment_in.read(log_data + read_count, count);
+      if (segment_in.gcount() < count) {
+        LOG_DEBUG("I/O error while reading log");
+        return false;
+      }
+    } else {
+      if (!ReadLogBlock(block)) {
+        LOG_DEBUG("I/O error while reading log");
+        return false;
+      }
+      memcpy(log_data + read_count, block_buffer_.data() + block_offset, count);
+    }
+    read_count += count;
   }
   // if log file ends before reading "size"
-  int read_count = log_io_.gcount();
   if (read_count < size) {
-    log_io_.clear();
     memset(log_data + read_count, 0, size - read_count);
   }
 
   return true;
 }
 
+/**
+ * Write the master record into the header of the log file
+ */
+void DiskManager::WriteMasterRecord(int64_t checkpoint_offset) {
+  std::lock_guard<std::mutex> lg(log_latch_);
+  log_io_.seekp(OFFSET_MASTER_RECORD);
+  log_io_.write(reinterpret_cast<const char *>(&checkpoint_offset), sizeof(checkpoint_offset));
+  if (log_io_.bad()) {
+    LOG_DEBUG("I/O error while writing master record");
+    return;
+  }
+  log_io_.flush();
+}
+
+/**
+ * Read the master record from the header of the log file
+ * @return: -1 means no checkpoint has been completed
+ */
+int64_t DiskManager::ReadMasterRecord() {
+  std::lock_guard<std::mutex> lg(log_latch_);
+  int64_t checkpoint_offset = -1;
+  log_io_.seekg(OFFSET_MASTER_RECORD);
+  log_io_.read(reinterpret_cast<char *>(&checkpoint_offset), sizeof(checkpoint_offset));
+  if (log_io_.gcount() < static_cast<int>(sizeof(checkpoint_offset))) {
+    log_io_.clear();
+    return -1;
+  }
+  return checkpoint_offset;
+}
+
+/**
+ * Remove the log segments that only hold log records before the given offset
+ */
+void DiskManager::TruncateLog(int64_t offset) {
+  std::lock_guard<std::mutex> lg(log_latch_);
+  // the block holding the offset is kept, so the log never becomes empty
+  offset = std::min(offset, log_size_ - 1);
+  if (log_blocks_.empty() || offset < log_blocks_.front().offset_) {
+    return;
+  }
+  auto next_block =
+      std::upper_bound(log_blocks_.begin(), log_blocks_.end(), offset,
+                       [](int64_t log_offset, const LogBlock &block) { return log_offset < block.offset_; });
+  int first_segment = std::prev(next_block)->position_ / log_segment_size_;
+  if (first_segment <= first_segment_) {
+    return;
+  }
+  // the header is updated first, a crash in between only leaves unreferenced segments behind
+  log_io_.seekp(OFFSET_FIRST_SEGMENT);
+  log_io_.write(reinterpret_cast<const char *>(&first_segment), sizeof(first_segment));
+  log_io_.flush();
+  for (int segment = first_segment_; segment < first_segment; segment++) {
+    if (segment == open_segment_) {
+      segment_io_.close();
+    }
+    remove(GetSegmentName(segment).c_str());
+  }
+  first_segment_ = first_segment;
+  auto first_block = std::find_if(log_blocks_.begin(), log_blocks_.end(), [&](const LogBlock &block) {
+    return block.position_ >= static_cast<int64_t>(first_segment) * log_segment_size_;
+  });
+  log_blocks_.erase(log_blocks_.begin(), first_block);
+}
+
+/**
+ * @return: log offset of the first log record that has not been truncated
+ */
+int64_t DiskManager::GetLogStartOffset() {
+  std::lock_guard<std::mutex> lg(log_latch_);
+  return log_blocks_.empty() ? log_size_ : log_blocks_.front().offset_;
+}
+
+/**
+ * @return: log offset right after the last log record
+ */
+int64_t DiskManager::GetLogSize() {
+  std::lock_guard<std::mutex> lg(log_latch_);
+  return log_size_;
+}
+
+/**
+ * @return: number of bytes the log blocks take in the log segments
+ */
+int64_t DiskManager::GetLogStoredSize() {
+  std::lock_guard<std::mutex> lg(log_latch_);
+  int64_t stored_size = 0;
+  for (auto &block : log_blocks_) {
+    stored_size += LOG_BLOCK_HEADER_SIZE + block.stored_size_;
+  }
+  return stored_size;
+}
+
 /**
  * Allocate new page (operations like create index/table)
  * For now just keep an increasing counter
@@ -212,13 +376,97 @@ int DiskManager::GetNumWrites() const { return num_writes_; }
  */
 bool DiskManager::GetFlushState() const { return flush_log_; }
 
+/**
+ * Private helper function to get the file name of a log segment
+ */
+std::string DiskManager::GetSegmentName(int segment) { return log_name_ + "." + std::to_string(segment); }
+
+/**
+ * Private helper function to open a log segment for writing, a segment that does not hold any log yet is created
+ */
+void DiskManager::OpenSegment(int segment) {
+  segment_io_.close();
+  segment_io_.clear();
+  std::string segment_name = GetSegmentName(segment);
+  if (write_position_ > static_cast<int64_t>(segment) * log_segment_size_) {
+    segment_io_.open(segment_name, std::ios::binary | std::ios::in | std::ios::out);
+  } else {
+    segment_io_.open(segment_name, std::ios::binary | std::ios::trunc | std::ios::out);
+    // a segment left behind by an earlier log must not look like the continuation of this one
+    remove(GetSegmentName(segment + 1).c_str());
+  }
+  if (!segment_io_.is_open()) {
+    throw Exception("can't open log segment file");
+  }
+  open_segment_ = segment;
+}
+
+/**
+ * Private helper function to find the log blocks in the segments, the log ends before the first block that has not
+ * been written completely
+ */
+void DiskManager::LoadLogBlocks() {
+  log_blocks_.clear();
+  log_size_ = 0;
+  write_position_ = static_cast<int64_t>(first_segment_) * log_segment_size_;
+  for (int segment = first_segment_;; segment++) {
+    auto segment_size = static_cast<int>(GetFileSize(GetSegmentName(segment)));
+    if (segment_size < 0) {
+      return;
+    }
+    std::ifstream segment_in(GetSegmentName(segment), std::ios::binary);
+    int position = 0;
+    while (position + LOG_BLOCK_HEADER_SIZE <= segment_size) {
+      LogBlockHeader header;
+      segment_in.seekg(position);
+      segment_in.read(reinterpret_cast<char *>(&header), sizeof(header));
+      LogBlock block{header.offset_, header.size_, header.stored_size_,
+                     static_cast<int64_t>(segment) * log_segment_size_ + position};
+      if (block.size_ <= 0 || block.stored_size_ <= 0 || block.stored_size_ > block.size_ ||
+          position + LOG_BLOCK_HEADER_SIZE + block.stored_size_ > segment_size ||
+          (!log_blocks_.empty() && block.offset_ != log_size_)) {
+        return;
+      }
+      log_blocks_.push_back(block);
+      log_size_ = block.offset_ + block.size_;
+      position += LOG_BLOCK_HEADER_SIZE + block.stored_size_;
+      write_position_ = block.position_ + LOG_BLOCK_HEADER_SIZE + block.stored_size_;
+    }
+    if (position < segment_size) {
+      return;
+    }
+  }
+}
+
+/**
+ * Private helper function to read a compressed log block into block_buffer_ and decompress it
+ */
+bool DiskManager::ReadLogBlock(size_t block) {
+  const LogBlock &log_block = log_blocks_[block];
+  if (cached_block_offset_ == log_block.offset_) {
+    return true;
+  }
+  std::vector<char> stored_data(log_block.stored_size_);
+  std::ifstream segment_in(GetSegmentName(log_block.position_ / log_segment_size_), std::ios::binary);
+  segment_in.seekg(log_block.position_ % log_segment_size_ + LOG_BLOCK_HEADER_SIZE);
+  segment_in.read(stored_data.data(), log_block.stored_size_);
+  block_buffer_.resize(log_block.size_);
+  cached_block_offset_ = -1;
+  if (segment_in.gcount() < log_block.stored_size_ ||
+      !CompressionUtil::Decompress(stored_data.data(), log_block.stored_size_, block_buffer_.data(), log_block.size_)) {
+    return false;
+  }
+  cached_block_offset_ = log_block.offset_;
+  return true;
+}
+
 /**
  * Private helper function to get disk file size
  */
-int DiskManager::GetFileSize(const std::string &file_name) {
+int64_t DiskManager::GetFileSize(const std::string &file_name) {
   struct stat stat_buf;
   int rc = stat(file_name.c_str(), &stat_buf);
-  return rc == 0 ? static_cast<int>(stat_buf.st_size) : -1;
+  return rc == 0 ? static_cast<int64_t>(stat_buf.st_size) : -1;
 }
 
 }  // namespace bustub
@@ -0,0 +1,551 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree.cpp
+//
+// Identification: src/storage/index/b_plus_tree.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/rid.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                          int leaf_max_size, int internal_max_size)
+    : index_name_(std::move(name)),
+      buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      leaf_max_size_(leaf_max_size),
+      internal_max_size_(internal_max_size) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::IsEmpty() { return GetRootPageId() == INVALID_PAGE_ID; }
+
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t BPLUSTREE_TYPE::GetRootPageId() {
+  root_latch_.RLock();
+  page_id_t root_page_id = root_page_id_;
+  root_latch_.RUnlock();
+  return root_page_id;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) {
+  // the values of a key may continue in the next leaves
+  for (auto iter = Begin(key); !iter.IsEnd() && comparator_((*iter).first, key) == 0; ++iter) {
+    result->push_back((*iter).second);
+  }
+  return !result->empty();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::findLeaf(const KeyType &key, const ValueType *value, Operation op, LatchPath *path) {
+  if (op == Operation::SEARCH) {
+    root_latch_.RLock();
+  } else {
+    root_latch_.WLock();
+    path->root_latched = true;
+  }
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    if (op == Operation::SEARCH) {
+      root_latch_.RUnlock();
+    }
+    return nullptr;
+  }
+
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  if (op == Operation::SEARCH) {
+    page->RLatch();
+    root_latch_.RUnlock();
+  } else {
+    page->WLatch();
+    if (isSafe(reinterpret_cast<BPlusTreePage *>(page->GetData()), op, true)) {
+      releasePath(path, false);
+    }
+    path->pages.push_back(page);
+  }
+
+  auto node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  while (!node->IsLeafPage()) {
+    auto internal = reinterpret_cast<InternalPage *>(node);
+    Page *child = buffer_pool_manager_->FetchPage(internal->ValueAt(internal->ChildIndex(key, value, comparator_)));
+    node = reinterpret_cast<BPlusTreePage *>(child->GetData());
+    if (op == Operation::SEARCH) {
+      child->RLatch();
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    } else {
+      child->WLatch();
+      if (isSafe(node, op, false)) {
+        releasePath(path, false);
+      }
+      path->pages.push_back(child);
+    }
+    page = child;
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::findFirstLeaf() {
+  root_latch_.RLock();
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    root_latch_.RUnlock();
+    return nullptr;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  page->RLatch();
+  root_latch_.RUnlock();
+
+  auto node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  while (!node->IsLeafPage()) {
+    Page *child = buffer_pool_manager_->FetchPage(reinterpret_cast<InternalPage *>(node)->ValueAt(0));
+    child->RLatch();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = child;
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::isSafe(BPlusTreePage *node, Operation op, bool is_root) {
+  if (op == Operation::INSERT) {
+    return node->GetSize() < node->GetMaxSize();
+  }
+  if (op == Operation::REMOVE) {
+    if (is_root) {
+      // a root leaf is dropped once empty, a root with two children is replaced by the one left after a merge
+      return node->GetSize() > (node->IsLeafPage() ? 1 : 2);
+    }
+    return node->GetSize() > node->GetMinSize();
+  }
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::releasePath(LatchPath *path, bool dirty) {
+  if (path->root_latched) {
+    root_latch_.WUnlock();
+    path->root_latched = false;
+  }
+  for (Page *page : path->pages) {
+    if (page != nullptr) {
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), dirty);
+    }
+  }
+  path->pages.clear();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::newTreePage(bool leaf) {
+  page_id_t page_id;
+  Page *page = buffer_pool_manager_->NewPage(&page_id);
+  if (leaf) {
+    reinterpret_cast<LeafPage *>(page->GetData())->Init(page_id, leaf_max_size_);
+  } else {
+    reinterpret_cast<InternalPage *>(page->GetData())->Init(page_id, internal_max_size_);
+  }
+  return page;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  LatchPath path;
+  Page *leaf = findLeaf(key, &value, Operation::INSERT, &path);
+  if (leaf == nullptr) {
+    // the tree is empty, the root latch is still held
+    Page *root = newTreePage(true);
+    reinterpret_cast<LeafPage *>(root->GetData())->InsertAt(0, key, value);
+    root_page_id_ = root->GetPageId();
+    buffer_pool_manager_->UnpinPage(root_page_id_, true);
+    releasePath(&path, false);
+    return true;
+  }
+
+  auto leaf_page = reinterpret_cast<LeafPage *>(leaf->GetData());
+  int index = leaf_page->KeyIndex(key, &value, comparator_);
+  if (leaf_page->IsEntryAt(index, key, value, comparator_)) {
+    releasePath(&path, false);
+    return false;
+  }
+  leaf_page->InsertAt(index, key, value);
+  splitUp(&path, path.pages.size() - 1);
+  releasePath(&path, true);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::splitUp(LatchPath *path, size_t level) {
+  Page *page = path->pages[level];
+  while (true) {
+    auto node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    if (node->GetSize() <= node->GetMaxSize()) {
+      return;
+    }
+
+    // the new page is reachable through the latched page and its latched parent only, so it needs no latch
+    Page *sibling = newTreePage(node->IsLeafPage());
+    MappingType separator;
+    if (node->IsLeafPage()) {
+      auto sibling_leaf = reinterpret_cast<LeafPage *>(sibling->GetData());
+      reinterpret_cast<LeafPage *>(node)->MoveHalfTo(sibling_leaf);
+      separator = sibling_leaf->GetItem(0);
+    } else {
+      auto sibling_internal = reinterpret_cast<InternalPage *>(sibling->GetData());
+      separator = reinterpret_cast<InternalPage *>(node)->MoveHalfTo(sibling_internal);
+    }
+    page_id_t sibling_page_id = sibling->GetPageId();
+    buffer_pool_manager_->UnpinPage(sibling_page_id, true);
+
+    if (level == 0) {
+      // only an unsafe root is kept at the top of the path
+      BUSTUB_ASSERT(path->root_latched, "A page that splits must have a latched parent.");
+      Page *root = newTreePage(false);
+      reinterpret_cast<InternalPage *>(root->GetData())->PopulateNewRoot(page->GetPageId(), separator, sibling_page_id);
+      root_page_id_ = root->GetPageId();
+      buffer_pool_manager_->UnpinPage(root_page_id_, true);
+      return;
+    }
+    Page *parent = path->pages[--level];
+    auto parent_page = reinterpret_cast<InternalPage *>(parent->GetData());
+    parent_page->InsertAt(parent_page->ValueIndex(page->GetPageId()) + 1, separator, sibling_page_id);
+    page = parent;
+  }
+}
+
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::BulkLoad(std::vector<MappingType> *entries, Transaction *transaction) {
+  auto less = [this](const MappingType &lhs, const MappingType &rhs) { return compareEntries(lhs, rhs) < 0; };
+  if (!std::is_sorted(entries->begin(), entries->end(), less)) {
+    std::sort(entries->begin(), entries->end(), less);
+  }
+  auto equal = [this](const MappingType &lhs, const MappingType &rhs) { return compareEntries(lhs, rhs) == 0; };
+  entries->erase(std::unique(entries->begin(), entries->end(), equal), entries->end());
+
+  // the new pages are not reachable before the root page id is set, so they need no latches
+  root_latch_.WLock();
+  if (root_page_id_ != INVALID_PAGE_ID) {
+    root_latch_.WUnlock();
+    return false;
+  }
+  if (entries->empty()) {
+    root_latch_.WUnlock();
+    return true;
+  }
+
+  // the pages of the level being built, with the first entry below each of them
+  std::vector<std::pair<MappingType, page_id_t>> level;
+  const size_t num_leaves = (entries->size() + leaf_max_size_ - 1) / leaf_max_size_;
+  size_t next = 0;
+  Page *prev = nullptr;
+  for (size_t i = 0; i < num_leaves; i++) {
+    Page *page = newTreePage(true);
+    auto leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    // an even spread keeps the last page at least half full as well
+    const size_t end = next + entries->size() / num_leaves + (i < entries->size() % num_leaves ? 1 : 0);
+    for (int index = 0; next < end; index++, next++) {
+      leaf->InsertAt(index, (*entries)[next].first, (*entries)[next].second);
+    }
+    level.emplace_back(leaf->GetItem(0), page->GetPageId());
+    if (prev != nullptr) {
+      reinterpret_cast<LeafPage *>(prev->GetData())->SetNextPageId(page->GetPageId());
+      buffer_pool_manager_->UnpinPage(prev->GetPageId(), true);
+    }
+    prev = page;
+  }
+  buffer_pool_manager_->UnpinPage(prev->GetPageId(), true);
+
+  while (level.size() > 1) {
+    const size_t num_pages = (level.size() + internal_max_size_ - 1) / internal_max_size_;
+    std::vector<std::pair<MappingType, page_id_t>> upper;
+    next = 0;
+    for (size_t i = 0; i < num_pages; i++) {
+      Page *page = newTreePage(false);
+      auto internal = reinterpret_cast<InternalPage *>(page->GetData());
+      const size_t end = next + level.size() / num_pages + (i < level.size() % num_pages ? 1 : 0);
+      upper.emplace_back(level[next].first, page->GetPageId());
+      for (int index = 0; next < end; index++, next++) {
+        internal->InsertAt(index, level[next].first, level[next].second);
+      }
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+    }
+    level.swap(upper);
+  }
+  root_page_id_ = level[0].second;
+  root_latch_.WUnlock();
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Drop() {
+  root_latch_.WLock();
+  if (root_page_id_ != INVALID_PAGE_ID) {
+    dropPage(root_page_id_);
+    root_page_id_ = INVALID_PAGE_ID;
+  }
+  root_latch_.WUnlock();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::dropPage(page_id_t page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  auto node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  if (!node->IsLeafPage()) {
+    auto internal = reinterpret_cast<InternalPage *>(node);
+    for (int i = 0; i < internal->GetSize(); i++) {
+      dropPage(internal->ValueAt(i));
+    }
+  }
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  buffer_pool_manager_->DeletePage(page_id);
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::Remove(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  LatchPath path;
+  Page *leaf = findLeaf(key, &value, Operation::REMOVE, &path);
+  if (leaf == nullptr) {
+    releasePath(&path, false);
+    return false;
+  }
+
+  auto leaf_page = reinterpret_cast<LeafPage *>(leaf->GetData());
+  int index = leaf_page->KeyIndex(key, &value, comparator_);
+  if (!leaf_page->IsEntryAt(index, key, value, comparator_)) {
+    releasePath(&path, false);
+    return false;
+  }
+  leaf_page->RemoveAt(index);
+  mergeUp(&path, path.pages.size() - 1);
+  releasePath(&path, true);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::mergeUp(LatchPath *path, size_t level) {
+  while (true) {
+    Page *page = path->pages[level];
+    auto node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    if (level == 0) {
+      // a page at the top of the path is either safe or the root
+      if (path->root_latched && adjustRoot(page)) {
+        path->pages[0] = nullptr;
+      }
+      return;
+    }
+    if (node->GetSize() >= node->GetMinSize()) {
+      return;
+    }
+
+    auto parent_page = reinterpret_cast<InternalPage *>(path->pages[level - 1]->GetData());
+    int index = parent_page->ValueIndex(page->GetPageId());
+    Page *left;
+    Page *right;
+    if (index > 0) {
+      // latch the left sibling first, no writer reaches the page in between because the parent stays latched
+      page->WUnlatch();
+      left = buffer_pool_manager_->FetchPage(parent_page->ValueAt(index - 1));
+      left->WLatch();
+      page->WLatch();
+      right = page;
+    } else {
+      left = page;
+      right = buffer_pool_manager_->FetchPage(parent_page->ValueAt(index + 1));
+      right->WLatch();
+      index++;
+    }
+    Page *sibling = left == page ? right : left;
+    auto sibling_node = reinterpret_cast<BPlusTreePage *>(sibling->GetData());
+
+    if (sibling_node->GetSize() > sibling_node->GetMinSize()) {
+      // borrow one entry, only the separator in the parent changes
+      if (node->IsLeafPage()) {
+        auto left_leaf = reinterpret_cast<LeafPage *>(left->GetData());
+        auto right_leaf = reinterpret_cast<LeafPage *>(right->GetData());
+        if (sibling == left) {
+          left_leaf->MoveLastToFrontOf(right_leaf);
+        } else {
+          right_leaf->MoveFirstToEndOf(left_leaf);
+        }
+        parent_page->SetKeyAt(index, right_leaf->GetItem(0));
+      } else {
+        auto left_internal = reinterpret_cast<InternalPage *>(left->GetData());
+        auto right_internal = reinterpret_cast<InternalPage *>(right->GetData());
+        MappingType separator = sibling == left
+                                    ? left_internal->MoveLastToFrontOf(right_internal, parent_page->KeyAt(index))
+                                    : right_internal->MoveFirstToEndOf(left_internal, parent_page->KeyAt(index));
+        parent_page->SetKeyAt(index, separator);
+      }
+      sibling->WUnlatch();
+      buffer_pool_manager_->UnpinPage(sibling->GetPageId(), true);
+      return;
+    }
+
+    // merge the right page into the left one and drop it
+    if (node->IsLeafPage()) {
+      reinterpret_cast<LeafPage *>(right->GetData())->MoveAllTo(reinterpret_cast<LeafPage *>(left->GetData()));
+    } else {
+      reinterpret_cast<InternalPage *>(right->GetData())
+          ->MoveAllTo(reinterpret_cast<InternalPage *>(left->GetData()), parent_page->KeyAt(index));
+    }
+    parent_page->RemoveAt(index);
+    page_id_t right_page_id = right->GetPageId();
+    right->WUnlatch();
+    buffer_pool_manager_->UnpinPage(right_page_id, true);
+    buffer_pool_manager_->DeletePage(right_page_id);
+    // the left page is released with the path
+    path->pages[level] = left;
+    level--;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::adjustRoot(Page *root) {
+  auto node = reinterpret_cast<BPlusTreePage *>(root->GetData());
+  if (node->IsLeafPage() && node->GetSize() == 0) {
+    root_page_id_ = INVALID_PAGE_ID;
+  } else if (!node->IsLeafPage() && node->GetSize() == 1) {
+    root_page_id_ = reinterpret_cast<InternalPage *>(node)->ValueAt(0);
+  } else {
+    return false;
+  }
+  page_id_t page_id = root->GetPageId();
+  root->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  buffer_pool_manager_->DeletePage(page_id);
+  return true;
+}
+
+/*****************************************************************************
+ * INDEX ITERATOR
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() { return INDEXITERATOR_TYPE(buffer_pool_manager_, findFirstLeaf(), 0); }
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
+  Page *leaf = findLeaf(key, nullptr, Operation::SEARCH, nullptr);
+  if (leaf == nullptr) {
+    return End();
+  }
+  int index = reinterpret_cast<LeafPage *>(leaf->GetData())->KeyIndex(key, nullptr, comparator_);
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, leaf, index);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::End() { return INDEXITERATOR_TYPE(); }
+
+/*****************************************************************************
+ * UTILITIES AND DEBUG
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+int BPLUSTREE_TYPE::VerifyIntegrity() {
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    return 0;
+  }
+  int leaf_depth = -1;
+  int num_entries = 0;
+  bool valid = true;
+  verifyPage(root_page_id_, 0, &leaf_depth, nullptr, nullptr, &num_entries, &valid);
+
+  // the leaf chain must hold the same entries in order
+  int num_chained = 0;
+  const MappingType *last = nullptr;
+  MappingType last_entry;
+  for (auto iter = Begin(); !iter.IsEnd(); ++iter) {
+    if (last != nullptr && compareEntries(*last, *iter) >= 0) {
+      valid = false;
+    }
+    last_entry = *iter;
+    last = &last_entry;
+    num_chained++;
+  }
+  return valid && num_chained == num_entries ? num_entries : -1;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::verifyPage(page_id_t page_id, int depth, int *leaf_depth, const MappingType *low,
+                                const MappingType *high, int *num_entries, bool *valid) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  auto node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  bool is_root = depth == 0;
+  if (node->GetSize() > node->GetMaxSize() || (!is_root && node->GetSize() < node->GetMinSize()) ||
+      (is_root && node->GetSize() < (node->IsLeafPage() ? 1 : 2))) {
+    *valid = false;
+  }
+
+  if (node->IsLeafPage()) {
+    if (*leaf_depth != -1 && *leaf_depth != depth) {
+      *valid = false;
+    }
+    *leaf_depth = depth;
+    auto leaf = reinterpret_cast<LeafPage *>(node);
+    for (int i = 0; i < leaf->GetSize(); i++) {
+      const MappingType &entry = leaf->GetItem(i);
+      if ((low != nullptr && compareEntries(entry, *low) < 0) ||
+          (high != nullptr && compareEntries(entry, *high) >= 0)) {
+        *valid = false;
+      }
+    }
+    *num_entries += leaf->GetSize();
+  } else {
+    auto internal = reinterpret_cast<InternalPage *>(node);
+    for (int i = 0; i < internal->GetSize(); i++) {
+      const MappingType *child_low = i == 0 ? low : &internal->KeyAt(i);
+      const MappingType *child_high = i + 1 == internal->GetSize() ? high : &internal->KeyAt(i + 1);
+      if (child_low != nullptr && child_high != nullptr && compareEntries(*child_low, *child_high) >= 0) {
+        *valid = false;
+      }
+      verifyPage(internal->ValueAt(i), depth + 1, leaf_depth, child_low, child_high, num_entries, valid);
+    }
+  }
+  buffer_pool_manager_->UnpinPage(page_id, false);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int BPLUSTREE_TYPE::compareEntries(const MappingType &lhs, const MappingType &rhs) {
+  int cmp = comparator_(lhs.first, rhs.first);
+  if (cmp != 0) {
+    return cmp;
+  }
+  if (lhs.second < rhs.second) {
+    return -1;
+  }
+  return rhs.second < lhs.second ? 1 : 0;
+}
+
+template class BPlusTree<GenericKey<4>, RID, GenericComparator<4>>;
+template class BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+template class BPlusTree<GenericKey<16>, RID, GenericComparator<16>>;
+template class BPlusTree<GenericKey<32>, RID, GenericComparator<32>>;
+template class BPlusTree<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_index.cpp
+//
+// Identification: src/storage/index/b_plus_tree_index.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <utility>
+#include <vector>
+
+#include "storage/index/b_plus_tree_index.h"
+
+namespace bustub {
+/*
+ * Constructor
+ */
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager)
+    : Index(metadata),
+      comparator_(metadata->GetKeySchema()),
+      container_(metadata->GetName(), buffer_pool_manager, comparator_) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // construct insert index key, a key that is cut off would match others
+  KeyType index_key;
+  if (!index_key.SetFromKey(key, GetKeySchema())) {
+    return false;
+  }
+
+  // the tree always has room, the insert fails only for an entry that is in it already
+  container_.Insert(index_key, rid, transaction);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // construct delete index key, a key that does not fit has no entries
+  KeyType index_key;
+  if (!index_key.SetFromKey(key, GetKeySchema())) {
+    return;
+  }
+
+  container_.Remove(index_key, rid, transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  // construct scan index key, a key that does not fit has no entries
+  KeyType index_key;
+  if (!index_key.SetFromKey(key, GetKeySchema())) {
+    return;
+  }
+
+  container_.GetValue(index_key, result, transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_INDEX_TYPE::BulkLoad(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) {
+  // the entries whose keys do not fit are left out
+  std::vector<MappingType> index_entries(entries.size());
+  size_t num_entries = 0;
+  for (const auto &entry : entries) {
+    if (index_entries[num_entries].first.SetFromKey(entry.first, GetKeySchema())) {
+      index_entries[num_entries++].second = entry.second;
+    }
+  }
+  index_entries.resize(num_entries);
+  // a tree that has entries already takes them one by one
+  if (!container_.BulkLoad(&index_entries, transaction)) {
+    for (const auto &entry : index_entries) {
+      container_.Insert(entry.first, entry.second, transaction);
+    }
+  }
+  return num_entries == entries.size();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanRange(const Tuple *low_key, const Tuple *high_key, std::vector<RID> *result,
+                                     Transaction *transaction) {
+  // a bound that is cut off still orders the stored keys right, which all fit, but for those equal to the cut low
+  // bound: they are below it
+  KeyType low_index_key;
+  bool low_cut = low_key != nullptr && !low_index_key.SetFromKey(*low_key, GetKeySchema());
+  auto iter = low_key == nullptr ? container_.Begin() : container_.Begin(low_index_key);
+  KeyType index_key;
+  if (high_key != nullptr) {
+    index_key.SetFromKey(*high_key, GetKeySchema());
+  }
+  // the scan stops at the first key above the range, the leaves after it are not touched
+  for (; !iter.IsEnd(); ++iter) {
+    if (high_key != nullptr && comparator_((*iter).first, index_key) > 0) {
+      break;
+    }
+    if (low_cut && comparator_((*iter).first, low_index_key) == 0) {
+      continue;
+    }
+    result->push_back((*iter).second);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator() { return container_.Begin(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &key) { return container_.Begin(key); }
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetEndIterator() { return container_.End(); }
+
+template class BPlusTreeIndex<GenericKey<4>, RID, GenericComparator<4>>;
+template class BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
+template class BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
+template class BPlusTreeIndex<GenericKey<32>, RID, GenericComparator<32>>;
+template class BPlusTreeIndex<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
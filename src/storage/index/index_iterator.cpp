@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_iterator.cpp
+//
+// Identification: src/storage/index/index_iterator.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/index_iterator.h"
+
+#include "common/rid.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *buffer_pool_manager, Page *leaf, int index)
+    : buffer_pool_manager_(buffer_pool_manager), leaf_(leaf), index_(index) {
+  skipToEntry();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::~IndexIterator() { release(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(IndexIterator &&other) noexcept
+    : buffer_pool_manager_(other.buffer_pool_manager_), leaf_(other.leaf_), index_(other.index_) {
+  other.leaf_ = nullptr;
+  other.index_ = 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator=(IndexIterator &&other) noexcept {
+  if (this != &other) {
+    release();
+    buffer_pool_manager_ = other.buffer_pool_manager_;
+    leaf_ = other.leaf_;
+    index_ = other.index_;
+    other.leaf_ = nullptr;
+    other.index_ = 0;
+  }
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+const MappingType &INDEXITERATOR_TYPE::operator*() const {
+  return reinterpret_cast<LeafPage *>(leaf_->GetData())->GetItem(index_);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
+  index_++;
+  skipToEntry();
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::skipToEntry() {
+  while (leaf_ != nullptr) {
+    auto leaf_page = reinterpret_cast<LeafPage *>(leaf_->GetData());
+    if (index_ < leaf_page->GetSize()) {
+      return;
+    }
+    page_id_t next_page_id = leaf_page->GetNextPageId();
+    Page *next = nullptr;
+    if (next_page_id != INVALID_PAGE_ID) {
+      next = buffer_pool_manager_->FetchPage(next_page_id);
+      next->RLatch();
+    }
+    release();
+    leaf_ = next;
+    index_ = 0;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::release() {
+  if (leaf_ != nullptr) {
+    leaf_->RUnlatch();
+    buffer_pool_manager_->UnpinPage(leaf_->GetPageId(), false);
+    leaf_ = nullptr;
+  }
+}
+
+template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
+template class IndexIterator<GenericKey<8>, RID, GenericComparator<8>>;
+template class IndexIterator<GenericKey<16>, RID, GenericComparator<16>>;
+template class IndexIterator<GenericKey<32>, RID, GenericComparator<32>>;
+template class IndexIterator<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
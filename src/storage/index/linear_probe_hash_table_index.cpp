@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <utility>
 #include <vector>
 
 #include "storage/index/linear_probe_hash_table_index.h"
@@ -8,37 +10,85 @@ namespace bustub {
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_INDEX_TYPE::LinearProbeHashTableIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager,
-                                                 size_t num_buckets, const HashFunction<KeyType> &hash_fn)
+                                                 size_t num_buckets, const HashFunction<KeyType> &hash_fn,
+                                                 LogManager *log_manager)
     : Index(metadata),
       comparator_(metadata->GetKeySchema()),
-      container_(metadata->GetName(), buffer_pool_manager, comparator_, num_buckets, hash_fn) {}
+      container_(metadata->GetName(), buffer_pool_manager, comparator_, num_buckets, hash_fn, log_manager) {}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
-  // construct insert index key
+bool HASH_TABLE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // construct insert index key, a key that is cut off would match others
   KeyType index_key;
-  index_key.SetFromKey(key);
+  if (!index_key.SetFromKey(key, GetKeySchema())) {
+    return false;
+  }
 
-  container_.Insert(transaction, index_key, rid);
+  if (container_.Insert(transaction, index_key, rid)) {
+    return true;
+  }
+  // the insert fails for a repeated entry as well, which is in the table
+  std::vector<RID> rids;
+  container_.GetValue(transaction, index_key, &rids);
+  return std::find(rids.begin(), rids.end(), rid) != rids.end();
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
-  // construct delete index key
+  // construct delete index key, a key that does not fit has no entries
   KeyType index_key;
-  index_key.SetFromKey(key);
+  if (!index_key.SetFromKey(key, GetKeySchema())) {
+    return;
+  }
 
   container_.Remove(transaction, index_key, rid);
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
-  // construct scan index key
+  // construct scan index key, a key that does not fit has no entries
   KeyType index_key;
-  index_key.SetFromKey(key);
+  if (!index_key.SetFromKey(key, GetKeySchema())) {
+    return;
+  }
 
   container_.GetValue(transaction, index_key, result);
 }
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_INDEX_TYPE::ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                                     Transaction *transaction) {
+  // construct scan index keys, the keys that do not fit have no entries
+  std::vector<KeyType> index_keys(keys.size());
+  std::vector<size_t> cut_keys;
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (!index_keys[i].SetFromKey(keys[i], GetKeySchema())) {
+      cut_keys.push_back(i);
+    }
+  }
+
+  container_.GetValues(transaction, index_keys, results);
+  for (size_t i : cut_keys) {
+    (*results)[i].clear();
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_INDEX_TYPE::BulkLoad(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) {
+  // the entries whose keys do not fit are left out
+  std::vector<MappingType> pairs(entries.size());
+  size_t num_pairs = 0;
+  for (const auto &entry : entries) {
+    if (pairs[num_pairs].first.SetFromKey(entry.first, GetKeySchema())) {
+      pairs[num_pairs++].second = entry.second;
+    }
+  }
+  pairs.resize(num_pairs);
+  std::vector<MappingType> dropped;
+  container_.BulkLoad(transaction, pairs, &dropped);
+  return dropped.empty() && num_pairs == entries.size();
+}
+
 template class LinearProbeHashTableIndex<GenericKey<4>, RID, GenericComparator<4>>;
 template class LinearProbeHashTableIndex<GenericKey<8>, RID, GenericComparator<8>>;
 template class LinearProbeHashTableIndex<GenericKey<16>, RID, GenericComparator<16>>;
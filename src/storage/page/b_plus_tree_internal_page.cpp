@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_internal_page.cpp
+//
+// Identification: src/storage/page/b_plus_tree_internal_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+
+#include "common/rid.h"
+#include "storage/index/generic_key.h"
+#include "storage/page/b_plus_tree_internal_page.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, int max_size) {
+  SetPageType(IndexPageType::INTERNAL_PAGE);
+  SetLSN();
+  SetSize(0);
+  SetMaxSize(max_size);
+  SetPageId(page_id);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+const MappingType &B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const { return array_[index].first; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const MappingType &separator) {
+  array_[index].first = separator;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const { return array_[index].second; }
+
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(page_id_t page_id) const {
+  for (int i = 0; i < GetSize(); i++) {
+    if (array_[i].second == page_id) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_INTERNAL_PAGE_TYPE::ChildIndex(const KeyType &key, const ValueType *value,
+                                               const KeyComparator &comparator) const {
+  // find the first separator above (key, value), the child left of it is the one to descend to
+  int low = 1;
+  int high = GetSize();
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    const MappingType &separator = array_[mid].first;
+    int cmp = comparator(separator.first, key);
+    if (cmp < 0 || (cmp == 0 && value != nullptr && !(*value < separator.second))) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low - 1;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::PopulateNewRoot(page_id_t old_page_id, const MappingType &separator,
+                                                     page_id_t new_page_id) {
+  array_[0].second = old_page_id;
+  array_[1] = std::make_pair(separator, new_page_id);
+  SetSize(2);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertAt(int index, const MappingType &separator, page_id_t page_id) {
+  memmove(static_cast<void *>(array_ + index + 1), static_cast<void *>(array_ + index),
+          (GetSize() - index) * sizeof(array_[0]));
+  array_[index] = std::make_pair(separator, page_id);
+  IncreaseSize(1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemoveAt(int index) {
+  memmove(static_cast<void *>(array_ + index), static_cast<void *>(array_ + index + 1),
+          (GetSize() - index - 1) * sizeof(array_[0]));
+  IncreaseSize(-1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+MappingType B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage *recipient) {
+  int keep = (GetSize() + 1) / 2;
+  int moved = GetSize() - keep;
+  memcpy(static_cast<void *>(recipient->array_), static_cast<void *>(array_ + keep), moved * sizeof(array_[0]));
+  recipient->SetSize(moved);
+  SetSize(keep);
+  // the first separator of the recipient has no use there, it separates both pages in the parent
+  return recipient->array_[0].first;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *recipient, const MappingType &middle_separator) {
+  array_[0].first = middle_separator;
+  memcpy(static_cast<void *>(recipient->array_ + recipient->GetSize()), static_cast<void *>(array_),
+         GetSize() * sizeof(array_[0]));
+  recipient->IncreaseSize(GetSize());
+  SetSize(0);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+MappingType B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeInternalPage *recipient,
+                                                             const MappingType &middle_separator) {
+  recipient->InsertAt(recipient->GetSize(), middle_separator, array_[0].second);
+  MappingType separator = array_[1].first;
+  RemoveAt(0);
+  return separator;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+MappingType B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *recipient,
+                                                              const MappingType &middle_separator) {
+  // the old first child of the recipient moves right of the middle separator
+  recipient->array_[0].first = middle_separator;
+  recipient->InsertAt(0, array_[GetSize() - 1].first, array_[GetSize() - 1].second);
+  IncreaseSize(-1);
+  return recipient->array_[0].first;
+}
+
+template class BPlusTreeInternalPage<GenericKey<4>, RID, GenericComparator<4>>;
+template class BPlusTreeInternalPage<GenericKey<8>, RID, GenericComparator<8>>;
+template class BPlusTreeInternalPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class BPlusTreeInternalPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class BPlusTreeInternalPage<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_leaf_page.cpp
+//
+// Identification: src/storage/page/b_plus_tree_leaf_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+
+#include "common/rid.h"
+#include "storage/index/generic_key.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, int max_size) {
+  SetPageType(IndexPageType::LEAF_PAGE);
+  SetLSN();
+  SetSize(0);
+  SetMaxSize(max_size);
+  SetPageId(page_id);
+  next_page_id_ = INVALID_PAGE_ID;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const { return next_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+INDEX_TEMPLATE_ARGUMENTS
+KeyType B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const { return array_[index].first; }
+
+INDEX_TEMPLATE_ARGUMENTS
+ValueType B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const { return array_[index].second; }
+
+INDEX_TEMPLATE_ARGUMENTS
+const MappingType &B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) const { return array_[index]; }
+
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const ValueType *value,
+                                         const KeyComparator &comparator) const {
+  int low = 0;
+  int high = GetSize();
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    int cmp = comparator(array_[mid].first, key);
+    if (cmp < 0 || (cmp == 0 && value != nullptr && array_[mid].second < *value)) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::IsEntryAt(int index, const KeyType &key, const ValueType &value,
+                                           const KeyComparator &comparator) const {
+  return index < GetSize() && comparator(array_[index].first, key) == 0 && array_[index].second == value;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::InsertAt(int index, const KeyType &key, const ValueType &value) {
+  memmove(static_cast<void *>(array_ + index + 1), static_cast<void *>(array_ + index),
+          (GetSize() - index) * sizeof(MappingType));
+  array_[index] = MappingType(key, value);
+  IncreaseSize(1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAt(int index) {
+  memmove(static_cast<void *>(array_ + index), static_cast<void *>(array_ + index + 1),
+          (GetSize() - index - 1) * sizeof(MappingType));
+  IncreaseSize(-1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *recipient) {
+  int keep = (GetSize() + 1) / 2;
+  int moved = GetSize() - keep;
+  memcpy(static_cast<void *>(recipient->array_), static_cast<void *>(array_ + keep), moved * sizeof(MappingType));
+  recipient->SetSize(moved);
+  SetSize(keep);
+  recipient->SetNextPageId(next_page_id_);
+  next_page_id_ = recipient->GetPageId();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {
+  memcpy(static_cast<void *>(recipient->array_ + recipient->GetSize()), static_cast<void *>(array_),
+         GetSize() * sizeof(MappingType));
+  recipient->IncreaseSize(GetSize());
+  recipient->SetNextPageId(next_page_id_);
+  SetSize(0);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient) {
+  recipient->InsertAt(recipient->GetSize(), array_[0].first, array_[0].second);
+  RemoveAt(0);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient) {
+  recipient->InsertAt(0, array_[GetSize() - 1].first, array_[GetSize() - 1].second);
+  IncreaseSize(-1);
+}
+
+template class BPlusTreeLeafPage<GenericKey<4>, RID, GenericComparator<4>>;
+template class BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
+template class BPlusTreeLeafPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class BPlusTreeLeafPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class BPlusTreeLeafPage<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -0,0 +1,44 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_page.cpp
+//
+// Identification: src/storage/page/b_plus_tree_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+bool BPlusTreePage::IsLeafPage() const { return page_type_ == IndexPageType::LEAF_PAGE; }
+
+void BPlusTreePage::SetPageType(IndexPageType page_type) { page_type_ = page_type; }
+
+int BPlusTreePage::GetSize() const { return size_; }
+
+void BPlusTreePage::SetSize(int size) { size_ = size; }
+
+void BPlusTreePage::IncreaseSize(int amount) { size_ += amount; }
+
+int BPlusTreePage::GetMaxSize() const { return max_size_; }
+
+void BPlusTreePage::SetMaxSize(int max_size) { max_size_ = max_size; }
+
+int BPlusTreePage::GetMinSize() const {
+  // two pages at the minimum, one of them short by an entry, always fit into one page
+  return IsLeafPage() ? max_size_ / 2 : (max_size_ + 1) / 2;
+}
+
+page_id_t BPlusTreePage::GetPageId() const { return page_id_; }
+
+void BPlusTreePage::SetPageId(page_id_t page_id) { page_id_ = page_id; }
+
+lsn_t BPlusTreePage::GetLSN() const { return lsn_; }
+
+void BPlusTreePage::SetLSN(lsn_t lsn) { lsn_ = lsn; }
+
+}  // namespace bustub
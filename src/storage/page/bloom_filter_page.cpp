@@ -0,0 +1,46 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter_page.cpp
+//
+// Identification: src/storage/page/bloom_filter_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/bloom_filter_page.h"
+
+namespace bustub {
+
+void BloomFilterPage::Init(page_id_t page_id) {
+  page_id_ = page_id;
+  lsn_ = INVALID_LSN;
+  next_page_id_ = INVALID_PAGE_ID;
+  num_words_ = 0;
+  num_keys_ = 0;
+  owner_page_id_ = INVALID_PAGE_ID;
+}
+
+page_id_t BloomFilterPage::GetPageId() const { return page_id_; }
+
+page_id_t BloomFilterPage::GetNextPageId() const { return next_page_id_; }
+
+void BloomFilterPage::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+uint32_t BloomFilterPage::GetNumWords() const { return num_words_; }
+
+void BloomFilterPage::SetNumWords(uint32_t num_words) { num_words_ = num_words; }
+
+uint64_t BloomFilterPage::GetNumKeys() const { return num_keys_; }
+
+void BloomFilterPage::SetNumKeys(uint64_t num_keys) { num_keys_ = num_keys; }
+
+page_id_t BloomFilterPage::GetOwnerPageId() const { return owner_page_id_; }
+
+void BloomFilterPage::SetOwnerPageId(page_id_t owner_page_id) { owner_page_id_ = owner_page_id; }
+
+uint32_t *BloomFilterPage::GetWords() { return words_; }
+
+}  // namespace bustub
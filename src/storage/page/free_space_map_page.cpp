@@ -0,0 +1,45 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_page.cpp
+//
+// Identification: src/storage/page/free_space_map_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/free_space_map_page.h"
+
+namespace bustub {
+
+void FreeSpaceMapPage::Init(page_id_t page_id) {
+  page_id_ = page_id;
+  lsn_ = INVALID_LSN;
+  next_page_id_ = INVALID_PAGE_ID;
+  num_entries_ = 0;
+}
+
+page_id_t FreeSpaceMapPage::GetPageId() const { return page_id_; }
+
+page_id_t FreeSpaceMapPage::GetNextPageId() const { return next_page_id_; }
+
+void FreeSpaceMapPage::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+uint32_t FreeSpaceMapPage::GetNumEntries() const { return num_entries_; }
+
+void FreeSpaceMapPage::SetNumEntries(uint32_t num_entries) { num_entries_ = num_entries; }
+
+page_id_t FreeSpaceMapPage::TablePageIdAt(uint32_t index) const { return table_page_ids_[index]; }
+
+uint8_t FreeSpaceMapPage::CategoryAt(uint32_t index) const { return categories_[index]; }
+
+void FreeSpaceMapPage::SetEntryAt(uint32_t index, page_id_t table_page_id, uint8_t category) {
+  table_page_ids_[index] = table_page_id;
+  categories_[index] = category;
+}
+
+void FreeSpaceMapPage::SetCategoryAt(uint32_t index, uint8_t category) { categories_[index] = category; }
+
+}  // namespace bustub
@@ -0,0 +1,33 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_anchor_page.cpp
+//
+// Identification: src/storage/page/hash_table_anchor_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/hash_table_anchor_page.h"
+
+namespace bustub {
+
+page_id_t HashTableAnchorPage::GetPageId() const { return page_id_; }
+
+void HashTableAnchorPage::SetPageId(page_id_t page_id) { page_id_ = page_id; }
+
+lsn_t HashTableAnchorPage::GetLSN() const { return lsn_; }
+
+void HashTableAnchorPage::SetLSN(lsn_t lsn) { lsn_ = lsn; }
+
+page_id_t HashTableAnchorPage::GetHeaderPageId() const { return header_page_id_; }
+
+void HashTableAnchorPage::SetHeaderPageId(page_id_t header_page_id) { header_page_id_ = header_page_id; }
+
+page_id_t HashTableAnchorPage::GetOldHeaderPageId() const { return old_header_page_id_; }
+
+void HashTableAnchorPage::SetOldHeaderPageId(page_id_t old_header_page_id) { old_header_page_id_ = old_header_page_id; }
+
+}  // namespace bustub
@@ -11,6 +11,14 @@
 //===----------------------------------------------------------------------===//
 
 #include "storage/page/hash_table_block_page.h"
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "recovery/page_delta.h"
 #include "storage/index/generic_key.h"
 #include "storage/page/page.h"
 
@@ -27,13 +35,17 @@ ValueType HASH_TABLE_BLOCK_TYPE::ValueAt(slot_offset_t bucket_ind) const {
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-bool HASH_TABLE_BLOCK_TYPE::Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value) {
+bool HASH_TABLE_BLOCK_TYPE::Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value,
+                                   uint8_t tag) {
+  static_assert(sizeof(HashTableBlockPage) + BLOCK_ARRAY_SIZE * sizeof(MappingType) <= PAGE_SIZE,
+                "The slots must fit into a page.");
   if (IsReadable(bucket_ind)) {
     return false;
   }
 
   occupied_[bucket_ind / 8] |= (1 << (7 - (bucket_ind % 8)));
   readable_[bucket_ind / 8] |= (1 << (7 - (bucket_ind % 8)));
+  tags_[bucket_ind] = tag;
   array_[bucket_ind] = std::make_pair(key, value);
   return true;
 }
@@ -43,6 +55,11 @@ void HASH_TABLE_BLOCK_TYPE::Remove(slot_offset_t bucket_ind) {
   readable_[bucket_ind / 8] &= ~(1 << (7 - (bucket_ind % 8)));
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BLOCK_TYPE::Free(slot_offset_t bucket_ind) {
+  occupied_[bucket_ind / 8] &= ~(1 << (7 - (bucket_ind % 8)));
+}
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_BLOCK_TYPE::IsOccupied(slot_offset_t bucket_ind) const {
   return (occupied_[bucket_ind / 8] >> (7 - (bucket_ind % 8))) & 1;
@@ -53,6 +70,123 @@ bool HASH_TABLE_BLOCK_TYPE::IsReadable(slot_offset_t bucket_ind) const {
   return (readable_[bucket_ind / 8] >> (7 - (bucket_ind % 8))) & 1;
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint8_t HASH_TABLE_BLOCK_TYPE::TagAt(slot_offset_t bucket_ind) const {
+  return tags_[bucket_ind];
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_BLOCK_TYPE::ProbeGroup(slot_offset_t bucket_ind, uint32_t num_slots, uint8_t tag,
+                                           uint32_t *matches, uint32_t *free_slots) const {
+  const uint32_t occupied = FlagsAt(occupied_, bucket_ind);
+  const uint32_t run = ~occupied == 0 ? 32 : __builtin_ctz(~occupied);
+  const uint32_t num_occupied = run < num_slots ? run : num_slots;
+  // the unoccupied slot that ends the probe is part of it, it is where an insert goes
+  const uint32_t probed = num_occupied < num_slots ? num_occupied + 1 : num_slots;
+  const uint32_t probed_mask = probed == 32 ? ~0U : (1U << probed) - 1;
+
+#if defined(__AVX2__)
+  const __m256i group = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(tags_ + bucket_ind));
+  auto tag_matches =
+      static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(group, _mm256_set1_epi8(static_cast<char>(tag)))));
+#elif defined(__SSE2__)
+  const __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tags_ + bucket_ind));
+  auto tag_matches =
+      static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(tag)))));
+#else
+  uint32_t tag_matches = 0;
+  for (uint32_t i = 0; i < num_slots; i++) {
+    tag_matches |= static_cast<uint32_t>(tags_[bucket_ind + i] == tag) << i;
+  }
+#endif
+  const uint32_t readable = FlagsAt(readable_, bucket_ind);
+  *matches = tag_matches & readable & probed_mask;
+  *free_slots = ~readable & probed_mask;
+  return num_occupied;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BLOCK_TYPE::PrefetchGroup(slot_offset_t bucket_ind) const {
+  __builtin_prefetch(occupied_ + bucket_ind / 8);
+  __builtin_prefetch(readable_ + bucket_ind / 8);
+  __builtin_prefetch(tags_ + bucket_ind);
+  // a probe that finds its key compares it within the first few pairs
+  __builtin_prefetch(array_ + bucket_ind);
+  __builtin_prefetch(reinterpret_cast<const char *>(array_ + bucket_ind) + 64);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_BLOCK_TYPE::FlagsAt(const std::atomic_char *bitmap, slot_offset_t bucket_ind) {
+  // the flags are stored from the highest bit of a byte on, reverse the bytes so that bit i belongs to slot i
+  constexpr size_t bitmap_size = (BLOCK_ARRAY_SIZE - 1) / 8 + 1;
+  uint64_t flags = 0;
+  for (size_t i = 0; i <= TAG_GROUP_SIZE / 8 && bucket_ind / 8 + i < bitmap_size; i++) {
+    auto byte = static_cast<uint8_t>(bitmap[bucket_ind / 8 + i].load(std::memory_order_relaxed));
+    uint64_t reversed = ((byte * 0x0802LU & 0x22110LU) | (byte * 0x8020LU & 0x88440LU)) * 0x10101LU >> 16 & 0xff;
+    flags |= reversed << (8 * i);
+  }
+  return static_cast<uint32_t>(flags >> (bucket_ind % 8));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+std::string HASH_TABLE_BLOCK_TYPE::InsertDelta(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value,
+                                               uint8_t tag) const {
+  std::string delta;
+  if (IsReadable(bucket_ind)) {
+    return delta;
+  }
+  const char flag = static_cast<char>(1 << (7 - (bucket_ind % 8)));
+  const char old_occupied = occupied_[bucket_ind / 8];
+  const char new_occupied = static_cast<char>(old_occupied | flag);
+  PageDelta::Append(&delta, OffsetOf(&occupied_[bucket_ind / 8]), &old_occupied, &new_occupied, 1);
+  const char old_readable = readable_[bucket_ind / 8];
+  const char new_readable = static_cast<char>(old_readable | flag);
+  PageDelta::Append(&delta, OffsetOf(&readable_[bucket_ind / 8]), &old_readable, &new_readable, 1);
+  PageDelta::Append(&delta, OffsetOf(&tags_[bucket_ind]), reinterpret_cast<const char *>(&tags_[bucket_ind]),
+                    reinterpret_cast<const char *>(&tag), 1);
+  // Insert assigns the key and the value, the padding of the pair keeps its bytes
+  alignas(MappingType) char new_pair[sizeof(MappingType)];
+  memcpy(new_pair, &array_[bucket_ind], sizeof(MappingType));
+  reinterpret_cast<MappingType *>(new_pair)->first = key;
+  reinterpret_cast<MappingType *>(new_pair)->second = value;
+  PageDelta::Append(&delta, OffsetOf(&array_[bucket_ind]), reinterpret_cast<const char *>(&array_[bucket_ind]),
+                    new_pair, sizeof(MappingType));
+  return delta;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+std::string HASH_TABLE_BLOCK_TYPE::RemoveDelta(slot_offset_t bucket_ind) const {
+  std::string delta;
+  const char old_readable = readable_[bucket_ind / 8];
+  const char new_readable = static_cast<char>(old_readable & ~(1 << (7 - (bucket_ind % 8))));
+  PageDelta::Append(&delta, OffsetOf(&readable_[bucket_ind / 8]), &old_readable, &new_readable, 1);
+  return delta;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+std::string HASH_TABLE_BLOCK_TYPE::FreeDelta(slot_offset_t bucket_ind) const {
+  std::string delta;
+  const char old_occupied = occupied_[bucket_ind / 8];
+  const char new_occupied = static_cast<char>(old_occupied & ~(1 << (7 - (bucket_ind % 8))));
+  PageDelta::Append(&delta, OffsetOf(&occupied_[bucket_ind / 8]), &old_occupied, &new_occupied, 1);
+  return delta;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+lsn_t HASH_TABLE_BLOCK_TYPE::GetLSN() const {
+  return lsn_;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BLOCK_TYPE::SetLSN(lsn_t lsn) {
+  lsn_ = lsn;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_BLOCK_TYPE::OffsetOf(const void *ptr) const {
+  return reinterpret_cast<const char *>(ptr) - reinterpret_cast<const char *>(this);
+}
+
 // DO NOT REMOVE ANYTHING BELOW THIS LINE
 template class HashTableBlockPage<int, int, IntComparator>;
 template class HashTableBlockPage<GenericKey<4>, RID, GenericComparator<4>>;
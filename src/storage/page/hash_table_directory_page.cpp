@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_directory_page.cpp
+//
+// Identification: src/storage/page/hash_table_directory_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/hash_table_directory_page.h"
+
+#include <unordered_map>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+page_id_t HashTableDirectoryPage::GetPageId() const { return page_id_; }
+
+void HashTableDirectoryPage::SetPageId(page_id_t page_id) { page_id_ = page_id; }
+
+lsn_t HashTableDirectoryPage::GetLSN() const { return lsn_; }
+
+void HashTableDirectoryPage::SetLSN(lsn_t lsn) { lsn_ = lsn; }
+
+uint32_t HashTableDirectoryPage::GetGlobalDepth() const { return global_depth_; }
+
+uint32_t HashTableDirectoryPage::GetGlobalDepthMask() const { return (1U << global_depth_) - 1; }
+
+void HashTableDirectoryPage::IncrGlobalDepth() {
+  BUSTUB_ASSERT(global_depth_ < MAX_GLOBAL_DEPTH, "The directory page is full.");
+  const uint32_t size = Size();
+  for (uint32_t i = 0; i < size; i++) {
+    bucket_page_ids_[i + size] = bucket_page_ids_[i];
+    local_depths_[i + size] = local_depths_[i];
+  }
+  global_depth_++;
+}
+
+void HashTableDirectoryPage::DecrGlobalDepth() { global_depth_--; }
+
+bool HashTableDirectoryPage::CanShrink() const {
+  if (global_depth_ == 0) {
+    return false;
+  }
+  for (uint32_t i = 0; i < Size(); i++) {
+    if (local_depths_[i] == global_depth_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint32_t HashTableDirectoryPage::Size() const { return 1U << global_depth_; }
+
+page_id_t HashTableDirectoryPage::GetBucketPageId(uint32_t bucket_idx) const { return bucket_page_ids_[bucket_idx]; }
+
+void HashTableDirectoryPage::SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id) {
+  bucket_page_ids_[bucket_idx] = bucket_page_id;
+}
+
+uint32_t HashTableDirectoryPage::GetLocalDepth(uint32_t bucket_idx) const { return local_depths_[bucket_idx]; }
+
+void HashTableDirectoryPage::SetLocalDepth(uint32_t bucket_idx, uint32_t local_depth) {
+  local_depths_[bucket_idx] = local_depth;
+}
+
+uint32_t HashTableDirectoryPage::GetSplitImageIndex(uint32_t bucket_idx) const {
+  return bucket_idx ^ (1U << (local_depths_[bucket_idx] - 1));
+}
+
+void HashTableDirectoryPage::VerifyIntegrity() const {
+  std::unordered_map<page_id_t, uint32_t> page_id_to_count;
+  std::unordered_map<page_id_t, uint32_t> page_id_to_local_depth;
+  for (uint32_t i = 0; i < Size(); i++) {
+    BUSTUB_ASSERT(local_depths_[i] <= global_depth_, "A local depth is larger than the global depth.");
+    auto iter = page_id_to_local_depth.find(bucket_page_ids_[i]);
+    bool same_local_depth = iter == page_id_to_local_depth.end() || iter->second == local_depths_[i];
+    BUSTUB_ASSERT(same_local_depth, "The entries of a bucket have different local depths.");
+    page_id_to_local_depth[bucket_page_ids_[i]] = local_depths_[i];
+    page_id_to_count[bucket_page_ids_[i]]++;
+  }
+  for (const auto &[page_id, count] : page_id_to_count) {
+    bool right_count = count == (1U << (global_depth_ - page_id_to_local_depth[page_id]));
+    BUSTUB_ASSERT(right_count, "A bucket is not shared by the entries its local depth asks for.");
+  }
+}
+
+}  // namespace bustub
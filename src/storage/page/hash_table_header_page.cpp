@@ -27,6 +27,8 @@ void HashTableHeaderPage::AddBlockPageId(page_id_t page_id) { block_page_ids_[ne
 
 size_t HashTableHeaderPage::NumBlocks() { return next_ind_; }
 
+size_t HashTableHeaderPage::GetUsedSize() { return sizeof(HashTableHeaderPage) + next_ind_ * sizeof(page_id_t); }
+
 void HashTableHeaderPage::SetSize(size_t size) { size_ = size; }
 
 size_t HashTableHeaderPage::GetSize() const { return size_; }
@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.cpp
+//
+// Identification: src/storage/table/free_space_map.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/free_space_map.h"
+
+#include "storage/page/free_space_map_page.h"
+
+namespace bustub {
+
+FreeSpaceMap::FreeSpaceMap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id)
+    : buffer_pool_manager_(buffer_pool_manager), buckets_(NUM_CATEGORIES) {
+  for (page_id_t page_id = first_page_id; page_id != INVALID_PAGE_ID;) {
+    Page *page = buffer_pool_manager_->FetchPage(page_id);
+    auto map_page = reinterpret_cast<FreeSpaceMapPage *>(page->GetData());
+    for (uint32_t i = 0; i < map_page->GetNumEntries(); i++) {
+      addEntry(map_page->TablePageIdAt(i), map_page->CategoryAt(i));
+    }
+    map_page_ids_.push_back(page_id);
+    page_id_t next_page_id = map_page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+}
+
+page_id_t FreeSpaceMap::Persist() {
+  std::lock_guard<std::mutex> guard(latch_);
+  if (map_page_ids_.empty()) {
+    page_id_t page_id;
+    Page *page = buffer_pool_manager_->NewPage(&page_id);
+    BUSTUB_ASSERT(page != nullptr, "Couldn't create a page for the free space map.");
+    reinterpret_cast<FreeSpaceMapPage *>(page->GetData())->Init(page_id);
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    map_page_ids_.push_back(page_id);
+    for (uint32_t ordinal = 0; ordinal < table_page_ids_.size(); ordinal++) {
+      writeEntry(ordinal);
+    }
+  }
+  return map_page_ids_[0];
+}
+
+page_id_t FreeSpaceMap::GetFirstPageId() {
+  std::lock_guard<std::mutex> guard(latch_);
+  return map_page_ids_.empty() ? INVALID_PAGE_ID : map_page_ids_[0];
+}
+
+void FreeSpaceMap::AddPage(page_id_t table_page_id, uint32_t free_space) {
+  std::lock_guard<std::mutex> guard(latch_);
+  auto ordinal = ordinals_.find(table_page_id);
+  if (ordinal != ordinals_.end()) {
+    if (categories_[ordinal->second] != categoryOf(free_space)) {
+      setCategory(ordinal->second, categoryOf(free_space));
+      writeEntry(ordinal->second);
+    }
+    return;
+  }
+  addEntry(table_page_id, categoryOf(free_space));
+  writeEntry(table_page_ids_.size() - 1);
+}
+
+void FreeSpaceMap::Update(page_id_t table_page_id, uint32_t free_space) {
+  std::lock_guard<std::mutex> guard(latch_);
+  auto ordinal = ordinals_.find(table_page_id);
+  if (ordinal != ordinals_.end() && categories_[ordinal->second] != categoryOf(free_space)) {
+    setCategory(ordinal->second, categoryOf(free_space));
+    writeEntry(ordinal->second);
+  }
+}
+
+page_id_t FreeSpaceMap::FindPage(uint32_t space) {
+  std::lock_guard<std::mutex> guard(latch_);
+  // the category a page needs rounds up, so that any page in it or above has room
+  for (uint32_t category = (space + CATEGORY_SIZE - 1) / CATEGORY_SIZE; category < NUM_CATEGORIES; category++) {
+    if (!buckets_[category].empty()) {
+      return table_page_ids_[buckets_[category].back()];
+    }
+  }
+  return INVALID_PAGE_ID;
+}
+
+page_id_t FreeSpaceMap::GetLastPageId() {
+  std::lock_guard<std::mutex> guard(latch_);
+  return table_page_ids_.empty() ? INVALID_PAGE_ID : table_page_ids_.back();
+}
+
+size_t FreeSpaceMap::GetNumPages() {
+  std::lock_guard<std::mutex> guard(latch_);
+  return table_page_ids_.size();
+}
+
+void FreeSpaceMap::addEntry(page_id_t table_page_id, uint8_t category) {
+  auto ordinal = static_cast<uint32_t>(table_page_ids_.size());
+  table_page_ids_.push_back(table_page_id);
+  categories_.push_back(category);
+  ordinals_[table_page_id] = ordinal;
+  bucket_positions_.push_back(static_cast<uint32_t>(buckets_[category].size()));
+  buckets_[category].push_back(ordinal);
+}
+
+void FreeSpaceMap::setCategory(uint32_t ordinal, uint8_t category) {
+  // the last entry of the old bucket takes the place of the page
+  std::vector<uint32_t> &old_bucket = buckets_[categories_[ordinal]];
+  uint32_t moved = old_bucket.back();
+  old_bucket[bucket_positions_[ordinal]] = moved;
+  bucket_positions_[moved] = bucket_positions_[ordinal];
+  old_bucket.pop_back();
+
+  categories_[ordinal] = category;
+  bucket_positions_[ordinal] = static_cast<uint32_t>(buckets_[category].size());
+  buckets_[category].push_back(ordinal);
+}
+
+void FreeSpaceMap::writeEntry(uint32_t ordinal) {
+  if (map_page_ids_.empty()) {
+    return;
+  }
+  const uint32_t page_idx = ordinal / FreeSpaceMapPage::ENTRIES_PER_PAGE;
+  const uint32_t index = ordinal % FreeSpaceMapPage::ENTRIES_PER_PAGE;
+  if (page_idx == map_page_ids_.size()) {
+    page_id_t page_id;
+    Page *page = buffer_pool_manager_->NewPage(&page_id);
+    BUSTUB_ASSERT(page != nullptr, "Couldn't create a page for the free space map.");
+    reinterpret_cast<FreeSpaceMapPage *>(page->GetData())->Init(page_id);
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    Page *prev_page = buffer_pool_manager_->FetchPage(map_page_ids_.back());
+    reinterpret_cast<FreeSpaceMapPage *>(prev_page->GetData())->SetNextPageId(page_id);
+    buffer_pool_manager_->UnpinPage(map_page_ids_.back(), true);
+    map_page_ids_.push_back(page_id);
+  }
+
+  Page *page = buffer_pool_manager_->FetchPage(map_page_ids_[page_idx]);
+  auto map_page = reinterpret_cast<FreeSpaceMapPage *>(page->GetData());
+  map_page->SetEntryAt(index, table_page_ids_[ordinal], categories_[ordinal]);
+  map_page->SetNumEntries(std::max(map_page->GetNumEntries(), index + 1));
+  buffer_pool_manager_->UnpinPage(map_page_ids_[page_idx], true);
+}
+
+}  // namespace bustub
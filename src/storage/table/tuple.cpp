@@ -96,6 +96,16 @@ Value Tuple::GetValue(const Schema *schema, const uint32_t column_idx) const {
   return Value::DeserializeFrom(data_ptr, column_type);
 }
 
+Tuple Tuple::KeyFromTuple(const Schema &schema, const Schema &key_schema,
+                          const std::vector<uint32_t> &key_attrs) const {
+  std::vector<Value> values;
+  values.reserve(key_attrs.size());
+  for (auto idx : key_attrs) {
+    values.emplace_back(GetValue(&schema, idx));
+  }
+  return Tuple(values, &key_schema);
+}
+
 const char *Tuple::GetDataPtr(const Schema *schema, const uint32_t column_idx) const {
   assert(schema);
   assert(data_);
@@ -153,4 +163,13 @@ void Tuple::DeserializeFrom(const char *storage) {
   this->allocated_ = true;
 }
 
+void Tuple::DeserializeViewFrom(const char *storage) {
+  if (this->allocated_) {
+    delete[] this->data_;
+  }
+  this->size_ = *reinterpret_cast<const uint32_t *>(storage);
+  this->data_ = const_cast<char *>(storage + sizeof(int32_t));
+  this->allocated_ = false;
+}
+
 }  // namespace bustub
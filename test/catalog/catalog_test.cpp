@@ -47,6 +47,48 @@ TEST(CatalogTest, CreateTableTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(CatalogTest, CutOffKeyTest) {
+  auto disk_manager = new DiskManager("catalog_test.db");
+  auto bpm = new BufferPoolManager(32, disk_manager);
+  auto catalog = new SimpleCatalog(bpm, nullptr, nullptr);
+  Transaction txn(0);
+  Schema schema({Column("A", TypeId::INTEGER), Column("B", TypeId::VARCHAR, 32)});
+  auto *table_metadata = catalog->CreateTable(&txn, "potato", schema);
+  RID rid;
+  ASSERT_TRUE(table_metadata->table_->InsertTuple(
+      Tuple({ValueFactory::GetIntegerValue(1), ValueFactory::GetVarcharValue("ab")}, &schema), &rid, &txn));
+  ASSERT_TRUE(table_metadata->table_->InsertTuple(
+      Tuple({ValueFactory::GetIntegerValue(2), ValueFactory::GetVarcharValue("abcdefghijkl")}, &schema), &rid, &txn));
+
+  // the key of the second tuple takes 15 bytes, an index with shorter keys is refused
+  Schema key_schema({Column("B", TypeId::VARCHAR, 32)});
+  EXPECT_EQ(nullptr, (catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(&txn, "tree8", "potato", schema,
+                                                                                     key_schema, {1}, 8)));
+  EXPECT_EQ(nullptr, (catalog->CreateHashIndex<GenericKey<8>, RID, GenericComparator<8>>(
+                         &txn, "hash8", "potato", schema, key_schema, {1}, 8, 4)));
+
+  // once the keys fit, a longer key is not inserted and not found, rather than match the entries of its prefix
+  for (auto *index_info :
+       {catalog->CreateIndex<GenericKey<16>, RID, GenericComparator<16>>(&txn, "tree16", "potato", schema, key_schema,
+                                                                          {1}, 16),
+        catalog->CreateHashIndex<GenericKey<16>, RID, GenericComparator<16>>(&txn, "hash16", "potato", schema,
+                                                                              key_schema, {1}, 16, 4)}) {
+    ASSERT_NE(nullptr, index_info);
+    Tuple long_key({ValueFactory::GetVarcharValue("abcdefghijklmn")}, &key_schema);
+    EXPECT_FALSE(index_info->index_->InsertEntry(long_key, rid, &txn));
+    std::vector<RID> rids;
+    index_info->index_->ScanKey(long_key, &rids, &txn);
+    EXPECT_TRUE(rids.empty());
+    index_info->index_->ScanKey(Tuple({ValueFactory::GetVarcharValue("abcdefghijkl")}, &key_schema), &rids, &txn);
+    EXPECT_EQ(std::vector<RID>{rid}, rids);
+  }
+
+  delete catalog;
+  delete bpm;
+  delete disk_manager;
+}
+
 static unsigned int count;
 pthread_mutex_t lock;
 
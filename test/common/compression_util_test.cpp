@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compression_util_test.cpp
+//
+// Identification: test/common/compression_util_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/util/compression_util.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+static void CheckRoundTrip(const std::string &input, bool compressible) {
+  const int size = input.size();
+  std::vector<char> compressed(size + 1);
+  int compressed_size = CompressionUtil::Compress(input.data(), size, compressed.data(), size);
+  if (!compressible) {
+    EXPECT_EQ(0, compressed_size);
+    return;
+  }
+  ASSERT_LT(0, compressed_size);
+  EXPECT_LT(compressed_size, size);
+  std::vector<char> output(size);
+  ASSERT_TRUE(CompressionUtil::Decompress(compressed.data(), compressed_size, output.data(), size));
+  EXPECT_EQ(input, std::string(output.data(), size));
+}
+
+// NOLINTNEXTLINE
+TEST(CompressionUtilTest, RoundTripTest) {
+  // long runs need extra length bytes for both literals and matches
+  CheckRoundTrip(std::string(100000, 'x'), true);
+  std::string text;
+  for (int i = 0; i < 1000; i++) {
+    text += "log record " + std::to_string(i % 37) + " of transaction " + std::to_string(i % 5) + ";";
+  }
+  CheckRoundTrip(text, true);
+  std::mt19937 rng(7);
+  std::string random(300, '\0');
+  for (auto &c : random) {
+    c = static_cast<char>(rng());
+  }
+  CheckRoundTrip(random + std::string(5000, 'y') + random, true);
+  // random bytes do not shrink
+  CheckRoundTrip(random, false);
+}
+
+// NOLINTNEXTLINE
+TEST(CompressionUtilTest, CorruptBlockTest) {
+  std::string input(4096, 'a');
+  std::vector<char> compressed(input.size());
+  int compressed_size = CompressionUtil::Compress(input.data(), input.size(), compressed.data(), input.size());
+  ASSERT_LT(0, compressed_size);
+  std::vector<char> output(input.size());
+  // a wrong size or a truncated block is detected instead of overflowing the output
+  EXPECT_FALSE(CompressionUtil::Decompress(compressed.data(), compressed_size, output.data(), input.size() - 1));
+  EXPECT_FALSE(CompressionUtil::Decompress(compressed.data(), compressed_size - 2, output.data(), input.size()));
+}
+
+}  // namespace bustub
@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter_test.cpp
+//
+// Identification: test/container/bloom_filter_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <memory>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/util/hash_family.h"
+#include "container/hash/bloom_filter.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+uint64_t HashOf(uint64_t key) { return WyHashFamily::Hash(&key, sizeof(key)); }
+
+// NOLINTNEXTLINE
+TEST(BloomFilterTest, FalsePositiveTest) {
+  const uint64_t num_keys = 20000;
+  BloomFilter filter(num_keys, 10);
+  EXPECT_EQ(num_keys * 10 / 256 * 256, filter.NumBits());
+  for (uint64_t key = 0; key < num_keys; key++) {
+    filter.Add(HashOf(key));
+  }
+
+  // no added key is missed, and about 1% of the others pass
+  uint64_t false_positives = 0;
+  for (uint64_t key = 0; key < 10 * num_keys; key++) {
+    if (key < num_keys) {
+      ASSERT_TRUE(filter.MayContain(HashOf(key))) << key;
+    } else {
+      false_positives += filter.MayContain(HashOf(key)) ? 1 : 0;
+    }
+  }
+  EXPECT_LT(false_positives, 9 * num_keys / 50);
+}
+
+// NOLINTNEXTLINE
+TEST(BloomFilterTest, PersistTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(10, disk_manager);
+
+  // a filter over several pages reads back bit for bit
+  const uint64_t num_keys = 5000;
+  BloomFilter filter(num_keys, 16);
+  for (uint64_t key = 0; key < num_keys; key++) {
+    filter.Add(HashOf(key));
+  }
+  page_id_t first_page_id = filter.Persist(bpm, 42, num_keys);
+  std::unique_ptr<BloomFilter> loaded = BloomFilter::Load(bpm, first_page_id, 42, num_keys);
+  ASSERT_NE(nullptr, loaded);
+  EXPECT_EQ(filter.NumBits(), loaded->NumBits());
+  for (uint64_t key = 0; key < 10 * num_keys; key++) {
+    ASSERT_EQ(filter.MayContain(HashOf(key)), loaded->MayContain(HashOf(key))) << key;
+  }
+
+  // a filter written for another owner or another number of keys is not read
+  EXPECT_EQ(nullptr, BloomFilter::Load(bpm, first_page_id, 43, num_keys));
+  EXPECT_EQ(nullptr, BloomFilter::Load(bpm, first_page_id, 42, num_keys + 1));
+  BloomFilter::Drop(bpm, first_page_id);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+}  // namespace bustub
@@ -73,7 +73,7 @@ TEST(HashTablePageTest, BlockPageSampleTest) {
 
   // insert a few (key, value) pairs
   for (unsigned i = 0; i < 10; i++) {
-    block_page->Insert(i, i, i);
+    block_page->Insert(i, i, i, i % 3);
   }
 
   // check for the inserted pairs
@@ -103,6 +103,20 @@ TEST(HashTablePageTest, BlockPageSampleTest) {
     }
   }
 
+  // a probe for tag 0 from slot 0 matches the readable slots 0 and 6, may reuse the tombstones and ends at slot 10
+  uint32_t matches;
+  uint32_t free_slots;
+  EXPECT_EQ(10, block_page->ProbeGroup(0, 16, 0, &matches, &free_slots));
+  EXPECT_EQ(0b1000001U, matches);
+  EXPECT_EQ(0b1010101010U, free_slots & 0x3ff);
+  EXPECT_EQ(0x400U, free_slots & 0x400);
+  // the same probe from slot 4 only sees slot 6, and a group of full slots does not end the probe
+  EXPECT_EQ(6, block_page->ProbeGroup(4, 16, 0, &matches, &free_slots));
+  EXPECT_EQ(0b100U, matches);
+  EXPECT_EQ(4, block_page->ProbeGroup(2, 4, 2, &matches, &free_slots));
+  EXPECT_EQ(0b1U, matches);
+  EXPECT_EQ(2, block_page->TagAt(8));
+
   // unpin the header page now that we are done
   bpm->UnpinPage(block_page_id, true, nullptr);
   disk_manager->ShutDown();
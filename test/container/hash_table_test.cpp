@@ -10,13 +10,23 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <random>
 #include <thread>  // NOLINT
+#include <utility>
 #include <vector>
 
 #include "common/logger.h"
+#include "container/hash/extendible_hash_table.h"
 #include "container/hash/linear_probe_hash_table.h"
 #include "gtest/gtest.h"
 #include "murmur3/MurmurHash3.h"
+#include "storage/index/generic_key.h"
+#include "storage/index/hash_comparator.h"
+#include "storage/index/linear_probe_hash_table_index.h"
+#include "storage/table/tmp_tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
@@ -133,6 +143,342 @@ TEST(HashTableTest, ResizeTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTableTest, BulkLoadTest) {
+  using KeyType = int;
+  using ValueType = int;
+  const int bucket_size = BLOCK_ARRAY_SIZE;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  HashFunction<int> hash_fn;
+  LinearProbeHashTable<KeyType, ValueType, IntComparator> ht("blah", bpm, IntComparator(), 1, hash_fn);
+
+  // keys that hash to the last slot of a block, their probes run on into the next block, and around from the last
+  std::vector<std::pair<KeyType, ValueType>> pairs;
+  for (int i = 0; pairs.size() < 200; i++) {
+    if (hash_fn.GetHash(i) % bucket_size == bucket_size - 1) {
+      pairs.emplace_back(i, i);
+    }
+  }
+  int next_key = pairs.back().first + 1;
+  for (int i = 0; i < 3000; i++) {
+    pairs.emplace_back(next_key + i, next_key + i);
+  }
+  // a pair that is repeated is inserted once, another value of the same key is not a repeat
+  for (int i = 0; i < 100; i++) {
+    pairs.push_back(pairs[i]);
+    pairs.emplace_back(pairs[i].first, -1);
+  }
+  EXPECT_EQ(3300, ht.BulkLoad(nullptr, pairs));
+  EXPECT_EQ(3300, ht.GetSize());
+
+  for (int i = 0; i < 3200; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, pairs[i].first, &res);
+    ASSERT_EQ(i < 100 ? 2 : 1, res.size()) << "Failed to load " << pairs[i].first << std::endl;
+    EXPECT_NE(res.end(), std::find(res.begin(), res.end(), pairs[i].second));
+  }
+
+  // the loaded table takes single inserts and removes, and a table that is not empty loads pairs one by one
+  EXPECT_FALSE(ht.Insert(nullptr, pairs[0].first, pairs[0].second));
+  EXPECT_TRUE(ht.Remove(nullptr, pairs[0].first, pairs[0].second));
+  EXPECT_EQ(2, ht.BulkLoad(nullptr, {pairs[0], pairs[1], {-5, -5}}));
+  std::vector<int> res;
+  EXPECT_TRUE(ht.GetValue(nullptr, -5, &res));
+  EXPECT_EQ(3301, ht.GetSize());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, FullBulkLoadTest) {
+  using KeyType = int;
+  using ValueType = int;
+  using HashTable = LinearProbeHashTable<KeyType, ValueType, IntComparator>;
+  // about a thousand pages, kept out of the file that the other tests share
+  auto *disk_manager = new DiskManager("full_bulk_load_test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  HashTable ht("blah", bpm, IntComparator(), 1, HashFunction<int>());
+
+  // the pairs that find no room in a table of MAX_BLOCKS blocks are reported, whether loaded at once or one by one
+  const int capacity = HashTable::MAX_BLOCKS * BLOCK_ARRAY_SIZE;
+  std::vector<std::pair<int, int>> pairs;
+  for (int i = 0; i < capacity + 100; i++) {
+    pairs.emplace_back(i, i);
+  }
+  std::vector<std::pair<int, int>> dropped;
+  EXPECT_EQ(capacity, ht.BulkLoad(nullptr, pairs, &dropped));
+  EXPECT_EQ(100, dropped.size());
+  for (const auto &pair : dropped) {
+    std::vector<int> res;
+    EXPECT_FALSE(ht.GetValue(nullptr, pair.first, &res));
+  }
+
+  // a repeated pair is in the table, it is not dropped
+  std::vector<std::pair<int, int>> more{dropped[0], pairs[0]};
+  dropped.clear();
+  EXPECT_EQ(0, ht.BulkLoad(nullptr, more, &dropped));
+  ASSERT_EQ(1, dropped.size());
+  EXPECT_EQ(more[0], dropped[0]);
+
+  disk_manager->ShutDown();
+  remove("full_bulk_load_test.db");
+  remove("full_bulk_load_test.log");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, IncrementalResizeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1, HashFunction<int>());
+
+  // the pairs stay visible while they move from the old table to the new one
+  const int num_keys = 5000;
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+    if (i % 4 == 0) {
+      ASSERT_TRUE(ht.Remove(nullptr, i / 2, i / 2));
+    }
+    if (i % 97 == 0) {
+      for (int j = i / 2 + 1; j <= i; j++) {
+        std::vector<int> res;
+        ASSERT_TRUE(ht.GetValue(nullptr, j, &res)) << j;
+        EXPECT_EQ(std::vector<int>{j}, res);
+      }
+    }
+  }
+  // a pair is found once and cannot be inserted twice, wherever it is
+  for (int i = num_keys / 2; i < num_keys; i++) {
+    ASSERT_FALSE(ht.Insert(nullptr, i, i));
+  }
+  size_t size = num_keys - (num_keys + 3) / 4;
+  EXPECT_EQ(size, ht.GetSize());
+
+  // the table opens again from its anchor page, also while a resize is in progress
+  ht.Resize(64);
+  LinearProbeHashTable<int, int, IntComparator> reopened("blah", bpm, IntComparator(), HashFunction<int>(),
+                                                         ht.GetAnchorPageId());
+  EXPECT_EQ(size, reopened.GetSize());
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_EQ(i % 2 != 0 || i >= num_keys / 2, reopened.GetValue(nullptr, i, &res)) << i;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, BatchLookupTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1, HashFunction<int>());
+
+  // batches of present, repeated and absent keys find what single lookups find, also while a resize is in progress
+  const int num_keys = 3000;
+  std::vector<int> keys;
+  for (int i = 0; i < 2 * num_keys; i++) {
+    keys.push_back(i * 7 % (2 * num_keys));
+  }
+  keys.push_back(keys[0]);
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+    if (i % 3 == 0) {
+      ASSERT_TRUE(ht.Insert(nullptr, i, num_keys + i));
+    }
+    if (i % 401 == 0) {
+      std::vector<std::vector<int>> results;
+      ht.GetValues(nullptr, keys, &results);
+      ASSERT_EQ(keys.size(), results.size());
+      for (size_t j = 0; j < keys.size(); j++) {
+        std::vector<int> res;
+        ht.GetValue(nullptr, keys[j], &res);
+        std::sort(res.begin(), res.end());
+        std::sort(results[j].begin(), results[j].end());
+        ASSERT_EQ(res, results[j]) << keys[j];
+        EXPECT_EQ(keys[j] > i ? 0U : keys[j] % 3 == 0 ? 2U : 1U, res.size());
+      }
+    }
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ChurnTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 4, HashFunction<int>());
+
+  // removes move pairs back into their holes, the pairs stay visible and none is found twice
+  const int num_keys = 600;
+  std::mt19937 gen(11);
+  std::vector<int> present;
+  int next_key = 0;
+  for (; next_key < num_keys; next_key++) {
+    ASSERT_TRUE(ht.Insert(nullptr, next_key, next_key));
+    present.push_back(next_key);
+  }
+  for (int round = 0; round < 30; round++) {
+    std::shuffle(present.begin(), present.end(), gen);
+    for (int i = 0; i < num_keys / 2; i++) {
+      ASSERT_TRUE(ht.Remove(nullptr, present.back(), present.back()));
+      present.pop_back();
+    }
+    for (int i = 0; i < num_keys / 2; i++, next_key++) {
+      ASSERT_TRUE(ht.Insert(nullptr, next_key, next_key));
+      present.push_back(next_key);
+    }
+    for (int key = 0; key < next_key; key++) {
+      std::vector<int> res;
+      ht.GetValue(nullptr, key, &res);
+      bool is_present = std::find(present.begin(), present.end(), key) != present.end();
+      ASSERT_EQ(is_present ? std::vector<int>{key} : std::vector<int>{}, res) << key;
+    }
+  }
+  EXPECT_EQ(present.size(), ht.GetSize());
+
+  // a table emptied by removes has no tombstones left, every probe ends at its first slot
+  double hit_length;
+  double miss_length;
+  ht.ProbeLengths(&hit_length, &miss_length);
+  EXPECT_GE(hit_length, 1);
+  for (int key : present) {
+    ASSERT_TRUE(ht.Remove(nullptr, key, key));
+  }
+  ht.ProbeLengths(&hit_length, &miss_length);
+  EXPECT_EQ(0, hit_length);
+  EXPECT_EQ(1, miss_length);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, GetValuesSmallPoolTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(8, disk_manager);
+
+  // the keys of a group start in more blocks than the buffer pool holds
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 64, HashFunction<int>());
+  const int num_keys = 1000;
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  std::vector<int> keys;
+  for (int i = 0; i < 2 * num_keys; i++) {
+    keys.push_back(i);
+  }
+  std::vector<std::vector<int>> results;
+  ht.GetValues(nullptr, keys, &results);
+  for (int i = 0; i < 2 * num_keys; i++) {
+    EXPECT_EQ(i < num_keys ? std::vector<int>{i} : std::vector<int>{}, results[i]) << i;
+  }
+
+  // no page is left pinned
+  for (int i = num_keys; i < 2 * num_keys; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  EXPECT_EQ(static_cast<size_t>(2 * num_keys), ht.GetSize());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, BloomFilterTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1, HashFunction<int>());
+  for (int i = 0; i < 100; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  ht.EnableBloomFilter(10);
+
+  // the filter is built from the pairs, takes the new ones and is rebuilt by the resizes on the way
+  const int num_keys = 3000;
+  for (int i = 100; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+    if (i % 401 == 0) {
+      for (int j = 0; j <= i; j++) {
+        std::vector<int> res;
+        ASSERT_TRUE(ht.GetValue(nullptr, j, &res)) << j;
+      }
+    }
+  }
+  std::vector<int> keys;
+  for (int i = 0; i < 2 * num_keys; i++) {
+    keys.push_back(i);
+  }
+  std::vector<std::vector<int>> results;
+  ht.GetValues(nullptr, keys, &results);
+  for (int i = 0; i < 2 * num_keys; i++) {
+    EXPECT_EQ(i < num_keys ? std::vector<int>{i} : std::vector<int>{}, results[i]) << i;
+  }
+
+  // a removed pair may still pass the filter, but it is not found
+  ASSERT_TRUE(ht.Remove(nullptr, 7, 7));
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, 7, &res));
+  ASSERT_TRUE(ht.Insert(nullptr, 7, 7));
+
+  // the persisted filter opens again with the table
+  page_id_t filter_page_id = ht.PersistBloomFilter();
+  ASSERT_NE(INVALID_PAGE_ID, filter_page_id);
+  LinearProbeHashTable<int, int, IntComparator> reopened("blah", bpm, IntComparator(), HashFunction<int>(),
+                                                         ht.GetAnchorPageId());
+  reopened.EnableBloomFilter(10, filter_page_id);
+  for (int i = 0; i < 2 * num_keys; i++) {
+    res.clear();
+    EXPECT_EQ(i < num_keys, reopened.GetValue(nullptr, i, &res)) << i;
+  }
+
+  // a pair inserted since by a table that does not know the filter changes the pair count, the filter is rebuilt
+  LinearProbeHashTable<int, int, IntComparator> plain("blah", bpm, IntComparator(), HashFunction<int>(),
+                                                      ht.GetAnchorPageId());
+  ASSERT_TRUE(plain.Insert(nullptr, num_keys, num_keys));
+  LinearProbeHashTable<int, int, IntComparator> counted("blah", bpm, IntComparator(), HashFunction<int>(),
+                                                        ht.GetAnchorPageId());
+  counted.EnableBloomFilter(10, filter_page_id);
+  res.clear();
+  EXPECT_TRUE(counted.GetValue(nullptr, num_keys, &res));
+
+  // an insert that a remove evens out marks the filter pages stale
+  filter_page_id = counted.PersistBloomFilter();
+  ASSERT_TRUE(counted.Insert(nullptr, num_keys + 1, num_keys + 1));
+  ASSERT_TRUE(counted.Remove(nullptr, num_keys, num_keys));
+  LinearProbeHashTable<int, int, IntComparator> marked("blah", bpm, IntComparator(), HashFunction<int>(),
+                                                       ht.GetAnchorPageId());
+  marked.EnableBloomFilter(10, filter_page_id);
+  for (int i = 0; i < 2 * num_keys; i++) {
+    res.clear();
+    EXPECT_EQ(i < num_keys || i == num_keys + 1, marked.GetValue(nullptr, i, &res)) << i;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 static unsigned int count;
 pthread_mutex_t lock;
 
@@ -183,4 +529,665 @@ TEST(HashTableTest, ConcurrentTest) {
   delete disk_manager;
   delete bpm;
 }
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ConcurrentDuplicateInsertTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 2, HashFunction<int>());
+
+  // every thread inserts the same pairs, each pair is inserted by exactly one of them
+  const int num_threads = 4;
+  const int num_keys = 3000;
+  std::vector<int> inserted(num_threads, 0);
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&ht, &inserted, tid] {
+      for (int i = 0; i < num_keys; i++) {
+        int key = (i * 7 + tid) % num_keys;
+        if (ht.Insert(nullptr, key / 2, key)) {
+          inserted[tid]++;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  int total = 0;
+  for (int count : inserted) {
+    total += count;
+  }
+  EXPECT_EQ(num_keys, total);
+  EXPECT_EQ(num_keys, ht.GetSize());
+  for (int i = 0; i < num_keys / 2; i++) {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+    std::sort(res.begin(), res.end());
+    EXPECT_EQ((std::vector<int>{2 * i, 2 * i + 1}), res);
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ExtendibleSampleTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    EXPECT_TRUE(ht.Insert(nullptr, i, 2 * i + 1));
+    // duplicate values for the same key are not allowed
+    EXPECT_FALSE(ht.Insert(nullptr, i, i));
+  }
+  EXPECT_EQ(10, ht.GetSize());
+  for (int i = 0; i < 5; i++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    std::sort(res.begin(), res.end());
+    EXPECT_EQ((std::vector<int>{i, 2 * i + 1}), res);
+  }
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, 20, &res));
+
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    EXPECT_FALSE(ht.Remove(nullptr, i, i));
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ(std::vector<int>{2 * i + 1}, res);
+  }
+  // the slot of a removed pair is reused
+  EXPECT_TRUE(ht.Insert(nullptr, 0, 0));
+  res.clear();
+  EXPECT_TRUE(ht.GetValue(nullptr, 0, &res));
+  EXPECT_EQ(2, res.size());
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ExtendibleSplitMergeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // the buckets split one at a time
+  const int num_keys = 20000;
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  ht.VerifyIntegrity();
+  uint32_t global_depth = ht.GetGlobalDepth();
+  EXPECT_LT(0, global_depth);
+  EXPECT_EQ(num_keys, ht.GetSize());
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ(std::vector<int>{i}, res);
+  }
+
+  // the emptied buckets merge and the directory shrinks
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  ht.VerifyIntegrity();
+  EXPECT_GT(global_depth, ht.GetGlobalDepth());
+  EXPECT_EQ(0, ht.GetSize());
+  for (int i = 0; i < num_keys; i += 7) {
+    std::vector<int> res;
+    EXPECT_FALSE(ht.GetValue(nullptr, i, &res));
+  }
+
+  // more pairs of a single key than a bucket holds cannot be split apart
+  using KeyType = int;
+  using ValueType = int;
+  const int bucket_size = BLOCK_ARRAY_SIZE;
+  int num_values = 0;
+  while (num_values < 2 * bucket_size && ht.Insert(nullptr, -1, num_values)) {
+    num_values++;
+  }
+  EXPECT_EQ(bucket_size, num_values);
+  EXPECT_EQ(MAX_GLOBAL_DEPTH, ht.GetGlobalDepth());
+  ht.VerifyIntegrity();
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ExtendibleConcurrentTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  const int num_threads = 8;
+  const int num_keys = 2000;
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&ht, tid] {
+      for (int i = tid; i < num_keys * num_threads; i += num_threads) {
+        EXPECT_TRUE(ht.Insert(nullptr, i, i));
+        std::vector<int> res;
+        EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+      }
+      // every thread removes half of its keys again
+      for (int i = tid; i < num_keys * num_threads; i += 2 * num_threads) {
+        EXPECT_TRUE(ht.Remove(nullptr, i, i));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  ht.VerifyIntegrity();
+  EXPECT_EQ(num_keys * num_threads / 2, ht.GetSize());
+  for (int i = 0; i < num_keys * num_threads; i++) {
+    std::vector<int> res;
+    EXPECT_EQ(i % (2 * num_threads) >= num_threads, ht.GetValue(nullptr, i, &res)) << i;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, HashFamilyTest) {
+  // every family tells apart short inputs that differ in one byte or in length only
+  auto distinct = [](auto hash) {
+    std::vector<uint64_t> hashes;
+    uint8_t bytes[24] = {0};
+    for (size_t length = 0; length <= sizeof(bytes); length++) {
+      hashes.push_back(hash(bytes, length));
+      for (size_t i = 0; i < length; i++) {
+        bytes[i] = 1;
+        hashes.push_back(hash(bytes, length));
+        bytes[i] = 0;
+      }
+    }
+    std::sort(hashes.begin(), hashes.end());
+    return std::adjacent_find(hashes.begin(), hashes.end()) == hashes.end();
+  };
+  EXPECT_TRUE(distinct(MurmurHashFamily::Hash));
+  EXPECT_TRUE(distinct(WyHashFamily::Hash));
+#ifdef __SSE4_2__
+  EXPECT_TRUE(distinct(Crc32HashFamily::Hash));
+#endif
+
+  // consecutive integers spread over the slots of a block and over the tags
+  using KeyType = int;
+  using ValueType = int;
+  HashFunction<KeyType> int_hash;
+  std::vector<int> slots(BLOCK_ARRAY_SIZE);
+  std::vector<int> tags(256);
+  const int num_keys = 100000;
+  for (int i = 0; i < num_keys; i++) {
+    uint64_t hash = int_hash.GetHash(i);
+    slots[hash % slots.size()]++;
+    tags[hash >> 56]++;
+  }
+  EXPECT_LT(*std::max_element(slots.begin(), slots.end()), 2 * num_keys / static_cast<int>(slots.size()));
+  EXPECT_LT(*std::max_element(tags.begin(), tags.end()), 2 * num_keys / 256);
+
+  // a hash_t key is taken as is, a GenericKey is hashed over its bytes up to the last nonzero word only
+  EXPECT_EQ(12345U, HashFunction<hash_t>().GetHash(12345));
+  GenericKey<8> short_key;
+  GenericKey<64> long_key;
+  short_key.SetFromInteger(42);
+  long_key.SetFromInteger(42);
+  EXPECT_EQ(HashFunction<GenericKey<8>>().GetHash(short_key), HashFunction<GenericKey<64>>().GetHash(long_key));
+  long_key.SetFromInteger(43);
+  EXPECT_NE(HashFunction<GenericKey<8>>().GetHash(short_key), HashFunction<GenericKey<64>>().GetHash(long_key));
+}
+
+/** Inserts keys into the table and logs the percentiles of the latencies of the inserts. */
+static void InsertLatencyBenchmark(const std::string &name, HashTable<int, int, IntComparator> *ht, int num_keys,
+                                   int first_key = 0) {
+  std::vector<double> latencies;
+  latencies.reserve(num_keys);
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = first_key; i < first_key + num_keys; i++) {
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(ht->Insert(nullptr, i, i));
+    latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+  }
+  double total = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&](double p) { return latencies[static_cast<size_t>(p * (latencies.size() - 1))]; };
+  LOG_INFO("%s: %d inserts in %.1f ms, p50 %.1f us, p99 %.1f us, p999 %.1f us, max %.1f us", name.c_str(), num_keys,
+           total, percentile(0.5), percentile(0.99), percentile(0.999), latencies.back());
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_GrowthLatencyBenchmark) {
+  const int num_keys = 100000;
+  {
+    auto *disk_manager = new DiskManager("test.db");
+    auto *bpm = new BufferPoolManager(50, disk_manager);
+    LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1, HashFunction<int>());
+    InsertLatencyBenchmark("linear probe", &ht, num_keys);
+    disk_manager->ShutDown();
+    remove("test.db");
+    delete disk_manager;
+    delete bpm;
+  }
+  {
+    auto *disk_manager = new DiskManager("test.db");
+    auto *bpm = new BufferPoolManager(50, disk_manager);
+    ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+    InsertLatencyBenchmark("extendible", &ht, num_keys);
+    ht.VerifyIntegrity();
+    disk_manager->ShutDown();
+    remove("test.db");
+    delete disk_manager;
+    delete bpm;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_IncrementalResizeBenchmark) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1, HashFunction<int>());
+
+  // the tail of every window stays flat while the table keeps doubling
+  const int window = 50000;
+  for (int i = 0; i < 4; i++) {
+    InsertLatencyBenchmark("keys " + std::to_string(i * window) + "+", &ht, window, i * window);
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_ConcurrentMixedBenchmark) {
+  const int num_keys = 50000;
+  const int num_ops = 40000;
+  for (int num_threads = 1; num_threads <= 8; num_threads *= 2) {
+    auto *disk_manager = new DiskManager("test.db");
+    auto *bpm = new BufferPoolManager(50, disk_manager);
+    LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 256, HashFunction<int>());
+    for (int i = 0; i < num_keys; i++) {
+      ht.Insert(nullptr, i, i);
+    }
+
+    // 80% lookups, 10% inserts and 10% removes of the inserted keys, spread over the threads
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int tid = 0; tid < num_threads; tid++) {
+      threads.emplace_back([&ht, tid, num_threads] {
+        int next_key = num_keys + tid;
+        for (int i = 0; i < num_ops / num_threads; i++) {
+          std::vector<int> res;
+          if (i % 10 == 0) {
+            ht.Insert(nullptr, next_key, next_key);
+          } else if (i % 10 == 5) {
+            ht.Remove(nullptr, next_key, next_key);
+            next_key += num_threads;
+          } else {
+            ht.GetValue(nullptr, (i * 7919 + tid) % num_keys, &res);
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO("%d threads: %d operations in %.1f ms, %.0f operations/s", num_threads, num_ops, ms, num_ops * 1000 / ms);
+
+    disk_manager->ShutDown();
+    remove("test.db");
+    delete disk_manager;
+    delete bpm;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_LongProbeLookupBenchmark) {
+  using KeyType = GenericKey<8>;
+  using ValueType = RID;
+  const int bucket_size = BLOCK_ARRAY_SIZE;
+  const int num_blocks = 63;
+  const int num_keys = 8000;
+  const int num_rounds = 20;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(100, disk_manager);
+  Schema key_schema({Column("a", TypeId::BIGINT)});
+  HashFunction<KeyType> hash_fn;
+  LinearProbeHashTable<KeyType, ValueType, GenericComparator<8>> ht("blah", bpm, GenericComparator<8>(&key_schema),
+                                                                    num_blocks, hash_fn);
+
+  // only keys that hash to the first slot of a block, so that every block holds one chain of about 127 keys
+  std::vector<KeyType> keys;
+  KeyType key;
+  for (int64_t i = 0; keys.size() < 2 * num_keys; i++) {
+    key.SetFromInteger(i);
+    if (hash_fn.GetHash(key) % bucket_size == 0) {
+      keys.push_back(key);
+    }
+  }
+  for (int i = 0; i < num_keys; i++) {
+    ht.Insert(nullptr, keys[i], RID(i, 0));
+  }
+
+  // every round looks up all inserted keys once and as many absent keys, which walk their whole chain
+  int found = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int round = 0; round < num_rounds; round++) {
+    for (const auto &probe_key : keys) {
+      std::vector<RID> res;
+      found += ht.GetValue(nullptr, probe_key, &res) ? 1 : 0;
+    }
+  }
+  double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  EXPECT_EQ(num_keys * num_rounds, found);
+  const int num_lookups = 2 * num_keys * num_rounds;
+  LOG_INFO("%d lookups in %.1f ms, %.0f lookups/s", num_lookups, ms, num_lookups * 1000 / ms);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_BulkLoadBenchmark) {
+  using KeyType = GenericKey<8>;
+  using ValueType = RID;
+  // close to the most pairs a table of MAX_BLOCKS blocks takes below three quarters full
+  const int num_pairs = 150000;
+  Schema key_schema({Column("a", TypeId::BIGINT)});
+  std::vector<std::pair<KeyType, ValueType>> pairs(num_pairs);
+  for (int i = 0; i < num_pairs; i++) {
+    pairs[i].first.SetFromInteger(i);
+    pairs[i].second = RID(i, 0);
+  }
+
+  for (bool bulk : {false, true}) {
+    auto *disk_manager = new DiskManager("test.db");
+    auto *bpm = new BufferPoolManager(100, disk_manager);
+    LinearProbeHashTable<KeyType, ValueType, GenericComparator<8>> ht("blah", bpm, GenericComparator<8>(&key_schema),
+                                                                      1, HashFunction<KeyType>());
+    auto start = std::chrono::steady_clock::now();
+    if (bulk) {
+      EXPECT_EQ(num_pairs, ht.BulkLoad(nullptr, pairs));
+    } else {
+      for (const auto &pair : pairs) {
+        ht.Insert(nullptr, pair.first, pair.second);
+      }
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(num_pairs, ht.GetSize());
+    LOG_INFO("%s: %d pairs in %.1f ms, %.0f pairs/s", bulk ? "bulk load" : "inserts", num_pairs, ms,
+             num_pairs * 1000 / ms);
+
+    disk_manager->ShutDown();
+    remove("test.db");
+    delete disk_manager;
+    delete bpm;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_JoinHashTableBenchmark) {
+  // the hashing path of a hash join on an INTEGER and a BIGINT column: the keys are hashed value by value as
+  // HashJoinExecutor::HashValues does, then inserted into and probed in its hash table
+  const int num_rows = 100000;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(100, disk_manager);
+  LinearProbeHashTable<hash_t, TmpTuple, HashComparator> ht("blah", bpm, HashComparator(), 100, HashFunction<hash_t>());
+  auto hash_row = [](int row) {
+    Value a = ValueFactory::GetIntegerValue(row);
+    Value b = ValueFactory::GetBigIntValue(row % 97);
+    return HashUtil::CombineHashes(HashUtil::CombineHashes(0, HashUtil::HashValue(&a)), HashUtil::HashValue(&b));
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  for (int row = 0; row < num_rows; row++) {
+    ht.Insert(nullptr, hash_row(row), TmpTuple(row, 0));
+  }
+  int found = 0;
+  for (int row = 0; row < num_rows; row++) {
+    std::vector<TmpTuple> res;
+    ht.GetValue(nullptr, hash_row(row), &res);
+    found += res.size();
+  }
+  double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  EXPECT_EQ(num_rows, found);
+  LOG_INFO("%d rows built and probed in %.1f ms, %.0f rows/s", num_rows, ms, num_rows * 1000 / ms);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_HashFamilyBenchmark) {
+  const int num_hashes = 10000000;
+  uint64_t sink = 0;
+  auto run = [&](const char *name, auto hash) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_hashes; i++) {
+      sink += hash(i);
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO("%s: %.1f ns/hash", name, ms * 1000000 / num_hashes);
+  };
+  auto run_families = [&](const char *key_name, auto make_key) {
+    using Key = decltype(make_key(0));
+    LOG_INFO("%s", key_name);
+    run("  murmur", [&](int i) { return HashFunction<Key, MurmurHashFamily>().GetHash(make_key(i)); });
+    run("  wyhash", [&](int i) { return HashFunction<Key, WyHashFamily>().GetHash(make_key(i)); });
+#ifdef __SSE4_2__
+    run("  crc32", [&](int i) { return HashFunction<Key, Crc32HashFamily>().GetHash(make_key(i)); });
+#endif
+  };
+  run_families("int", [](int i) { return i; });
+  run_families("int64_t", [](int i) { return static_cast<int64_t>(i) * 7919; });
+  run_families("GenericKey<8>", [](int i) {
+    GenericKey<8> key;
+    key.SetFromInteger(i);
+    return key;
+  });
+  // the common case of a wide index key that holds one BIGINT, hashed over its first word only
+  auto make_wide_key = [](int i) {
+    GenericKey<64> key;
+    key.SetFromInteger(i);
+    return key;
+  };
+  run_families("GenericKey<64>", make_wide_key);
+  run("  murmur over all 64 bytes", [&](int i) { return MurmurHashFamily::Hash(make_wide_key(i).data_, 64); });
+  EXPECT_NE(0U, sink);
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_BatchLookupBenchmark) {
+  // the probe side of an index nested loop join: batches of outer keys looked up in a hash index
+  const int num_keys = 30000;
+  const int num_probes = 300000;
+  const int batch_size = 256;
+  auto *disk_manager = new DiskManager("test.db");
+  // the whole index fits into the buffer pool, so that the lookups measure the probes rather than the disk
+  auto *bpm = new BufferPoolManager(200, disk_manager);
+  Schema schema({Column("a", TypeId::BIGINT)});
+  LinearProbeHashTableIndex<GenericKey<8>, RID, GenericComparator<8>> index(
+      new IndexMetadata("foo_pk", "foo", &schema, {0}), bpm, 1, HashFunction<GenericKey<8>>());
+  std::vector<std::pair<Tuple, RID>> entries;
+  for (int key = 0; key < num_keys; key++) {
+    entries.emplace_back(Tuple({ValueFactory::GetBigIntValue(key)}, &schema), RID(key, 0));
+  }
+  index.BulkLoad(entries, nullptr);
+
+  std::mt19937 gen(3);
+  std::vector<Tuple> probes;
+  for (int i = 0; i < num_probes; i++) {
+    probes.push_back(entries[std::uniform_int_distribution<int>(0, num_keys - 1)(gen)].first);
+  }
+  for (bool batched : {false, true}) {
+    size_t found = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int first = 0; first < num_probes; first += batch_size) {
+      std::vector<Tuple> batch(probes.begin() + first, probes.begin() + std::min(first + batch_size, num_probes));
+      std::vector<std::vector<RID>> results;
+      if (batched) {
+        index.ScanKeys(batch, &results, nullptr);
+      } else {
+        index.Index::ScanKeys(batch, &results, nullptr);
+      }
+      for (const auto &result : results) {
+        found += result.size();
+      }
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(static_cast<size_t>(num_probes), found);
+    LOG_INFO("%s: %d lookups in %.1f ms, %.0f lookups/s", batched ? "ScanKeys" : "ScanKey per key", num_probes, ms,
+             num_probes * 1000 / ms);
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_ChurnBenchmark) {
+  // a table of steady size whose pairs are replaced over and over, which leaves tombstones unless removes clean up
+  using KeyType = GenericKey<8>;
+  const int num_keys = 20000;
+  const int num_rounds = 10;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(100, disk_manager);
+  Schema key_schema({Column("a", TypeId::BIGINT)});
+  LinearProbeHashTable<KeyType, RID, GenericComparator<8>> ht("blah", bpm, GenericComparator<8>(&key_schema), 1,
+                                                              HashFunction<KeyType>());
+  auto make_key = [](int64_t i) {
+    KeyType key;
+    key.SetFromInteger(i);
+    return key;
+  };
+
+  std::mt19937 gen(7);
+  std::vector<int64_t> present;
+  int64_t next_key = 0;
+  for (; next_key < num_keys; next_key++) {
+    ht.Insert(nullptr, make_key(next_key), RID(next_key, 0));
+    present.push_back(next_key);
+  }
+  double churn_ms = 0;
+  for (int round = 0; round <= num_rounds; round++) {
+    if (round > 0) {
+      std::shuffle(present.begin(), present.end(), gen);
+      auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < num_keys / 2; i++, next_key++) {
+        ht.Remove(nullptr, make_key(present[i]), RID(present[i], 0));
+        present[i] = next_key;
+        ht.Insert(nullptr, make_key(next_key), RID(next_key, 0));
+      }
+      churn_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    if (round % 2 == 0) {
+      double hit_length;
+      double miss_length;
+      ht.ProbeLengths(&hit_length, &miss_length);
+      // lookups of keys that were removed, which walk the probe to its end
+      auto start = std::chrono::steady_clock::now();
+      for (int64_t key = 0; key < num_keys; key++) {
+        std::vector<RID> res;
+        ht.GetValue(nullptr, make_key(key + (round == 0 ? num_keys : 0)), &res);
+      }
+      double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+      LOG_INFO("round %d: probe length hit %.2f, miss %.2f slots, %.0f misses/s", round, hit_length, miss_length,
+               num_keys * 1000 / ms);
+    }
+  }
+  LOG_INFO("%d removes and inserts in %.1f ms, %.0f operations/s", num_keys * num_rounds, churn_ms,
+           num_keys * num_rounds * 1000 / churn_ms);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_BloomFilterBenchmark) {
+  // a miss heavy workload: nine of ten lookups are for keys that are not in the table
+  using KeyType = GenericKey<8>;
+  const int num_keys = 50000;
+  const int num_lookups = 500000;
+  Schema key_schema({Column("a", TypeId::BIGINT)});
+  std::vector<std::pair<KeyType, RID>> pairs(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    pairs[i].first.SetFromInteger(i);
+    pairs[i].second = RID(i, 0);
+  }
+  std::mt19937 gen(13);
+  std::vector<KeyType> lookups(num_lookups);
+  for (auto &key : lookups) {
+    key.SetFromInteger(std::uniform_int_distribution<int64_t>(0, 10 * num_keys - 1)(gen));
+  }
+
+  for (size_t bits_per_key : {0, 8, 10, 16}) {
+    auto *disk_manager = new DiskManager("test.db");
+    auto *bpm = new BufferPoolManager(200, disk_manager);
+    LinearProbeHashTable<KeyType, RID, GenericComparator<8>> ht("blah", bpm, GenericComparator<8>(&key_schema), 1,
+                                                                HashFunction<KeyType>());
+    ht.EnableBloomFilter(bits_per_key);
+    ht.BulkLoad(nullptr, pairs);
+
+    int found = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &key : lookups) {
+      std::vector<RID> res;
+      found += ht.GetValue(nullptr, key, &res) ? 1 : 0;
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    // the false positive rate of a filter like that of the table, which a bulk load sizes for about its pairs
+    BloomFilter filter(num_keys, bits_per_key == 0 ? 1 : bits_per_key);
+    HashFunction<KeyType> hash_fn;
+    for (const auto &pair : pairs) {
+      filter.Add(hash_fn.GetHash(pair.first));
+    }
+    int false_positives = 0;
+    KeyType key;
+    for (int i = 0; i < num_lookups; i++) {
+      key.SetFromInteger(num_keys + i);
+      false_positives += filter.MayContain(hash_fn.GetHash(key)) ? 1 : 0;
+    }
+    LOG_INFO("%zu bits per key: %d of %d found in %.1f ms, %.0f lookups/s, false positives %.2f%%", bits_per_key,
+             found, num_lookups, ms, num_lookups * 1000 / ms,
+             bits_per_key == 0 ? 100.0 : 100.0 * false_positives / num_lookups);
+
+    disk_manager->ShutDown();
+    remove("test.db");
+    delete disk_manager;
+    delete bpm;
+  }
+}
+
 }  // namespace bustub
@@ -10,9 +10,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <chrono>  // NOLINT
 #include <cstdio>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -29,6 +32,8 @@
 #include "execution/expressions/column_value_expression.h"
 #include "execution/expressions/comparison_expression.h"
 #include "execution/expressions/constant_value_expression.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/nested_index_join_plan.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "gtest/gtest.h"
 #include "type/value_factory.h"
@@ -66,6 +71,9 @@ class ExecutorTest : public ::testing::Test {
   /** @return the executor context in our test class */
   ExecutorContext *GetExecutorContext() { return exec_ctx_.get(); }
 
+  /** @return the transaction manager in our test class */
+  TransactionManager *GetTxnManager() { return txn_mgr_.get(); }
+
   // The below helper functions are useful for testing.
 
   const AbstractExpression *MakeColumnValueExpression(const Schema &schema, uint32_t tuple_idx,
@@ -148,6 +156,110 @@ TEST_F(ExecutorTest, SimpleSeqScanTest) {
   ASSERT_EQ(num_tuples, 500);
 }
 
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, SimpleIndexScanTest) {
+  // CREATE INDEX test_1_colA ON test_1 (colA)
+  // SELECT colA, colB FROM test_1 WHERE colA >= 100 AND colA < 200
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  Schema &schema = table_info->schema_;
+  Schema key_schema{{schema.GetColumn(schema.GetColIdx("colA"))}};
+  IndexInfo *index_info = GetExecutorContext()->GetCatalog()->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetExecutorContext()->GetTransaction(), "test_1_colA", "test_1", schema, key_schema,
+      {schema.GetColIdx("colA")}, 8);
+
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *const200 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(200));
+  auto *predicate = MakeComparisonExpression(colA, const200, ComparisonType::LessThan);
+  auto *out_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+
+  // the high bound is exclusive, so the predicate drops its key
+  IndexScanPlanNode plan{out_schema, predicate, index_info->index_oid_, {ValueFactory::GetIntegerValue(100)},
+                         {ValueFactory::GetIntegerValue(200)}};
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+  executor->Init();
+  Tuple tuple;
+  int32_t expected = 100;
+  while (executor->Next(&tuple)) {
+    ASSERT_EQ(expected++, tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>());
+    ASSERT_TRUE(tuple.GetValue(out_schema, out_schema->GetColIdx("colB")).GetAs<int32_t>() < 10);
+  }
+  ASSERT_EQ(expected, 200);
+
+  // without bounds the scan returns the whole table in key order
+  IndexScanPlanNode full_plan{out_schema, nullptr, index_info->index_oid_, {}, {}};
+  executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &full_plan);
+  executor->Init();
+  expected = 0;
+  while (executor->Next(&tuple)) {
+    ASSERT_EQ(expected++, tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>());
+  }
+  ASSERT_EQ(expected, 1000);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, SimpleHashIndexScanTest) {
+  // CREATE INDEX test_1_colB ON test_1 USING HASH (colB)
+  // SELECT colA, colB FROM test_1 WHERE colB = 3
+  SimpleCatalog *catalog = GetExecutorContext()->GetCatalog();
+  TableMetadata *table_info = catalog->GetTable("test_1");
+  Schema &schema = table_info->schema_;
+  Schema key_schema{{schema.GetColumn(schema.GetColIdx("colB"))}};
+  IndexInfo *tree_info = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetExecutorContext()->GetTransaction(), "test_1_colA", "test_1", schema,
+      Schema{{schema.GetColumn(schema.GetColIdx("colA"))}}, {schema.GetColIdx("colA")}, 8);
+  IndexInfo *hash_info = catalog->CreateHashIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetExecutorContext()->GetTransaction(), "test_1_colB", "test_1", schema, key_schema,
+      {schema.GetColIdx("colB")}, 8, 4);
+
+  // the indexes are found by name and by table
+  ASSERT_EQ(hash_info, catalog->GetIndex("test_1_colB", "test_1"));
+  ASSERT_EQ(nullptr, catalog->GetIndex("test_1_colB", "test_2"));
+  ASSERT_EQ(nullptr, catalog->GetIndex("test_1_colC", "test_1"));
+  ASSERT_EQ((std::vector<IndexInfo *>{tree_info, hash_info}), catalog->GetTableIndexes("test_1"));
+  ASSERT_TRUE(catalog->GetTableIndexes("test_2").empty());
+
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *out_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+
+  // the seq scan tells which tuples the lookup has to find
+  auto *const3 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(3));
+  auto *predicate = MakeComparisonExpression(colB, const3, ComparisonType::Equal);
+  SeqScanPlanNode seq_plan{out_schema, predicate, table_info->oid_};
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &seq_plan);
+  executor->Init();
+  Tuple tuple;
+  std::vector<int32_t> expected;
+  while (executor->Next(&tuple)) {
+    expected.push_back(tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>());
+  }
+  ASSERT_FALSE(expected.empty());
+
+  // the tuples of the key come in rid order, which is the order the table was filled in
+  IndexScanPlanNode plan{out_schema, nullptr, hash_info->index_oid_, {ValueFactory::GetIntegerValue(3)}};
+  executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+  executor->Init();
+  std::vector<int32_t> found;
+  while (executor->Next(&tuple)) {
+    ASSERT_EQ(3, tuple.GetValue(out_schema, out_schema->GetColIdx("colB")).GetAs<int32_t>());
+    found.push_back(tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>());
+  }
+  ASSERT_EQ(expected, found);
+
+  // a point lookup works on a B+ tree index as well, a missing key finds nothing
+  IndexScanPlanNode tree_plan{out_schema, nullptr, tree_info->index_oid_, {ValueFactory::GetIntegerValue(42)}};
+  executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &tree_plan);
+  executor->Init();
+  ASSERT_TRUE(executor->Next(&tuple));
+  ASSERT_EQ(42, tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>());
+  ASSERT_FALSE(executor->Next(&tuple));
+  IndexScanPlanNode missing_plan{out_schema, nullptr, hash_info->index_oid_, {ValueFactory::GetIntegerValue(10)}};
+  executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &missing_plan);
+  executor->Init();
+  ASSERT_FALSE(executor->Next(&tuple));
+}
+
 // NOLINTNEXTLINE
 TEST_F(ExecutorTest, SimpleRawInsertTest) {
   // INSERT INTO empty_table2 VALUES (100, 10), (101, 11), (102, 12)
@@ -253,6 +365,99 @@ TEST_F(ExecutorTest, SimpleSelectInsertTest) {
   ASSERT_EQ(num_tuples, 500);
 }
 
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, SimpleInsertIndexTest) {
+  // CREATE INDEX empty_table2_colA ON empty_table2 USING HASH (colA)
+  // CREATE INDEX empty_table2_colB ON empty_table2 (colB)
+  // INSERT INTO empty_table2 VALUES (100, 10), (101, 11), (102, 10)
+  SimpleCatalog *catalog = GetExecutorContext()->GetCatalog();
+  TableMetadata *table_info = catalog->GetTable("empty_table2");
+  Schema &schema = table_info->schema_;
+  IndexInfo *hash_info = catalog->CreateHashIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetExecutorContext()->GetTransaction(), "empty_table2_colA", "empty_table2", schema,
+      Schema{{schema.GetColumn(schema.GetColIdx("colA"))}}, {schema.GetColIdx("colA")}, 8, 4);
+  IndexInfo *tree_info = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetExecutorContext()->GetTransaction(), "empty_table2_colB", "empty_table2", schema,
+      Schema{{schema.GetColumn(schema.GetColIdx("colB"))}}, {schema.GetColIdx("colB")}, 8);
+  std::vector<std::vector<Value>> raw_vals{
+      {ValueFactory::GetIntegerValue(100), ValueFactory::GetIntegerValue(10)},
+      {ValueFactory::GetIntegerValue(101), ValueFactory::GetIntegerValue(11)},
+      {ValueFactory::GetIntegerValue(102), ValueFactory::GetIntegerValue(10)}};
+  InsertPlanNode insert_plan{std::move(raw_vals), table_info->oid_};
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &insert_plan);
+  executor->Init();
+  ASSERT_TRUE(executor->Next(nullptr));
+
+  // the inserted tuples are found through both indexes
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *out_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+  IndexScanPlanNode hash_plan{out_schema, nullptr, hash_info->index_oid_, {ValueFactory::GetIntegerValue(101)}};
+  executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &hash_plan);
+  executor->Init();
+  Tuple tuple;
+  ASSERT_TRUE(executor->Next(&tuple));
+  ASSERT_EQ(101, tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>());
+  ASSERT_EQ(11, tuple.GetValue(out_schema, out_schema->GetColIdx("colB")).GetAs<int32_t>());
+  ASSERT_FALSE(executor->Next(&tuple));
+
+  IndexScanPlanNode tree_plan{out_schema, nullptr, tree_info->index_oid_, {ValueFactory::GetIntegerValue(10)}};
+  executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &tree_plan);
+  executor->Init();
+  std::vector<int32_t> found;
+  while (executor->Next(&tuple)) {
+    ASSERT_EQ(10, tuple.GetValue(out_schema, out_schema->GetColIdx("colB")).GetAs<int32_t>());
+    found.push_back(tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>());
+  }
+  ASSERT_EQ((std::vector<int32_t>{100, 102}), found);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, InsertAbortIndexTest) {
+  // CREATE INDEX empty_table2_colA ON empty_table2 USING HASH (colA)
+  // BEGIN; INSERT INTO empty_table2 VALUES (200, 20); ABORT
+  SimpleCatalog *catalog = GetExecutorContext()->GetCatalog();
+  TableMetadata *table_info = catalog->GetTable("empty_table2");
+  Schema &schema = table_info->schema_;
+  IndexInfo *hash_info = catalog->CreateHashIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetExecutorContext()->GetTransaction(), "empty_table2_colA", "empty_table2", schema,
+      Schema{{schema.GetColumn(schema.GetColIdx("colA"))}}, {schema.GetColIdx("colA")}, 8, 4);
+  Transaction *txn = GetTxnManager()->Begin();
+  ExecutorContext exec_ctx(txn, catalog, GetExecutorContext()->GetBufferPoolManager());
+  InsertPlanNode abort_plan{{{ValueFactory::GetIntegerValue(200), ValueFactory::GetIntegerValue(20)}},
+                            table_info->oid_};
+  auto executor = ExecutorFactory::CreateExecutor(&exec_ctx, &abort_plan);
+  executor->Init();
+  ASSERT_TRUE(executor->Next(nullptr));
+  ASSERT_EQ(1, txn->GetIndexWriteSet()->size());
+  GetTxnManager()->Abort(txn);
+  delete txn;
+
+  // the abort took the entry out of the index
+  Tuple key({ValueFactory::GetIntegerValue(200)}, &hash_info->key_schema_);
+  std::vector<RID> rids;
+  hash_info->index_->ScanKey(key, &rids, GetExecutorContext()->GetTransaction());
+  ASSERT_TRUE(rids.empty());
+
+  // an entry whose slot holds another tuple by now is skipped by the lookup
+  InsertPlanNode insert_plan{{{ValueFactory::GetIntegerValue(300), ValueFactory::GetIntegerValue(30)}},
+                             table_info->oid_};
+  executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &insert_plan);
+  executor->Init();
+  ASSERT_TRUE(executor->Next(nullptr));
+  hash_info->index_->ScanKey(Tuple({ValueFactory::GetIntegerValue(300)}, &hash_info->key_schema_), &rids,
+                             GetExecutorContext()->GetTransaction());
+  ASSERT_EQ(1, rids.size());
+  ASSERT_TRUE(hash_info->index_->InsertEntry(key, rids[0], GetExecutorContext()->GetTransaction()));
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *out_schema = MakeOutputSchema({{"colA", colA}});
+  IndexScanPlanNode scan_plan{out_schema, nullptr, hash_info->index_oid_, {ValueFactory::GetIntegerValue(200)}};
+  executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &scan_plan);
+  executor->Init();
+  Tuple tuple;
+  ASSERT_FALSE(executor->Next(&tuple));
+}
+
 // NOLINTNEXTLINE
 TEST_F(ExecutorTest, SimpleHashJoinTest) {
   // INSERT INTO empty_table2 SELECT colA, colB FROM test_1 WHERE colA < 500
@@ -310,6 +515,166 @@ TEST_F(ExecutorTest, SimpleHashJoinTest) {
   ASSERT_EQ(num_tuples, 100);
 }
 
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, SimpleNestedIndexJoinTest) {
+  // CREATE INDEX test_1_colA ON test_1 USING HASH (colA)
+  // CREATE INDEX test_1_colB ON test_1 USING HASH (colB)
+  SimpleCatalog *catalog = GetExecutorContext()->GetCatalog();
+  TableMetadata *inner_info = catalog->GetTable("test_1");
+  Schema &inner_schema = inner_info->schema_;
+  std::unordered_map<std::string, IndexInfo *> indexes;
+  for (const std::string col : {"colA", "colB"}) {
+    uint32_t col_idx = inner_schema.GetColIdx(col);
+    indexes[col] = catalog->CreateHashIndex<GenericKey<8>, RID, GenericComparator<8>>(
+        GetExecutorContext()->GetTransaction(), "test_1_" + col, "test_1", inner_schema,
+        Schema{{inner_schema.GetColumn(col_idx)}}, {col_idx}, 8, 4);
+  }
+
+  TableMetadata *outer_info = catalog->GetTable("test_2");
+  auto *col1 = MakeColumnValueExpression(outer_info->schema_, 0, "col1");
+  auto *col2 = MakeColumnValueExpression(outer_info->schema_, 0, "col2");
+  auto *outer_schema = MakeOutputSchema({{"col1", col1}, {"col2", col2}});
+  SeqScanPlanNode outer_plan{outer_schema, nullptr, outer_info->oid_};
+
+  // col1 and col2 have a tuple index of 0 because they are the outer side of the join, colA and colB are read from
+  // the inner table with a tuple index of 1
+  col1 = MakeColumnValueExpression(*outer_schema, 0, "col1");
+  col2 = MakeColumnValueExpression(*outer_schema, 0, "col2");
+  auto *colA = MakeColumnValueExpression(inner_schema, 1, "colA");
+  auto *colB = MakeColumnValueExpression(inner_schema, 1, "colB");
+  auto *out_final = MakeOutputSchema({{"col1", col1}, {"col2", col2}, {"colA", colA}, {"colB", colB}});
+  auto col_value = [out_final](const Tuple &tuple, const std::string &col) {
+    return tuple.GetValue(out_final, out_final->GetColIdx(col)).CastAs(TypeId::INTEGER).GetAs<int32_t>();
+  };
+
+  // an entry of the key of the first outer tuple that points at an inner tuple with another key yields no row
+  Transaction *txn = GetExecutorContext()->GetTransaction();
+  Value first_col1 = outer_info->table_->Begin(txn)->GetValue(&outer_info->schema_, 0).CastAs(TypeId::INTEGER);
+  auto other_iter = inner_info->table_->Begin(txn);
+  while (other_iter->GetValue(&inner_schema, 0).CompareEquals(first_col1) == CmpBool::CmpTrue) {
+    ++other_iter;
+  }
+  ASSERT_TRUE(indexes["colA"]->index_->InsertEntry(Tuple({first_col1}, &indexes["colA"]->key_schema_),
+                                                   other_iter->GetRid(), txn));
+
+  // SELECT col1, col2, colA, colB FROM test_2 JOIN test_1 ON col1 = colA, the SMALLINT col1 probes the INTEGER key
+  NestedIndexJoinPlanNode join_plan{out_final, {&outer_plan}, nullptr, indexes["colA"]->index_oid_, {col1}};
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &join_plan);
+  executor->Init();
+  Tuple tuple;
+  uint32_t num_tuples = 0;
+  while (executor->Next(&tuple)) {
+    ASSERT_EQ(col_value(tuple, "col1"), col_value(tuple, "colA"));
+    num_tuples++;
+  }
+  ASSERT_EQ(num_tuples, TEST2_SIZE);
+
+  // ... WHERE colB < 5, the predicate is evaluated on the joined tuples
+  auto *const5 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(5));
+  auto *predicate = MakeComparisonExpression(colB, const5, ComparisonType::LessThan);
+  NestedIndexJoinPlanNode filter_plan{out_final, {&outer_plan}, predicate, indexes["colA"]->index_oid_, {col1}};
+  executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &filter_plan);
+  executor->Init();
+  uint32_t num_filtered = 0;
+  while (executor->Next(&tuple)) {
+    ASSERT_LT(col_value(tuple, "colB"), 5);
+    num_filtered++;
+  }
+  ASSERT_GT(num_filtered, 0);
+  ASSERT_LT(num_filtered, num_tuples);
+
+  // SELECT ... FROM test_2 JOIN test_1 ON col2 = colB, every outer tuple has many matches and the outer side spans
+  // several batches
+  std::unordered_map<int32_t, uint32_t> colB_counts;
+  for (auto iter = inner_info->table_->Begin(GetExecutorContext()->GetTransaction());
+       iter != inner_info->table_->End(); ++iter) {
+    colB_counts[iter->GetValue(&inner_schema, inner_schema.GetColIdx("colB")).GetAs<int32_t>()]++;
+  }
+  uint32_t expected = 0;
+  for (auto iter = outer_info->table_->Begin(GetExecutorContext()->GetTransaction());
+       iter != outer_info->table_->End(); ++iter) {
+    Value value = iter->GetValue(&outer_info->schema_, outer_info->schema_.GetColIdx("col2"));
+    expected += value.IsNull() ? 0 : colB_counts[value.GetAs<int32_t>()];
+  }
+  NestedIndexJoinPlanNode dup_plan{out_final, {&outer_plan}, nullptr, indexes["colB"]->index_oid_, {col2}};
+  executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &dup_plan);
+  executor->Init();
+  num_tuples = 0;
+  while (executor->Next(&tuple)) {
+    ASSERT_EQ(col_value(tuple, "col2"), col_value(tuple, "colB"));
+    num_tuples++;
+  }
+  ASSERT_EQ(num_tuples, expected);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_IndexJoinBenchmark) {
+  // a small outer table joins a large inner table on its key: the index join probes it once per outer tuple, the
+  // hash join either scans all of it to probe or builds its hash table from it
+  const int32_t num_inner = 50000;
+  const int repeats = 3;
+  SimpleCatalog *catalog = GetExecutorContext()->GetCatalog();
+  Transaction *txn = GetExecutorContext()->GetTransaction();
+  Schema inner_schema({Column("colA", TypeId::INTEGER), Column("colB", TypeId::INTEGER)});
+  TableMetadata *inner_info = catalog->CreateTable(txn, "bench_inner", inner_schema);
+  for (int32_t i = 0; i < num_inner; i++) {
+    RID rid;
+    inner_info->table_->InsertTuple(
+        Tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(i % 10)}, &inner_schema), &rid, txn);
+  }
+  IndexInfo *index_info = catalog->CreateHashIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      txn, "bench_inner_colA", "bench_inner", inner_schema, Schema{{inner_schema.GetColumn(0)}}, {0}, 8, 4);
+
+  TableMetadata *outer_info = catalog->GetTable("test_2");
+  auto *col1 = MakeColumnValueExpression(outer_info->schema_, 0, "col1");
+  auto *outer_schema = MakeOutputSchema({{"col1", col1}});
+  SeqScanPlanNode outer_plan{outer_schema, nullptr, outer_info->oid_};
+  auto *colA = MakeColumnValueExpression(inner_schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(inner_schema, 0, "colB");
+  auto *scan_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+  SeqScanPlanNode inner_plan{scan_schema, nullptr, inner_info->oid_};
+
+  // the outer tuple is the left one with a tuple index of 0 in every plan
+  col1 = MakeColumnValueExpression(*outer_schema, 0, "col1");
+  auto *join_colA = MakeColumnValueExpression(*scan_schema, 1, "colA");
+  auto *join_colB = MakeColumnValueExpression(*scan_schema, 1, "colB");
+  auto *out_final = MakeOutputSchema({{"col1", col1}, {"colA", join_colA}, {"colB", join_colB}});
+  auto *predicate = MakeComparisonExpression(col1, join_colA, ComparisonType::Equal);
+  NestedIndexJoinPlanNode index_join{out_final, {&outer_plan}, nullptr, index_info->index_oid_, {col1}};
+  HashJoinPlanNode build_outer{out_final, {&outer_plan, &inner_plan}, predicate, {col1}, {join_colA}};
+
+  // built from the inner table, the roles of the tuples swap
+  auto *inner_col1 = MakeColumnValueExpression(*outer_schema, 1, "col1");
+  auto *inner_colA = MakeColumnValueExpression(*scan_schema, 0, "colA");
+  auto *inner_colB = MakeColumnValueExpression(*scan_schema, 0, "colB");
+  auto *build_out = MakeOutputSchema({{"col1", inner_col1}, {"colA", inner_colA}, {"colB", inner_colB}});
+  HashJoinPlanNode build_inner{build_out,
+                               {&inner_plan, &outer_plan},
+                               MakeComparisonExpression(inner_colA, inner_col1, ComparisonType::Equal),
+                               {inner_colA},
+                               {inner_col1}};
+
+  std::vector<std::pair<const char *, const AbstractPlanNode *>> plans{
+      {"index join", &index_join}, {"hash join, outer build", &build_outer}, {"hash join, inner build", &build_inner}};
+  for (auto [name, plan] : plans) {
+    double best_ms = 0;
+    for (int i = 0; i < repeats; i++) {
+      auto start = std::chrono::steady_clock::now();
+      auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), plan);
+      executor->Init();
+      Tuple tuple;
+      uint32_t num_tuples = 0;
+      while (executor->Next(&tuple)) {
+        num_tuples++;
+      }
+      double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+      ASSERT_EQ(num_tuples, TEST2_SIZE);
+      best_ms = i == 0 ? ms : std::min(best_ms, ms);
+    }
+    LOG_INFO("%s: %u x %d tuples in %.2f ms", name, TEST2_SIZE, num_inner, best_ms);
+  }
+}
+
 // NOLINTNEXTLINE
 TEST_F(ExecutorTest, SimpleAggregationTest) {
   // SELECT COUNT(colA), SUM(colA), min(colA), max(colA) from test_1;
@@ -10,22 +10,42 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <chrono>  // NOLINT
+#include <cinttypes>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <memory>
 #include <string>
+#include <thread>  // NOLINT
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "common/bustub_instance.h"
 #include "common/config.h"
 #include "concurrency/lock_manager.h"
 #include "concurrency/transaction_manager.h"
+#include "container/hash/linear_probe_hash_table.h"
 #include "gtest/gtest.h"
 #include "logging/common.h"
+#include "recovery/log_reader.h"
 #include "recovery/log_recovery.h"
+#include "recovery/tuple_delta.h"
+#include "storage/index/generic_key.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
+static void CopyFile(const std::string &from, const std::string &to) {
+  std::ifstream in(from, std::ios::binary);
+  std::ofstream out(to, std::ios::binary | std::ios::trunc);
+  out << in.rdbuf();
+}
+
 // NOLINTNEXTLINE
 TEST(RecoveryTest, RedoTest) {
   remove("test.db");
@@ -433,4 +453,934 @@ TEST(RecoveryTest, CheckpointTest) {
   remove("test.db");
   remove("test.log");
 }
+
+// NOLINTNEXTLINE
+TEST(RecoveryTest, FlushThreadTimeoutTest) {
+  remove("test.db");
+  remove("test.log");
+  BustubInstance *bustub_instance = new BustubInstance("test.db");
+
+  log_timeout = std::chrono::seconds(1);
+  bustub_instance->log_manager_->RunFlushThread();
+  ASSERT_TRUE(enable_logging);
+
+  LOG_INFO("Begin a txn without committing it");
+  Transaction *txn = bustub_instance->transaction_manager_->Begin();
+  lsn_t begin_lsn = bustub_instance->log_manager_->GetNextLSN() - 1;
+  EXPECT_LT(bustub_instance->log_manager_->GetPersistentLSN(), begin_lsn);
+
+  // the flush thread should sleep instead of spinning while it waits for the timeout
+  std::clock_t cpu_start = std::clock();
+  std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+  double cpu_seconds = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+  EXPECT_LT(cpu_seconds, 0.2);
+
+  LOG_INFO("The BEGIN record is flushed by the periodic flush");
+  EXPECT_EQ(begin_lsn, bustub_instance->log_manager_->GetPersistentLSN());
+
+  bustub_instance->transaction_manager_->Commit(txn);
+  EXPECT_EQ(bustub_instance->log_manager_->GetNextLSN() - 1, bustub_instance->log_manager_->GetPersistentLSN());
+
+  delete txn;
+  delete bustub_instance;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(RecoveryTest, ConcurrentAppendTest) {
+  remove("test.db");
+  remove("test.log");
+  BustubInstance *bustub_instance = new BustubInstance("test.db");
+  bustub_instance->log_manager_->RunFlushThread();
+
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+  const Tuple tuple = ConstructTuple(&schema);
+
+  // enough records to go around the ring of log buffers many times
+  const int num_threads = 8;
+  const int num_records = 4000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([&, i]() {
+      for (int j = 0; j < num_records; j++) {
+        LogRecord log_record(i, INVALID_LSN, LogRecordType::INSERT, RID(i, j), tuple);
+        bustub_instance->log_manager_->AppendLogRecord(&log_record);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  bustub_instance->log_manager_->SyncFlush(true);
+  EXPECT_EQ(num_threads * num_records - 1, bustub_instance->log_manager_->GetPersistentLSN());
+
+  LOG_INFO("Every record is on disk, in LSN order and per-thread in append order");
+  auto *log_buffer = new char[LOG_BUFFER_SIZE];
+  std::vector<int> next_slot(num_threads, 0);
+  lsn_t expected_lsn = 0;
+  int64_t offset = 0;
+  while (bustub_instance->disk_manager_->ReadLog(log_buffer, LOG_BUFFER_SIZE, offset)) {
+    int buffer_offset = 0;
+    while (buffer_offset + 20 <= LOG_BUFFER_SIZE) {
+      int32_t size = *reinterpret_cast<int32_t *>(log_buffer + buffer_offset);
+      if (size == 0 || buffer_offset + size > LOG_BUFFER_SIZE) {
+        break;
+      }
+      EXPECT_EQ(expected_lsn++, *reinterpret_cast<lsn_t *>(log_buffer + buffer_offset + 4));
+      RID rid = *reinterpret_cast<RID *>(log_buffer + buffer_offset + 20);
+      EXPECT_EQ(next_slot[rid.GetPageId()]++, rid.GetSlotNum());
+      buffer_offset += size;
+    }
+    offset += buffer_offset;
+  }
+  EXPECT_EQ(num_threads * num_records, expected_lsn);
+  delete[] log_buffer;
+
+  delete bustub_instance;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(RecoveryTest, LogReaderTest) {
+  remove("test.db");
+  remove("test.log");
+  BustubInstance *bustub_instance = new BustubInstance("test.db");
+  bustub_instance->log_manager_->RunFlushThread();
+
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+
+  // records of different sizes, so that they end anywhere in a chunk
+  const int num_records = 2000;
+  for (int i = 0; i < num_records; i++) {
+    Tuple tuple({Value(TypeId::VARCHAR, std::string(i % 17, 'a' + i % 26)), Value(TypeId::SMALLINT, int16_t(i))},
+                &schema);
+    LogRecord log_record(i % 5, INVALID_LSN, LogRecordType::INSERT, RID(i % 7, i), tuple);
+    bustub_instance->log_manager_->AppendLogRecord(&log_record);
+  }
+  bustub_instance->log_manager_->SyncFlush(true);
+
+  LOG_INFO("Records crossing the end of a chunk are read as a whole");
+  // a chunk size that is not a multiple of anything in the log
+  LogReader reader(bustub_instance->disk_manager_, 0, 1013);
+  std::vector<std::pair<LogRecord, std::shared_ptr<char[]>>> records;
+  LogRecord log_record;
+  int64_t offset = 0;
+  int64_t middle_offset = 0;
+  while (reader.Next(&log_record)) {
+    EXPECT_EQ(offset, reader.GetOffset());
+    if (log_record.GetLSN() == num_records / 2) {
+      middle_offset = offset;
+    }
+    offset += log_record.GetSize();
+    records.emplace_back(log_record, reader.GetChunk());
+  }
+  EXPECT_EQ(bustub_instance->disk_manager_->GetLogSize(), offset);
+  ASSERT_EQ(static_cast<size_t>(num_records), records.size());
+
+  LOG_INFO("Records that are held keep their chunk alive");
+  for (int i = 0; i < num_records; i++) {
+    auto &record = records[i].first;
+    EXPECT_EQ(i, record.GetLSN());
+    EXPECT_EQ(i % 5, record.GetTxnId());
+    EXPECT_EQ(RID(i % 7, i), record.GetInsertRID());
+    Tuple &tuple = record.GetInserteTuple();
+    EXPECT_EQ(std::string(i % 17, 'a' + i % 26), tuple.GetValue(&schema, 0).ToString());
+    EXPECT_EQ(i, tuple.GetValue(&schema, 1).GetAs<int16_t>());
+  }
+  records.clear();
+
+  LOG_INFO("Reading from a record boundary in the middle of the log");
+  LogReader middle_reader(bustub_instance->disk_manager_, middle_offset, 1013);
+  lsn_t expected_lsn = num_records / 2;
+  while (middle_reader.Next(&log_record)) {
+    EXPECT_EQ(expected_lsn++, log_record.GetLSN());
+  }
+  EXPECT_EQ(num_records, expected_lsn);
+
+  delete bustub_instance;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(RecoveryTest, TupleDeltaTest) {
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  Column col3{"c", TypeId::BIGINT};
+  Column col4{"d", TypeId::INTEGER};
+  std::vector<Column> cols{col1, col2, col3, col4};
+  Schema schema{cols};
+  Tuple old_tuple({Value(TypeId::VARCHAR, "abcdef"), Value(TypeId::SMALLINT, int16_t(1)),
+                   Value(TypeId::BIGINT, int64_t(2)), Value(TypeId::INTEGER, 3)},
+                  &schema);
+
+  // tuples after an update, the first two keep the tuple size, the others resize the varchar
+  std::vector<Tuple> new_tuples;
+  new_tuples.emplace_back(std::vector<Value>{Value(TypeId::VARCHAR, "abcdef"), Value(TypeId::SMALLINT, int16_t(7)),
+                                             Value(TypeId::BIGINT, int64_t(2)), Value(TypeId::INTEGER, 3)},
+                          &schema);
+  new_tuples.emplace_back(std::vector<Value>{Value(TypeId::VARCHAR, "abXdef"), Value(TypeId::SMALLINT, int16_t(1)),
+                                             Value(TypeId::BIGINT, int64_t(2)), Value(TypeId::INTEGER, 9)},
+                          &schema);
+  new_tuples.emplace_back(std::vector<Value>{Value(TypeId::VARCHAR, "abcdefghij"), Value(TypeId::SMALLINT, int16_t(1)),
+                                             Value(TypeId::BIGINT, int64_t(2)), Value(TypeId::INTEGER, 3)},
+                          &schema);
+  new_tuples.emplace_back(std::vector<Value>{Value(TypeId::VARCHAR, ""), Value(TypeId::SMALLINT, int16_t(1)),
+                                             Value(TypeId::BIGINT, int64_t(5)), Value(TypeId::INTEGER, 3)},
+                          &schema);
+  new_tuples.push_back(old_tuple);
+
+  for (auto &new_tuple : new_tuples) {
+    std::string delta = TupleDelta::Encode(old_tuple, new_tuple);
+    EXPECT_LT(delta.size(), old_tuple.GetLength() + new_tuple.GetLength());
+    Tuple redone;
+    Tuple undone;
+    ASSERT_TRUE(TupleDelta::Apply(delta, old_tuple, false, &redone));
+    ASSERT_TRUE(TupleDelta::Apply(delta, new_tuple, true, &undone));
+    ASSERT_EQ(new_tuple.GetLength(), redone.GetLength());
+    ASSERT_EQ(old_tuple.GetLength(), undone.GetLength());
+    EXPECT_EQ(0, memcmp(new_tuple.GetData(), redone.GetData(), new_tuple.GetLength()));
+    EXPECT_EQ(0, memcmp(old_tuple.GetData(), undone.GetData(), old_tuple.GetLength()));
+  }
+  // a one-column update only logs the changed bytes of the column
+  EXPECT_EQ(TupleDelta::RANGE_HEADER_SIZE + 2, TupleDelta::Encode(old_tuple, new_tuples[0]).size());
+  EXPECT_TRUE(TupleDelta::Encode(old_tuple, old_tuple).empty());
+}
+
+// NOLINTNEXTLINE
+TEST(RecoveryTest, UpdateDeltaTest) {
+  remove("test.db");
+  remove("test.log");
+  BustubInstance *bustub_instance = new BustubInstance("test.db");
+  bustub_instance->log_manager_->RunFlushThread();
+
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  Column col3{"c", TypeId::INTEGER};
+  std::vector<Column> cols{col1, col2, col3};
+  Schema schema{cols};
+  auto make_tuple = [&](const std::string &name, int i) {
+    return Tuple({Value(TypeId::VARCHAR, name), Value(TypeId::SMALLINT, int16_t(i)), Value(TypeId::INTEGER, i * 10)},
+                 &schema);
+  };
+
+  const int num_tuples = 200;
+  Transaction *txn = bustub_instance->transaction_manager_->Begin();
+  TableHeap test_table(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                       bustub_instance->log_manager_, txn);
+  std::vector<RID> rids(num_tuples);
+  for (int i = 0; i < num_tuples; i++) {
+    ASSERT_TRUE(test_table.InsertTuple(make_tuple("name" + std::to_string(i), i), &rids[i], txn));
+  }
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+
+  LOG_INFO("A committed transaction updates the numeric columns of every tuple");
+  bustub_instance->log_manager_->SyncFlush(true);
+  int64_t log_size = bustub_instance->disk_manager_->GetLogSize();
+  txn = bustub_instance->transaction_manager_->Begin();
+  for (int i = 0; i < num_tuples; i++) {
+    ASSERT_TRUE(test_table.UpdateTuple(make_tuple("name" + std::to_string(i), i + 1), rids[i], txn));
+  }
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+  bustub_instance->log_manager_->SyncFlush(true);
+  // the BEGIN and COMMIT records are left out
+  LogRecord txn_record(INVALID_TXN_ID, INVALID_LSN, LogRecordType::BEGIN);
+  int64_t update_bytes = bustub_instance->disk_manager_->GetLogSize() - log_size - 2 * txn_record.GetSize();
+  // logging the whole old and new tuple takes more than twice the tuple size per update
+  const Tuple tuple = make_tuple("name100", 100);
+  EXPECT_LT(update_bytes / num_tuples, 2 * static_cast<int>(tuple.GetLength()));
+
+  LOG_INFO("A loser transaction shortens the varchar column of every other tuple");
+  txn = bustub_instance->transaction_manager_->Begin();
+  for (int i = 0; i < num_tuples; i += 2) {
+    ASSERT_TRUE(test_table.UpdateTuple(make_tuple("n" + std::to_string(i), i + 1), rids[i], txn));
+  }
+  bustub_instance->log_manager_->SyncFlush(true);
+  delete txn;
+
+  LOG_INFO("System crash before the loser commits");
+  page_id_t first_page_id = test_table.GetFirstPageId();
+  delete bustub_instance;
+  bustub_instance = new BustubInstance("test.db");
+  LogRecovery log_recovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_);
+  log_recovery.Redo();
+  log_recovery.Undo();
+
+  LOG_INFO("The committed update is redone, the loser is undone");
+  TableHeap recovered_table(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                            bustub_instance->log_manager_, first_page_id);
+  txn = bustub_instance->transaction_manager_->Begin();
+  for (int i = 0; i < num_tuples; i++) {
+    Tuple result;
+    ASSERT_TRUE(recovered_table.GetTuple(rids[i], &result, txn));
+    EXPECT_EQ("name" + std::to_string(i), result.GetValue(&schema, 0).ToString());
+    EXPECT_EQ(i + 1, result.GetValue(&schema, 1).GetAs<int16_t>());
+    EXPECT_EQ((i + 1) * 10, result.GetValue(&schema, 2).GetAs<int32_t>());
+  }
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+
+  delete bustub_instance;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(RecoveryTest, ParallelRedoTest) {
+  remove("test.db");
+  remove("test.log");
+  BustubInstance *bustub_instance = new BustubInstance("test.db");
+  bustub_instance->log_manager_->RunFlushThread();
+
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+
+  LOG_INFO("Fill a table with more pages than the buffer pool holds");
+  Transaction *txn = bustub_instance->transaction_manager_->Begin();
+  auto *test_table = new TableHeap(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                                   bustub_instance->log_manager_, txn);
+  page_id_t first_page_id = test_table->GetFirstPageId();
+  const int num_tuples = 2000;
+  std::vector<Tuple> tuples;
+  std::vector<RID> rids(num_tuples);
+  for (int i = 0; i < num_tuples; i++) {
+    tuples.push_back(ConstructTuple(&schema));
+    ASSERT_TRUE(test_table->InsertTuple(tuples[i], &rids[i], txn));
+  }
+  ASSERT_GT(rids.back().GetPageId() - first_page_id, static_cast<int>(BUFFER_POOL_SIZE));
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+  delete test_table;
+
+  LOG_INFO("System crash after commit");
+  delete bustub_instance;
+  bustub_instance = new BustubInstance("test.db");
+
+  LOG_INFO("Redo with 4 workers");
+  auto *log_recovery = new LogRecovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_);
+  log_recovery->Redo(4);
+  log_recovery->Undo();
+  delete log_recovery;
+
+  txn = bustub_instance->transaction_manager_->Begin();
+  test_table = new TableHeap(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                             bustub_instance->log_manager_, first_page_id);
+  for (int i = 0; i < num_tuples; i++) {
+    Tuple tuple;
+    ASSERT_TRUE(test_table->GetTuple(rids[i], &tuple, txn));
+    EXPECT_EQ(tuple.GetValue(&schema, 0).CompareEquals(tuples[i].GetValue(&schema, 0)), CmpBool::CmpTrue);
+    EXPECT_EQ(tuple.GetValue(&schema, 1).CompareEquals(tuples[i].GetValue(&schema, 1)), CmpBool::CmpTrue);
+  }
+  LOG_INFO("The pages are linked again, the table iterator sees every tuple");
+  int count = 0;
+  for (auto iter = test_table->Begin(txn); iter != test_table->End(); ++iter) {
+    count++;
+  }
+  EXPECT_EQ(num_tuples, count);
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+  delete test_table;
+
+  delete bustub_instance;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(RecoveryTest, CompensationLogTest) {
+  remove("test.db");
+  remove("test.log");
+  BustubInstance *bustub_instance = new BustubInstance("test.db");
+  bustub_instance->log_manager_->RunFlushThread();
+
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+  auto make_tuple = [&](const std::string &name, int i) {
+    return Tuple({Value(TypeId::VARCHAR, name), Value(TypeId::SMALLINT, int16_t(i))}, &schema);
+  };
+
+  const int num_tuples = 1000;
+  Transaction *txn = bustub_instance->transaction_manager_->Begin();
+  TableHeap test_table(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                       bustub_instance->log_manager_, txn);
+  page_id_t first_page_id = test_table.GetFirstPageId();
+  std::vector<RID> rids(num_tuples);
+  for (int i = 0; i < num_tuples; i++) {
+    ASSERT_TRUE(test_table.InsertTuple(make_tuple("name" + std::to_string(i), i), &rids[i], txn));
+  }
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+
+  LOG_INFO("Four losers update and delete the tuples on their own pages");
+  const int num_losers = 4;
+  std::vector<RID> loser_rids;
+  int num_changes = 0;
+  for (int loser = 0; loser < num_losers; loser++) {
+    txn = bustub_instance->transaction_manager_->Begin();
+    for (int i = 0; i + 1 < num_tuples; i += 2) {
+      page_id_t page_id = rids[i].GetPageId();
+      if ((page_id - first_page_id) % num_losers != loser || rids[i + 1].GetPageId() != page_id) {
+        continue;
+      }
+      ASSERT_TRUE(test_table.UpdateTuple(make_tuple("name" + std::to_string(i), -i), rids[i], txn));
+      ASSERT_TRUE(test_table.MarkDelete(rids[i + 1], txn));
+      num_changes += 2;
+    }
+    delete txn;
+  }
+
+  LOG_INFO("A loser inserting tuples was halfway rolled back when the system crashed");
+  txn = bustub_instance->transaction_manager_->Begin();
+  const int num_inserts = 10;
+  for (int i = 0; i < num_inserts; i++) {
+    RID rid;
+    ASSERT_TRUE(test_table.InsertTuple(make_tuple("loser", i), &rid, txn));
+    loser_rids.push_back(rid);
+    num_changes++;
+  }
+  RID first_rid;
+  RID second_rid;
+  const Tuple second_tuple = make_tuple("second", 1);
+  ASSERT_TRUE(test_table.InsertTuple(make_tuple("first", 0), &first_rid, txn));
+  lsn_t undo_next_lsn = txn->GetPrevLSN();
+  ASSERT_TRUE(test_table.InsertTuple(second_tuple, &second_rid, txn));
+  LogRecord clr(LogRecord(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::APPLYDELETE, second_rid,
+                          second_tuple),
+                undo_next_lsn);
+  bustub_instance->log_manager_->AppendLogRecord(&clr);
+  loser_rids.push_back(first_rid);
+  loser_rids.push_back(second_rid);
+  num_changes++;
+  delete txn;
+  bustub_instance->log_manager_->SyncFlush(true);
+  lsn_t crash_lsn = bustub_instance->log_manager_->GetNextLSN() - 1;
+
+  auto check_table = [&]() {
+    TableHeap recovered_table(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                              bustub_instance->log_manager_, first_page_id);
+    Transaction *check_txn = bustub_instance->transaction_manager_->Begin();
+    for (int i = 0; i < num_tuples; i++) {
+      Tuple result;
+      ASSERT_TRUE(recovered_table.GetTuple(rids[i], &result, check_txn));
+      EXPECT_EQ("name" + std::to_string(i), result.GetValue(&schema, 0).ToString());
+      EXPECT_EQ(i, result.GetValue(&schema, 1).GetAs<int16_t>());
+    }
+    for (auto &rid : loser_rids) {
+      Tuple result;
+      EXPECT_FALSE(recovered_table.GetTuple(rid, &result, check_txn));
+    }
+    bustub_instance->transaction_manager_->Commit(check_txn);
+    delete check_txn;
+  };
+
+  LOG_INFO("System crash, the losers on different pages are undone in parallel");
+  delete bustub_instance;
+  bustub_instance = new BustubInstance("test.db");
+  int64_t log_size = bustub_instance->disk_manager_->GetLogSize();
+  {
+    LogRecovery log_recovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_,
+                             bustub_instance->log_manager_);
+    log_recovery.Redo();
+    log_recovery.Undo(num_losers);
+  }
+  check_table();
+
+  LOG_INFO("Undo logged a CLR for every change it reverted and an ABORT for every loser");
+  int clr_count = 0;
+  int abort_count = 0;
+  LogReader reader(bustub_instance->disk_manager_, log_size);
+  LogRecord log_record;
+  while (reader.Next(&log_record)) {
+    EXPECT_GT(log_record.GetLSN(), crash_lsn);
+    if (log_record.GetLogRecordType() == LogRecordType::CLR) {
+      clr_count++;
+    } else {
+      EXPECT_EQ(LogRecordType::ABORT, log_record.GetLogRecordType());
+      abort_count++;
+    }
+  }
+  EXPECT_EQ(num_changes, clr_count);
+  EXPECT_EQ(num_losers + 1, abort_count);
+
+  LOG_INFO("System crash after recovery, the CLRs are redone and nothing is undone again");
+  delete bustub_instance;
+  bustub_instance = new BustubInstance("test.db");
+  log_size = bustub_instance->disk_manager_->GetLogSize();
+  {
+    LogRecovery log_recovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_,
+                             bustub_instance->log_manager_);
+    log_recovery.Redo();
+    log_recovery.Undo(num_losers);
+  }
+  check_table();
+  EXPECT_EQ(log_size, bustub_instance->disk_manager_->GetLogSize());
+
+  delete bustub_instance;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(RecoveryTest, HashIndexRedoTest) {
+  remove("test.db");
+  remove("test.log");
+  BustubInstance *bustub_instance = new BustubInstance("test.db");
+  bustub_instance->log_manager_->RunFlushThread();
+
+  // the first log record gets LSN 0, which redo cannot tell from a page that was never written
+  Transaction *txn = bustub_instance->transaction_manager_->Begin();
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+
+  LOG_INFO("Insert into a hash table until it resized twice, remove every third key, then start another resize");
+  const int num_keys = 1200;
+  LinearProbeHashTable<int, int, IntComparator> ht("hash", bustub_instance->buffer_pool_manager_, IntComparator(), 1,
+                                                   HashFunction<int>(), bustub_instance->log_manager_);
+  // the anchor page stays the same while the resizes switch the header page
+  page_id_t anchor_page_id = ht.GetAnchorPageId();
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+    ASSERT_TRUE(ht.Insert(nullptr, i, 2 * i + 1));
+  }
+  for (int i = 0; i < num_keys; i += 3) {
+    ASSERT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  ht.Resize(16);
+  size_t size = ht.GetSize();
+  bustub_instance->log_manager_->SyncFlush(true);
+
+  LOG_INFO("System crash before the pages are flushed, redo rebuilds the pages from the log");
+  delete bustub_instance;
+  bustub_instance = new BustubInstance("test.db");
+  {
+    LogRecovery log_recovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_);
+    log_recovery.Redo();
+    log_recovery.Undo();
+  }
+
+  LinearProbeHashTable<int, int, IntComparator> recovered("hash", bustub_instance->buffer_pool_manager_,
+                                                          IntComparator(), HashFunction<int>(), anchor_page_id);
+  EXPECT_EQ(size, recovered.GetSize());
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ASSERT_TRUE(recovered.GetValue(nullptr, i, &res));
+    if (i % 3 == 0) {
+      EXPECT_EQ(std::vector<int>{2 * i + 1}, res);
+    } else {
+      EXPECT_EQ(2, res.size());
+    }
+  }
+
+  // the recovered table goes on with the resize, the inserts migrate the rest of the old table
+  for (int i = num_keys; i < 2 * num_keys; i++) {
+    ASSERT_TRUE(recovered.Insert(nullptr, i, i));
+  }
+  EXPECT_EQ(size + num_keys, recovered.GetSize());
+  for (int i = 0; i < 2 * num_keys; i++) {
+    std::vector<int> res;
+    ASSERT_TRUE(recovered.GetValue(nullptr, i, &res)) << i;
+  }
+
+  delete bustub_instance;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(RecoveryTest, HashIndexUndoTest) {
+  remove("test.db");
+  remove("test.log");
+  BustubInstance *bustub_instance = new BustubInstance("test.db");
+  bustub_instance->log_manager_->RunFlushThread();
+
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+  auto make_tuple = [&](int i) {
+    return Tuple({Value(TypeId::VARCHAR, "name" + std::to_string(i)), Value(TypeId::SMALLINT, int16_t(i))}, &schema);
+  };
+  auto make_key = [](int i) {
+    GenericKey<8> key;
+    key.SetFromInteger(i);
+    return key;
+  };
+
+  LOG_INFO("A winner and a loser insert tuples and their keys into a hash index");
+  Transaction *txn = bustub_instance->transaction_manager_->Begin();
+  TableHeap test_table(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                       bustub_instance->log_manager_, txn);
+  page_id_t first_page_id = test_table.GetFirstPageId();
+  LinearProbeHashTable<GenericKey<8>, RID, GenericComparator<8>> ht(
+      "index", bustub_instance->buffer_pool_manager_, GenericComparator<8>(nullptr), 4, HashFunction<GenericKey<8>>(),
+      bustub_instance->log_manager_);
+  page_id_t anchor_page_id = ht.GetAnchorPageId();
+  const int num_tuples = 20;
+  std::vector<RID> rids(num_tuples);
+  for (int i = 0; i < num_tuples / 2; i++) {
+    ASSERT_TRUE(test_table.InsertTuple(make_tuple(i), &rids[i], txn));
+    ASSERT_TRUE(ht.Insert(txn, make_key(i), rids[i]));
+  }
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+
+  txn = bustub_instance->transaction_manager_->Begin();
+  lsn_t undo_next_lsn = INVALID_LSN;
+  for (int i = num_tuples / 2; i < num_tuples; i++) {
+    undo_next_lsn = txn->GetPrevLSN();
+    ASSERT_TRUE(test_table.InsertTuple(make_tuple(i), &rids[i], txn));
+    ASSERT_TRUE(ht.Insert(txn, make_key(i), rids[i]));
+  }
+  // the undo of the last insert had been logged when the system crashed
+  LogRecord clr(LogRecord(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::APPLYDELETE,
+                          rids[num_tuples - 1], make_tuple(num_tuples - 1)),
+                undo_next_lsn);
+  bustub_instance->log_manager_->AppendLogRecord(&clr);
+  delete txn;
+  bustub_instance->log_manager_->SyncFlush(true);
+
+  LOG_INFO("System crash, redo brings back the entries of the loser and undo reports its inserts");
+  delete bustub_instance;
+  bustub_instance = new BustubInstance("test.db");
+  std::unordered_set<RID> rolled_back;
+  {
+    LogRecovery log_recovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_,
+                             bustub_instance->log_manager_);
+    log_recovery.Redo();
+    log_recovery.Undo();
+    rolled_back.insert(log_recovery.GetRolledBackInserts().begin(), log_recovery.GetRolledBackInserts().end());
+  }
+  EXPECT_EQ(std::unordered_set<RID>(rids.begin() + num_tuples / 2, rids.end()), rolled_back);
+
+  LinearProbeHashTable<GenericKey<8>, RID, GenericComparator<8>> recovered(
+      "index", bustub_instance->buffer_pool_manager_, GenericComparator<8>(nullptr), HashFunction<GenericKey<8>>(),
+      anchor_page_id, bustub_instance->log_manager_);
+  EXPECT_EQ(num_tuples, recovered.GetSize());
+  EXPECT_EQ(num_tuples / 2,
+            recovered.RemoveValues(nullptr, [&](const RID &rid) { return rolled_back.count(rid) != 0; }));
+  EXPECT_EQ(num_tuples / 2, recovered.GetSize());
+
+  TableHeap recovered_table(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                            bustub_instance->log_manager_, first_page_id);
+  txn = bustub_instance->transaction_manager_->Begin();
+  for (int i = 0; i < num_tuples; i++) {
+    std::vector<RID> result;
+    Tuple tuple;
+    if (i < num_tuples / 2) {
+      ASSERT_TRUE(recovered.GetValue(txn, make_key(i), &result));
+      EXPECT_EQ(std::vector<RID>{rids[i]}, result);
+      ASSERT_TRUE(recovered_table.GetTuple(rids[i], &tuple, txn));
+    } else {
+      EXPECT_FALSE(recovered.GetValue(txn, make_key(i), &result));
+      EXPECT_FALSE(recovered_table.GetTuple(rids[i], &tuple, txn));
+    }
+  }
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+
+  delete bustub_instance;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(RecoveryTest, CompressedLogTest) {
+  remove("test.db");
+  remove("test.log");
+  BustubInstance *bustub_instance = new BustubInstance("test.db", true);
+  bustub_instance->log_manager_->RunFlushThread();
+
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+
+  LOG_INFO("Insert tuples with log compression on");
+  Transaction *txn = bustub_instance->transaction_manager_->Begin();
+  TableHeap test_table(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                       bustub_instance->log_manager_, txn);
+  page_id_t first_page_id = test_table.GetFirstPageId();
+  const int num_tuples = 2000;
+  std::vector<Tuple> tuples;
+  std::vector<RID> rids(num_tuples);
+  for (int i = 0; i < num_tuples; i++) {
+    tuples.push_back(ConstructTuple(&schema));
+    ASSERT_TRUE(test_table.InsertTuple(tuples[i], &rids[i], txn));
+  }
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+  bustub_instance->log_manager_->SyncFlush(true);
+  EXPECT_LT(bustub_instance->disk_manager_->GetLogStoredSize(), bustub_instance->disk_manager_->GetLogSize());
+
+  LOG_INFO("System crash after commit, redo reads the compressed log");
+  delete bustub_instance;
+  bustub_instance = new BustubInstance("test.db");
+  LogRecovery log_recovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_);
+  log_recovery.Redo();
+  log_recovery.Undo();
+
+  txn = bustub_instance->transaction_manager_->Begin();
+  TableHeap recovered_table(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                            bustub_instance->log_manager_, first_page_id);
+  for (int i = 0; i < num_tuples; i++) {
+    Tuple tuple;
+    ASSERT_TRUE(recovered_table.GetTuple(rids[i], &tuple, txn));
+    EXPECT_EQ(tuple.GetValue(&schema, 0).CompareEquals(tuples[i].GetValue(&schema, 0)), CmpBool::CmpTrue);
+    EXPECT_EQ(tuple.GetValue(&schema, 1).CompareEquals(tuples[i].GetValue(&schema, 1)), CmpBool::CmpTrue);
+  }
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+
+  delete bustub_instance;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(RecoveryTest, FuzzyCheckpointTest) {
+  remove("test.db");
+  remove("test.log");
+  BustubInstance *bustub_instance = new BustubInstance("test.db");
+  bustub_instance->log_manager_->RunFlushThread();
+  EXPECT_EQ(-1, bustub_instance->disk_manager_->ReadMasterRecord());
+
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+  const Tuple tuple = ConstructTuple(&schema);
+  const int num_tuples = 200;
+
+  Transaction *txn = bustub_instance->transaction_manager_->Begin();
+  auto *test_table = new TableHeap(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                                   bustub_instance->log_manager_, txn);
+  page_id_t first_page_id = test_table->GetFirstPageId();
+  std::vector<RID> committed_rids(num_tuples);
+  for (auto &rid : committed_rids) {
+    ASSERT_TRUE(test_table->InsertTuple(tuple, &rid, txn));
+  }
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+
+  LOG_INFO("Checkpoint while a transaction is running");
+  Transaction *loser_txn = bustub_instance->transaction_manager_->Begin();
+  std::vector<RID> loser_rids(num_tuples);
+  for (auto &rid : loser_rids) {
+    ASSERT_TRUE(test_table->InsertTuple(tuple, &rid, loser_txn));
+  }
+  // a blocking checkpoint would wait here forever for the running transaction
+  bustub_instance->checkpoint_manager_->BeginCheckpoint();
+  bustub_instance->checkpoint_manager_->EndCheckpoint();
+  EXPECT_GT(bustub_instance->disk_manager_->ReadMasterRecord(), 0);
+
+  txn = bustub_instance->transaction_manager_->Begin();
+  std::vector<RID> later_rids(num_tuples);
+  for (auto &rid : later_rids) {
+    ASSERT_TRUE(test_table->InsertTuple(tuple, &rid, txn));
+  }
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+  delete test_table;
+
+  LOG_INFO("System crash with a running transaction");
+  delete loser_txn;
+  delete bustub_instance;
+  bustub_instance = new BustubInstance("test.db");
+
+  auto *log_recovery = new LogRecovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_);
+  log_recovery->Redo();
+  log_recovery->Undo();
+  delete log_recovery;
+
+  LOG_INFO("Committed changes around the checkpoint survive, the loser is undone back to before the checkpoint");
+  txn = bustub_instance->transaction_manager_->Begin();
+  test_table = new TableHeap(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                             bustub_instance->log_manager_, first_page_id);
+  Tuple old_tuple;
+  for (int i = 0; i < num_tuples; i++) {
+    EXPECT_TRUE(test_table->GetTuple(committed_rids[i], &old_tuple, txn));
+    EXPECT_FALSE(test_table->GetTuple(loser_rids[i], &old_tuple, txn));
+    EXPECT_TRUE(test_table->GetTuple(later_rids[i], &old_tuple, txn));
+  }
+  EXPECT_EQ(old_tuple.GetValue(&schema, 0).CompareEquals(tuple.GetValue(&schema, 0)), CmpBool::CmpTrue);
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+  delete test_table;
+
+  delete bustub_instance;
+  remove("test.db");
+  remove("test.log");
+}
+
+// Compares the redo time with different log read sizes and of the serial and the parallel redo over the same crashed
+// database. Scale num_tables and num_tuples up to get a log of the size of interest.
+// NOLINTNEXTLINE
+TEST(RecoveryTest, DISABLED_RedoBenchmark) {
+  remove("test.db");
+  remove("test.log");
+  BustubInstance *bustub_instance = new BustubInstance("test.db");
+  bustub_instance->log_manager_->RunFlushThread();
+
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+
+  const int num_tables = 16;
+  const int num_tuples = 10000;
+  for (int i = 0; i < num_tables; i++) {
+    Transaction *txn = bustub_instance->transaction_manager_->Begin();
+    TableHeap test_table(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                         bustub_instance->log_manager_, txn);
+    RID rid;
+    for (int j = 0; j < num_tuples; j++) {
+      ASSERT_TRUE(test_table.InsertTuple(ConstructTuple(&schema), &rid, txn));
+    }
+    bustub_instance->transaction_manager_->Commit(txn);
+    delete txn;
+  }
+  delete bustub_instance;
+  CopyFile("test.db", "test.db.bak");
+
+  // a log buffer per read is how the log was read before the reader streamed multi-MB chunks
+  for (int read_size : {LOG_BUFFER_SIZE, LOG_READ_SIZE}) {
+    CopyFile("test.db.bak", "test.db");
+    bustub_instance = new BustubInstance("test.db");
+    LogRecovery log_recovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_, nullptr, read_size);
+    auto start = std::chrono::steady_clock::now();
+    log_recovery.Redo();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    LOG_INFO("Redo of %" PRId64 " log bytes reading %d bytes at once: %" PRId64 " ms",
+             bustub_instance->disk_manager_->GetLogSize(), read_size, static_cast<int64_t>(elapsed.count()));
+    delete bustub_instance;
+  }
+
+  for (size_t num_workers : {1, 2, 4, 8}) {
+    CopyFile("test.db.bak", "test.db");
+    bustub_instance = new BustubInstance("test.db");
+    LogRecovery log_recovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_);
+    auto start = std::chrono::steady_clock::now();
+    log_recovery.Redo(num_workers);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    LOG_INFO("Redo with %zu workers: %" PRId64 " ms", num_workers, static_cast<int64_t>(elapsed.count()));
+    delete bustub_instance;
+  }
+
+  remove("test.db");
+  remove("test.db.bak");
+  remove("test.log");
+}
+
+// Compares the log bytes per update of logging the changed bytes with logging the whole old and new tuple, for an
+// update of one fixed-size column and of the varchar column.
+// NOLINTNEXTLINE
+TEST(RecoveryTest, DISABLED_UpdateLogBenchmark) {
+  remove("test.db");
+  remove("test.log");
+  BustubInstance *bustub_instance = new BustubInstance("test.db");
+  bustub_instance->log_manager_->RunFlushThread();
+
+  Column col1{"a", TypeId::VARCHAR, 40};
+  Column col2{"b", TypeId::INTEGER};
+  Column col3{"c", TypeId::BIGINT};
+  Column col4{"d", TypeId::DECIMAL};
+  Column col5{"e", TypeId::INTEGER};
+  std::vector<Column> cols{col1, col2, col3, col4, col5};
+  Schema schema{cols};
+  auto make_tuple = [&](const std::string &name, int i, int b) {
+    return Tuple({Value(TypeId::VARCHAR, name), Value(TypeId::INTEGER, b), Value(TypeId::BIGINT, int64_t(i)),
+                  Value(TypeId::DECIMAL, i * 0.5), Value(TypeId::INTEGER, 42)},
+                 &schema);
+  };
+
+  const int num_tuples = 10000;
+  Transaction *txn = bustub_instance->transaction_manager_->Begin();
+  TableHeap test_table(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                       bustub_instance->log_manager_, txn);
+  std::vector<RID> rids(num_tuples);
+  for (int i = 0; i < num_tuples; i++) {
+    ASSERT_TRUE(test_table.InsertTuple(make_tuple("customer name " + std::to_string(i), i, i), &rids[i], txn));
+  }
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+
+  const int record_overhead = LogRecord(INVALID_TXN_ID, INVALID_LSN, LogRecordType::BEGIN).GetSize() + sizeof(RID);
+  auto run_updates = [&](const char *name, const std::function<Tuple(int)> &new_tuple) {
+    bustub_instance->log_manager_->SyncFlush(true);
+    int64_t log_size = bustub_instance->disk_manager_->GetLogSize();
+    int64_t full_bytes = 0;
+    Transaction *update_txn = bustub_instance->transaction_manager_->Begin();
+    for (int i = 0; i < num_tuples; i++) {
+      Tuple old_tuple;
+      ASSERT_TRUE(test_table.GetTuple(rids[i], &old_tuple, update_txn));
+      Tuple tuple = new_tuple(i);
+      ASSERT_TRUE(test_table.UpdateTuple(tuple, rids[i], update_txn));
+      full_bytes += record_overhead + 2 * sizeof(int32_t) + old_tuple.GetLength() + tuple.GetLength();
+    }
+    bustub_instance->transaction_manager_->Commit(update_txn);
+    delete update_txn;
+    bustub_instance->log_manager_->SyncFlush(true);
+    auto delta_bytes = static_cast<int>(bustub_instance->disk_manager_->GetLogSize() - log_size);
+    LOG_INFO("%s: %d log bytes per update, %lld with whole tuples", name, delta_bytes / num_tuples,  // NOLINT
+             static_cast<long long>(full_bytes / num_tuples));                                    // NOLINT
+  };
+  run_updates("Update of one integer column",
+              [&](int i) { return make_tuple("customer name " + std::to_string(i), i, i + 1); });
+  run_updates("Update of the varchar column",
+              [&](int i) { return make_tuple("client name " + std::to_string(i), i, i + 1); });
+
+  delete bustub_instance;
+  remove("test.db");
+  remove("test.log");
+}
+
+// Compares the insert throughput and the size of the log with and without log compression.
+// NOLINTNEXTLINE
+TEST(RecoveryTest, DISABLED_CompressedLogBenchmark) {
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+
+  const int num_tuples = 20000;
+  for (bool compress_log : {false, true}) {
+    remove("test.db");
+    remove("test.log");
+    BustubInstance *bustub_instance = new BustubInstance("test.db", compress_log);
+    bustub_instance->log_manager_->RunFlushThread();
+    auto start = std::chrono::steady_clock::now();
+    Transaction *txn = bustub_instance->transaction_manager_->Begin();
+    TableHeap test_table(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                         bustub_instance->log_manager_, txn);
+    RID rid;
+    for (int i = 0; i < num_tuples; i++) {
+      ASSERT_TRUE(test_table.InsertTuple(ConstructTuple(&schema), &rid, txn));
+    }
+    bustub_instance->transaction_manager_->Commit(txn);
+    delete txn;
+    bustub_instance->log_manager_->SyncFlush(true);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    LOG_INFO("Compression %s: %d inserts in %lld ms, %" PRId64 " log bytes stored in %lld bytes",  // NOLINT
+             compress_log ? "on" : "off", num_tuples, static_cast<long long>(elapsed.count()),        // NOLINT
+             bustub_instance->disk_manager_->GetLogSize(),
+             static_cast<long long>(bustub_instance->disk_manager_->GetLogStoredSize()));  // NOLINT
+    delete bustub_instance;
+  }
+  remove("test.db");
+  remove("test.log");
+}
 }  // namespace bustub
@@ -0,0 +1,303 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_test.cpp
+//
+// Identification: test/storage/b_plus_tree_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <random>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/logger.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+class BPlusTreeTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // not the test.db of the other tests, which a parallel run truncates under the trees
+    disk_manager_ = new DiskManager("b_plus_tree_test.db");
+    bpm_ = new BufferPoolManager(50, disk_manager_);
+  }
+
+  void TearDown() override {
+    disk_manager_->ShutDown();
+    remove("b_plus_tree_test.db");
+    remove("b_plus_tree_test.log");
+    delete bpm_;
+    delete disk_manager_;
+  }
+
+  static GenericKey<8> MakeKey(int64_t value) {
+    GenericKey<8> key;
+    key.SetFromInteger(value);
+    return key;
+  }
+
+  Schema key_schema_{{Column("a", TypeId::BIGINT)}};
+  GenericComparator<8> comparator_{&key_schema_};
+  DiskManager *disk_manager_;
+  BufferPoolManager *bpm_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(BPlusTreeTest, InsertScanTest) {
+  // small pages, so that a few hundred keys need three levels
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm_, comparator_, 4, 4);
+  EXPECT_TRUE(tree.IsEmpty());
+  std::vector<int64_t> keys(500);
+  for (int i = 0; i < 500; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+  for (auto key : keys) {
+    EXPECT_TRUE(tree.Insert(MakeKey(key), RID(key, 0)));
+  }
+  EXPECT_FALSE(tree.Insert(MakeKey(42), RID(42, 0)));
+  EXPECT_EQ(500, tree.VerifyIntegrity());
+
+  for (int64_t key = 0; key < 500; key++) {
+    std::vector<RID> result;
+    ASSERT_TRUE(tree.GetValue(MakeKey(key), &result));
+    ASSERT_EQ(1, result.size());
+    EXPECT_EQ(key, result[0].GetPageId());
+  }
+  std::vector<RID> result;
+  EXPECT_FALSE(tree.GetValue(MakeKey(500), &result));
+
+  // the iterator walks the leaves in key order, from the first key not below the start key
+  int64_t expected = 100;
+  for (auto iter = tree.Begin(MakeKey(100)); iter != tree.End(); ++iter) {
+    EXPECT_EQ(expected++, (*iter).first.ToString());
+  }
+  EXPECT_EQ(500, expected);
+  expected = 0;
+  for (auto iter = tree.Begin(); !iter.IsEnd(); ++iter) {
+    EXPECT_EQ(expected++, (*iter).first.ToString());
+  }
+  EXPECT_EQ(500, expected);
+  EXPECT_TRUE(tree.Begin(MakeKey(1000)).IsEnd());
+}
+
+// NOLINTNEXTLINE
+TEST_F(BPlusTreeTest, DuplicateKeyTest) {
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm_, comparator_, 3, 3);
+  // every key has 20 values, more than fit into a leaf
+  for (int slot = 19; slot >= 0; slot--) {
+    for (int64_t key = 0; key < 10; key++) {
+      EXPECT_TRUE(tree.Insert(MakeKey(key), RID(key, slot)));
+    }
+  }
+  EXPECT_EQ(200, tree.VerifyIntegrity());
+  for (int64_t key = 0; key < 10; key++) {
+    std::vector<RID> result;
+    ASSERT_TRUE(tree.GetValue(MakeKey(key), &result));
+    ASSERT_EQ(20, result.size());
+    for (uint32_t slot = 0; slot < 20; slot++) {
+      EXPECT_EQ(RID(key, slot), result[slot]);
+    }
+  }
+
+  // removing one value of a key keeps the others
+  EXPECT_TRUE(tree.Remove(MakeKey(5), RID(5, 7)));
+  EXPECT_FALSE(tree.Remove(MakeKey(5), RID(5, 7)));
+  EXPECT_FALSE(tree.Remove(MakeKey(5), RID(6, 7)));
+  std::vector<RID> result;
+  tree.GetValue(MakeKey(5), &result);
+  EXPECT_EQ(19, result.size());
+  EXPECT_EQ(199, tree.VerifyIntegrity());
+}
+
+// NOLINTNEXTLINE
+TEST_F(BPlusTreeTest, DeleteTest) {
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm_, comparator_, 4, 5);
+  std::vector<int64_t> keys(1000);
+  for (int i = 0; i < 1000; i++) {
+    keys[i] = i;
+    tree.Insert(MakeKey(i), RID(i, 0));
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(11));
+
+  // remove the keys in random order, the tree stays balanced and at least half full all the way down
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_TRUE(tree.Remove(MakeKey(keys[i]), RID(keys[i], 0)));
+    if (i % 50 == 0) {
+      ASSERT_EQ(999 - i, tree.VerifyIntegrity());
+    }
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+  EXPECT_TRUE(tree.Begin().IsEnd());
+
+  // the tree can be filled again
+  EXPECT_TRUE(tree.Insert(MakeKey(1), RID(1, 0)));
+  EXPECT_EQ(1, tree.VerifyIntegrity());
+}
+
+// NOLINTNEXTLINE
+TEST_F(BPlusTreeTest, BulkLoadTest) {
+  // page sizes and entry counts where the last page of a level would be less than half full if filled up in order
+  for (int max_size : {3, 4, 5}) {
+    for (int num_keys : {1, 7, 26, 301}) {
+      BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm_, comparator_, max_size, max_size);
+      std::vector<std::pair<GenericKey<8>, RID>> entries;
+      for (int64_t key = 0; key < num_keys; key++) {
+        entries.emplace_back(MakeKey(key), RID(key, 0));
+        entries.emplace_back(MakeKey(key), RID(key, 0));
+      }
+      std::shuffle(entries.begin(), entries.end(), std::mt19937(max_size));
+      ASSERT_TRUE(tree.BulkLoad(&entries));
+      ASSERT_EQ(num_keys, entries.size());
+      ASSERT_EQ(num_keys, tree.VerifyIntegrity()) << max_size << " " << num_keys;
+
+      int64_t expected = 0;
+      for (auto iter = tree.Begin(); !iter.IsEnd(); ++iter) {
+        EXPECT_EQ(expected++, (*iter).first.ToString());
+      }
+      EXPECT_EQ(num_keys, expected);
+
+      // the tree takes single inserts and removes afterwards, and does not load into a tree that is not empty
+      EXPECT_FALSE(tree.BulkLoad(&entries));
+      EXPECT_TRUE(tree.Insert(MakeKey(num_keys), RID(num_keys, 0)));
+      EXPECT_TRUE(tree.Remove(MakeKey(0), RID(0, 0)));
+      ASSERT_EQ(num_keys, tree.VerifyIntegrity());
+      for (int64_t key = 1; key <= num_keys; key++) {
+        ASSERT_TRUE(tree.Remove(MakeKey(key), RID(key, 0)));
+      }
+      EXPECT_TRUE(tree.IsEmpty());
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(BPlusTreeTest, ConcurrentTest) {
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm_, comparator_, 4, 4);
+  const int num_threads = 4;
+  const int keys_per_thread = 1000;
+
+  // every thread inserts its own keys, removes every other one, and scans meanwhile
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&tree, tid] {
+      for (int64_t key = tid; key < num_threads * keys_per_thread; key += num_threads) {
+        tree.Insert(MakeKey(key), RID(key, 0));
+      }
+      for (int64_t key = tid; key < num_threads * keys_per_thread; key += 2 * num_threads) {
+        tree.Remove(MakeKey(key), RID(key, 0));
+        if (key % 100 == tid) {
+          int64_t last = -1;
+          for (auto iter = tree.Begin(MakeKey(key)); !iter.IsEnd(); ++iter) {
+            EXPECT_LT(last, (*iter).first.ToString());
+            last = (*iter).first.ToString();
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(num_threads * keys_per_thread / 2, tree.VerifyIntegrity());
+  for (int64_t key = 0; key < num_threads * keys_per_thread; key++) {
+    std::vector<RID> result;
+    EXPECT_EQ(key % (2 * num_threads) >= num_threads, tree.GetValue(MakeKey(key), &result));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(BPlusTreeTest, DISABLED_BulkLoadBenchmark) {
+  const int num_entries = 1000000;
+  std::vector<std::pair<GenericKey<8>, RID>> entries(num_entries);
+  for (int i = 0; i < num_entries; i++) {
+    entries[i] = {MakeKey(i), RID(i, 0)};
+  }
+  std::shuffle(entries.begin(), entries.end(), std::mt19937(3));
+
+  for (bool bulk : {false, true}) {
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm_, comparator_);
+    // the load sorts the entries in place, the next round gets them shuffled again
+    std::vector<std::pair<GenericKey<8>, RID>> input = entries;
+    auto start = std::chrono::steady_clock::now();
+    if (bulk) {
+      tree.BulkLoad(&input);
+    } else {
+      for (const auto &entry : input) {
+        tree.Insert(entry.first, entry.second);
+      }
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(num_entries, tree.VerifyIntegrity());
+    LOG_INFO("%s: %d entries in %.1f ms, %.0f entries/s", bulk ? "bulk load" : "inserts", num_entries, ms,
+             num_entries * 1000 / ms);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(BPlusTreeTest, DISABLED_IndexProbeBenchmark) {
+  const int num_keys = 20000;
+  const int num_probes = 500000;
+  Schema schema({Column("a", TypeId::BIGINT), Column("b", TypeId::INTEGER)});
+  // the whole index fits into the buffer pool, so that the probes measure the key comparisons rather than the disk
+  BufferPoolManager bpm(200, disk_manager_);
+  BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>> index(
+      new IndexMetadata("foo_pk", "foo", &schema, {0, 1}), &bpm);
+  auto make_tuple = [&schema](int64_t key) {
+    return Tuple({ValueFactory::GetBigIntValue(key / 4 - num_keys / 8),
+                  ValueFactory::GetIntegerValue(static_cast<int32_t>(key % 4))},
+                 &schema);
+  };
+  std::vector<std::pair<Tuple, RID>> entries;
+  for (int64_t key = 0; key < num_keys; key++) {
+    entries.emplace_back(make_tuple(key), RID(key, 0));
+  }
+  index.BulkLoad(entries, nullptr);
+
+  std::mt19937 gen(5);
+  std::vector<Tuple> probes;
+  for (int i = 0; i < num_probes; i++) {
+    probes.push_back(make_tuple(std::uniform_int_distribution<int64_t>(0, num_keys - 1)(gen)));
+  }
+  int found = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (const auto &probe : probes) {
+    std::vector<RID> result;
+    index.ScanKey(probe, &result, nullptr);
+    found += result.size();
+  }
+  double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  EXPECT_EQ(num_probes, found);
+  LOG_INFO("%d probes in %.1f ms, %.0f probes/s", num_probes, ms, num_probes * 1000 / ms);
+
+  // the key comparisons alone, without the buffer pool
+  std::vector<std::pair<GenericKey<16>, RID>> index_entries;
+  for (auto iter = index.GetBeginIterator(); !iter.IsEnd(); ++iter) {
+    index_entries.push_back(*iter);
+  }
+  std::vector<GenericKey<16>> keys;
+  for (int i = 0; i < num_probes; i++) {
+    keys.push_back(index_entries[std::uniform_int_distribution<size_t>(0, index_entries.size() - 1)(gen)].first);
+  }
+  GenericComparator<16> comparator(index.GetKeySchema());
+  start = std::chrono::steady_clock::now();
+  std::sort(keys.begin(), keys.end(),
+            [&comparator](const GenericKey<16> &lhs, const GenericKey<16> &rhs) { return comparator(lhs, rhs) < 0; });
+  ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  LOG_INFO("sorted %d keys in %.1f ms", num_probes, ms);
+}
+
+}  // namespace bustub
@@ -11,6 +11,10 @@
 //===----------------------------------------------------------------------===//
 
 #include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
 
 #include "common/exception.h"
 #include "gtest/gtest.h"
@@ -58,6 +62,138 @@ TEST(DiskManagerTest, ReadWriteLogTest) {
   remove(db_file.c_str());
 }
 
+TEST(DiskManagerTest, MasterRecordTest) {
+  char buf[16] = {0};
+  char data[16] = {0};
+  std::string db_file("test.db");
+  remove("test.log");
+  auto *dm = new DiskManager(db_file);
+  std::strncpy(data, "A test string.", sizeof(data));
+  EXPECT_EQ(-1, dm->ReadMasterRecord());
+
+  dm->WriteLog(data, sizeof(data));
+  dm->WriteMasterRecord(sizeof(data));
+  EXPECT_EQ(static_cast<int>(sizeof(data)), dm->ReadMasterRecord());
+  // the master record does not take the place of any log record
+  EXPECT_EQ(static_cast<int>(sizeof(data)), dm->GetLogSize());
+  dm->ReadLog(buf, sizeof(buf), 0);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+  dm->ShutDown();
+  delete dm;
+
+  dm = new DiskManager(db_file);
+  EXPECT_EQ(static_cast<int>(sizeof(data)), dm->ReadMasterRecord());
+  // log offsets are 64 bit, the log grows past 2 GB
+  const int64_t large_offset = (int64_t{1} << 33) + 5;
+  dm->WriteMasterRecord(large_offset);
+  dm->ShutDown();
+  delete dm;
+
+  dm = new DiskManager(db_file);
+  EXPECT_EQ(large_offset, dm->ReadMasterRecord());
+  EXPECT_EQ(static_cast<int>(sizeof(data)), dm->GetLogSize());
+  dm->ShutDown();
+  delete dm;
+  remove(db_file.c_str());
+  remove("test.log");
+  remove("test.log.0");
+}
+
+TEST(DiskManagerTest, SegmentedLogTest) {
+  const int segment_size = 64;
+  const int write_size = 40;
+  const int num_writes = 10;
+  char data[2][write_size];
+  char buf[num_writes * write_size];
+  std::string db_file("test.db");
+  remove("test.log");
+  auto *dm = new DiskManager(db_file, segment_size);
+
+  // the log manager never hands the same buffer twice in a row, every write is a block that fills a segment
+  for (int i = 0; i < num_writes; i++) {
+    memset(data[i % 2], 'a' + i, write_size);
+    dm->WriteLog(data[i % 2], write_size);
+  }
+  EXPECT_EQ(num_writes * write_size, dm->GetLogSize());
+  EXPECT_TRUE(dm->ReadLog(buf, sizeof(buf), 0));
+  for (int i = 0; i < num_writes * write_size; i++) {
+    EXPECT_EQ('a' + i / write_size, buf[i]);
+  }
+  std::ifstream segment("test.log.6");
+  EXPECT_TRUE(segment.is_open());
+  segment.close();
+
+  // segments 0 to 2 only hold log before offset 150
+  dm->TruncateLog(150);
+  EXPECT_EQ(3 * write_size, dm->GetLogStartOffset());
+  EXPECT_FALSE(dm->ReadLog(buf, write_size, 0));
+  segment.open("test.log.2");
+  EXPECT_FALSE(segment.is_open());
+  dm->ShutDown();
+  delete dm;
+
+  // the log continues where it ended after a restart
+  dm = new DiskManager(db_file, segment_size);
+  EXPECT_EQ(3 * write_size, dm->GetLogStartOffset());
+  EXPECT_EQ(num_writes * write_size, dm->GetLogSize());
+  memset(data[0], 'z', write_size);
+  dm->WriteLog(data[0], write_size);
+  EXPECT_TRUE(dm->ReadLog(buf, 2 * write_size, (num_writes - 1) * write_size));
+  EXPECT_EQ('a' + num_writes - 1, buf[0]);
+  EXPECT_EQ('z', buf[2 * write_size - 1]);
+  dm->ShutDown();
+  delete dm;
+
+  remove(db_file.c_str());
+  remove("test.log");
+  for (int i = 0; i <= num_writes; i++) {
+    remove(("test.log." + std::to_string(i)).c_str());
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, CompressedLogTest) {
+  const int write_size = 4096;
+  const int num_writes = 8;
+  char data[2][write_size];
+  char buf[num_writes * write_size];
+  std::string db_file("test.db");
+  remove("test.log");
+  auto *dm = new DiskManager(db_file);
+
+  // repetitive blocks shrink, random ones are stored as they are
+  std::mt19937 rng(42);
+  std::vector<char> expected;
+  for (int i = 0; i < num_writes; i++) {
+    for (int j = 0; j < write_size; j++) {
+      data[i % 2][j] = i % 2 == 0 ? static_cast<char>('a' + j % 7 + i) : static_cast<char>(rng());
+    }
+    expected.insert(expected.end(), data[i % 2], data[i % 2] + write_size);
+    dm->WriteLog(data[i % 2], write_size, true);
+  }
+  EXPECT_EQ(num_writes * write_size, dm->GetLogSize());
+  EXPECT_LT(dm->GetLogStoredSize(), num_writes * write_size * 3 / 4);
+
+  // reads may start and end anywhere in a block
+  EXPECT_TRUE(dm->ReadLog(buf, sizeof(buf), 0));
+  EXPECT_EQ(0, memcmp(expected.data(), buf, sizeof(buf)));
+  EXPECT_TRUE(dm->ReadLog(buf, 100, write_size - 50));
+  EXPECT_EQ(0, memcmp(expected.data() + write_size - 50, buf, 100));
+  dm->ShutDown();
+  delete dm;
+
+  dm = new DiskManager(db_file);
+  EXPECT_EQ(num_writes * write_size, dm->GetLogSize());
+  EXPECT_TRUE(dm->ReadLog(buf, 3 * write_size, 2 * write_size + 1));
+  EXPECT_EQ(0, memcmp(expected.data() + 2 * write_size + 1, buf, 3 * write_size));
+  dm->ShutDown();
+  delete dm;
+
+  remove(db_file.c_str());
+  remove("test.log");
+  remove("test.log.0");
+}
+
 TEST(DiskManagerTest, ThrowBadFileTest) { EXPECT_THROW(DiskManager("dev/null\\/foo/bar/baz/test.db"), Exception); }
 
 }  // namespace bustub
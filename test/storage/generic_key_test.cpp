@@ -0,0 +1,100 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// generic_key_test.cpp
+//
+// Identification: test/storage/generic_key_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** @return -1, 0 or 1 as the values of lhs are smaller, equal or larger than those of rhs, column by column */
+int CompareValues(const std::vector<Value> &lhs, const std::vector<Value> &rhs) {
+  for (size_t i = 0; i < lhs.size(); i++) {
+    if (lhs[i].CompareLessThan(rhs[i]) == CmpBool::CmpTrue) {
+      return -1;
+    }
+    if (lhs[i].CompareGreaterThan(rhs[i]) == CmpBool::CmpTrue) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int Sign(int value) { return (value > 0) - (value < 0); }
+
+// NOLINTNEXTLINE
+TEST(GenericKeyTest, OrderTest) {
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 16), Column("c", TypeId::DECIMAL),
+                 Column("d", TypeId::SMALLINT)});
+  GenericComparator<64> comparator(&schema);
+
+  // few distinct values per column, so that the later columns decide often, and strings that are prefixes of others
+  std::mt19937 gen(17);
+  std::vector<std::string> strings{"", "a", "ab", "abc", "b", std::string("a\0b", 3), std::string("a\0", 2), "\xff"};
+  auto random_values = [&]() {
+    return std::vector<Value>{
+        ValueFactory::GetIntegerValue(std::uniform_int_distribution<int32_t>(-2, 2)(gen) * 1000003),
+        ValueFactory::GetVarcharValue(strings[std::uniform_int_distribution<size_t>(0, strings.size() - 1)(gen)]),
+        ValueFactory::GetDecimalValue(std::uniform_int_distribution<int>(-3, 3)(gen) * 0.75),
+        ValueFactory::GetSmallIntValue(static_cast<int16_t>(std::uniform_int_distribution<int>(-300, 300)(gen)))};
+  };
+
+  for (int i = 0; i < 5000; i++) {
+    std::vector<Value> lhs = random_values();
+    std::vector<Value> rhs = random_values();
+    GenericKey<64> lhs_key;
+    GenericKey<64> rhs_key;
+    lhs_key.SetFromKey(Tuple(lhs, &schema), &schema);
+    rhs_key.SetFromKey(Tuple(rhs, &schema), &schema);
+    ASSERT_EQ(CompareValues(lhs, rhs), Sign(comparator(lhs_key, rhs_key)));
+
+    // the values decode from the key again
+    for (uint32_t col = 0; col < lhs.size(); col++) {
+      ASSERT_EQ(CmpBool::CmpTrue, lhs[col].CompareEquals(lhs_key.ToValue(&schema, col)));
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(GenericKeyTest, NullAndCutOffTest) {
+  Schema schema({Column("a", TypeId::BIGINT), Column("b", TypeId::INTEGER)});
+  GenericComparator<8> comparator(&schema);
+  GenericKey<8> null_key;
+  GenericKey<8> min_key;
+  GenericKey<8> key;
+  null_key.SetFromKey(
+      Tuple({ValueFactory::GetNullValueByType(TypeId::BIGINT), ValueFactory::GetIntegerValue(1)}, &schema), &schema);
+  min_key.SetFromKey(
+      Tuple({ValueFactory::GetBigIntValue(BUSTUB_INT64_MIN), ValueFactory::GetIntegerValue(1)}, &schema), &schema);
+  EXPECT_LT(comparator(null_key, min_key), 0);
+  EXPECT_TRUE(null_key.ToValue(&schema, 0).IsNull());
+
+  // the second column does not fit, which is reported, as the keys that differ only there compare equal
+  EXPECT_FALSE(
+      key.SetFromKey(Tuple({ValueFactory::GetBigIntValue(-7), ValueFactory::GetIntegerValue(1)}, &schema), &schema));
+  EXPECT_FALSE(min_key.SetFromKey(
+      Tuple({ValueFactory::GetBigIntValue(-7), ValueFactory::GetIntegerValue(2)}, &schema), &schema));
+  EXPECT_EQ(0, comparator(key, min_key));
+  Schema short_schema({Column("a", TypeId::BIGINT)});
+  EXPECT_TRUE(min_key.SetFromKey(Tuple({ValueFactory::GetBigIntValue(-7)}, &short_schema), &short_schema));
+
+  // a test key is encoded like a BIGINT column
+  min_key.SetFromInteger(-7);
+  EXPECT_EQ(0, comparator(key, min_key));
+  EXPECT_EQ(-7, min_key.ToString());
+}
+
+}  // namespace bustub
@@ -0,0 +1,173 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_test.cpp
+//
+// Identification: test/table/free_space_map_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/logger.h"
+#include "gtest/gtest.h"
+#include "storage/table/free_space_map.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+class FreeSpaceMapTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    disk_manager_ = std::make_unique<DiskManager>("free_space_map_test.db");
+    bpm_ = std::make_unique<BufferPoolManager>(50, disk_manager_.get());
+  }
+
+  void TearDown() override {
+    disk_manager_->ShutDown();
+    remove("free_space_map_test.db");
+    remove("free_space_map_test.log");
+  }
+
+  /** @return a tuple of about length bytes */
+  Tuple MakeTuple(int32_t key, size_t length) {
+    return Tuple({ValueFactory::GetIntegerValue(key), ValueFactory::GetVarcharValue(std::string(length, 'x'))},
+                 &schema_);
+  }
+
+  /** @return the number of pages of the table */
+  size_t CountPages(TableHeap *table) {
+    size_t num_pages = 0;
+    for (page_id_t page_id = table->GetFirstPageId(); page_id != INVALID_PAGE_ID; num_pages++) {
+      auto page = reinterpret_cast<TablePage *>(bpm_->FetchPage(page_id));
+      page_id_t next_page_id = page->GetNextPageId();
+      bpm_->UnpinPage(page_id, false);
+      page_id = next_page_id;
+    }
+    return num_pages;
+  }
+
+  std::unique_ptr<DiskManager> disk_manager_;
+  std::unique_ptr<BufferPoolManager> bpm_;
+  LockManager lock_manager_{TwoPLMode::REGULAR};
+  Schema schema_{{Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, PAGE_SIZE)}};
+};
+
+// NOLINTNEXTLINE
+TEST_F(FreeSpaceMapTest, FindPageTest) {
+  const uint32_t unit = FreeSpaceMap::CATEGORY_SIZE;
+  FreeSpaceMap map(bpm_.get());
+  map.AddPage(10, 100 * unit);
+  map.AddPage(11, 5 * unit + unit / 2);
+  map.AddPage(12, 20 * unit);
+  EXPECT_EQ(3, map.GetNumPages());
+  EXPECT_EQ(12, map.GetLastPageId());
+
+  // the page with the least room that is enough, free space is rounded down and the space needed up
+  EXPECT_EQ(11, map.FindPage(5 * unit));
+  EXPECT_EQ(12, map.FindPage(5 * unit + 1));
+  EXPECT_EQ(10, map.FindPage(21 * unit));
+  EXPECT_EQ(INVALID_PAGE_ID, map.FindPage(100 * unit + 1));
+
+  map.Update(10, 0);
+  map.Update(13, 200 * unit);
+  EXPECT_EQ(INVALID_PAGE_ID, map.FindPage(21 * unit));
+  EXPECT_EQ(3, map.GetNumPages());
+
+  // persisted across several map pages, the map reads back the same
+  for (page_id_t page_id = 13; page_id < 2000; page_id++) {
+    map.AddPage(page_id, static_cast<uint32_t>(page_id % 7) * unit);
+  }
+  page_id_t first_page_id = map.Persist();
+  map.AddPage(2000, 50 * unit);
+  map.Update(11, 30 * unit);
+  FreeSpaceMap loaded(bpm_.get(), first_page_id);
+  EXPECT_EQ(first_page_id, loaded.GetFirstPageId());
+  EXPECT_EQ(map.GetNumPages(), loaded.GetNumPages());
+  EXPECT_EQ(2000, loaded.GetLastPageId());
+  EXPECT_EQ(11, loaded.FindPage(30 * unit));
+  EXPECT_EQ(2000, loaded.FindPage(31 * unit));
+}
+
+// NOLINTNEXTLINE
+TEST_F(FreeSpaceMapTest, TableHeapTest) {
+  Transaction txn(0);
+  auto table = std::make_unique<TableHeap>(bpm_.get(), &lock_manager_, nullptr, &txn);
+
+  // four tuples fill a page but for a few hundred bytes, so the tuples go into the pages in turn
+  std::vector<RID> rids;
+  for (int32_t i = 0; i < 200; i++) {
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(MakeTuple(i, 900), &rid, &txn));
+    rids.push_back(rid);
+  }
+  ASSERT_EQ(50, CountPages(table.get()));
+
+  // a small tuple fits into the room the large ones left in a page, and the space of deleted tuples is reused
+  RID rid;
+  ASSERT_TRUE(table->InsertTuple(MakeTuple(-1, 10), &rid, &txn));
+  ASSERT_TRUE(table->MarkDelete(rids[41], &txn));
+  table->ApplyDelete(rids[41], &txn);
+  ASSERT_TRUE(table->InsertTuple(MakeTuple(-2, 900), &rid, &txn));
+  ASSERT_EQ(rids[41].GetPageId(), rid.GetPageId());
+  ASSERT_EQ(50, CountPages(table.get()));
+
+  // a table opened with its map goes on from where it was
+  page_id_t first_page_id = table->GetFirstPageId();
+  page_id_t map_page_id = table->GetFreeSpaceMapPageId();
+  ASSERT_NE(INVALID_PAGE_ID, map_page_id);
+  table = std::make_unique<TableHeap>(bpm_.get(), &lock_manager_, nullptr, first_page_id, map_page_id);
+  ASSERT_EQ(map_page_id, table->GetFreeSpaceMapPageId());
+  ASSERT_TRUE(table->MarkDelete(rids[7], &txn));
+  table->ApplyDelete(rids[7], &txn);
+  ASSERT_TRUE(table->InsertTuple(MakeTuple(-3, 900), &rid, &txn));
+  ASSERT_EQ(rids[7].GetPageId(), rid.GetPageId());
+  ASSERT_TRUE(table->InsertTuple(MakeTuple(-4, 900), &rid, &txn));
+  ASSERT_EQ(51, CountPages(table.get()));
+
+  // a table opened without its map rebuilds it from the pages, and keeps it in memory
+  table = std::make_unique<TableHeap>(bpm_.get(), &lock_manager_, nullptr, first_page_id);
+  ASSERT_TRUE(table->InsertTuple(MakeTuple(-5, 900), &rid, &txn));
+  ASSERT_EQ(51, CountPages(table.get()));
+  ASSERT_EQ(INVALID_PAGE_ID, table->GetFreeSpaceMapPageId());
+  int num_tuples = 0;
+  for (auto iter = table->Begin(&txn); iter != table->End(); ++iter) {
+    num_tuples++;
+  }
+  ASSERT_EQ(203, num_tuples);
+}
+
+// NOLINTNEXTLINE
+TEST_F(FreeSpaceMapTest, DISABLED_InsertBenchmark) {
+  // four tuples fill a page, the throughput is measured while the table grows to each size, up to 4 GB on disk
+  const std::vector<size_t> table_sizes{1 << 10, 1 << 12, 1 << 14, 1 << 16, 1 << 18, 1 << 20};
+  Transaction txn(0);
+  TableHeap table(bpm_.get(), &lock_manager_, nullptr, &txn);
+  int32_t num_tuples = 0;
+  for (size_t table_size : table_sizes) {
+    int32_t step_tuples = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (num_tuples < static_cast<int32_t>(table_size) * 4) {
+      RID rid;
+      ASSERT_TRUE(table.InsertTuple(MakeTuple(num_tuples++, 900), &rid, &txn));
+      step_tuples++;
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO("up to %zu pages: %d inserts in %.1f ms, %.0f inserts/s", table_size, step_tuples, ms,
+             step_tuples * 1000.0 / ms);
+    // the write set keeps an entry per insert, which a commit would drop
+    txn.GetWriteSet()->clear();
+  }
+  EXPECT_EQ(table_sizes.back(), CountPages(&table));
+}
+
+}  // namespace bustub